@@ -19,7 +19,10 @@ def ping_plot(ping_plot_dir, logs_ns3_dir, from_id, to_id):
                 else:
                     out_file.write(str(val[1]) + "," + str(val[2]) + "\n")
     else:
-        raise ValueError("(%d, %d) is not in the results" % (from_id, to_id))
+        raise ValueError(
+            "(%d, %d) is not in the results (are its raw samples retained, "
+            "i.e., is it in pingmesh_raw_sample_pairs?)" % (from_id, to_id)
+        )
 
     # And perform the plotting
     local_shell = LocalShell()
@@ -7,6 +7,8 @@ def ping_plot(logs_ns3_dir):
 
     # Read in the rtt_results
     rtt_results = read_pingmesh_csv(logs_ns3_dir)
+    if len(rtt_results) == 0:
+        print("No pings in pingmesh.csv (set pingmesh_raw_sample_pairs to retain the raw samples)")
 
     # Print the top 10 with biggest delta between minimum and maximum RTT
     deltas = []
@@ -0,0 +1,159 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+#include "ns3/basic-simulation.h"
+#include "ns3/topology-ptop.h"
+#include "ns3/arbiter-ecmp-helper.h"
+#include "ns3/ipv4-arbiter-routing-helper.h"
+
+using namespace ns3;
+
+/**
+ * Reference of the 5-tuple hash before the port fast path: it deserializes the entire
+ * TCP/UDP header to read the ports and always uses murmur3.
+ */
+uint32_t reference_five_tuple_hash(Hasher& hasher, const Ipv4Header &header, Ptr<const Packet> p, int32_t node_id) {
+    char buff[17];
+    std::memcpy(&buff[0], &node_id, 4);
+    uint32_t src_ip = header.GetSource().Get();
+    std::memcpy(&buff[4], &src_ip, 4);
+    uint32_t dst_ip = header.GetDestination().Get();
+    std::memcpy(&buff[8], &dst_ip, 4);
+    uint8_t protocol = header.GetProtocol();
+    std::memcpy(&buff[12], &protocol, 1);
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
+    if (protocol == TCP_PROT_NUMBER) {
+        TcpHeader tcpHeader;
+        p->PeekHeader(tcpHeader);
+        src_port = tcpHeader.GetSourcePort();
+        dst_port = tcpHeader.GetDestinationPort();
+    } else if (protocol == UDP_PROT_NUMBER) {
+        UdpHeader udpHeader;
+        p->PeekHeader(udpHeader);
+        src_port = udpHeader.GetSourcePort();
+        dst_port = udpHeader.GetDestinationPort();
+    }
+    std::memcpy(&buff[13], &src_port, 2);
+    std::memcpy(&buff[15], &dst_port, 2);
+    hasher.clear();
+    return hasher.GetHash32(buff, 17);
+}
+
+void print_benchmark_result(std::string name, int64_t num_lookups, int64_t duration_ns, int64_t checksum) {
+    printf("  > %s\n", name.c_str());
+    printf("    >> Lookups performed.......... %" PRId64 " (checksum: %" PRId64 ")\n", num_lookups, checksum);
+    printf("    >> Total duration............. %.3f s\n", duration_ns / 1e9);
+    printf("    >> Per lookup................. %.1f ns\n", (double) duration_ns / (double) num_lookups);
+    printf("    >> Lookups per second......... %.2f million\n", num_lookups / (duration_ns / 1e3));
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve run directory
+    CommandLine cmd;
+    std::string run_dir = "";
+    int64_t num_lookups = 10000000;
+    cmd.Usage("Usage: ./waf --run=\"benchmark_ecmp_lookup --run_dir='<path/to/run/directory>' --num_lookups=<number>\"");
+    cmd.AddValue("run_dir",  "Run directory", run_dir);
+    cmd.AddValue("num_lookups",  "Number of next-hop lookups", num_lookups);
+    cmd.Parse(argc, argv);
+    if (run_dir.compare("") == 0) {
+        printf("Usage: ./waf --run=\"benchmark_ecmp_lookup --run_dir='<path/to/run/directory>' --num_lookups=<number>\"");
+        return 0;
+    }
+
+    // Load basic simulation environment
+    Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(run_dir);
+
+    // Read point-to-point topology, and install routing arbiters
+    Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+    ArbiterEcmpHelper::InstallArbiters(basicSimulation, topology);
+    NodeContainer nodes = topology->GetNodes();
+    int64_t n = topology->GetNumNodes();
+    Ptr<EcmpNextHopTable> next_hop_table = ArbiterEcmpHelper::CalculateGlobalState(topology, 1);
+
+    // Pre-generate the lookups such that only the decision itself is timed
+    std::cout << "ECMP LOOKUP BENCHMARK" << std::endl;
+    std::mt19937_64 rng(123456789);
+    const int64_t num_distinct = 4096;
+    std::vector<std::pair<int32_t, int32_t>> current_and_target;
+    std::vector<Ptr<Packet>> packets;
+    std::vector<Ipv4Header> headers;
+    for (int64_t i = 0; i < num_distinct; i++) {
+        int32_t current = rng() % n;
+        int32_t target = rng() % n;
+        while (n > 1 && target == current) {
+            target = rng() % n;
+        }
+        current_and_target.push_back(std::make_pair(current, target));
+        TcpHeader tcpHeader;
+        tcpHeader.SetSourcePort(1024 + rng() % 60000);
+        tcpHeader.SetDestinationPort(1025);
+        Ptr<Packet> p = Create<Packet>(1380);
+        p->AddHeader(tcpHeader);
+        packets.push_back(p);
+        Ipv4Header ipHeader;
+        ipHeader.SetSource(Ipv4Address((uint32_t) rng()));
+        ipHeader.SetDestination(Ipv4Address((uint32_t) rng()));
+        ipHeader.SetProtocol(TCP_PROT_NUMBER);
+        headers.push_back(ipHeader);
+    }
+
+    // Reference: deserialize the header and murmur3 hash, followed by the next-hop selection
+    Hasher hasher;
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < num_lookups; i++) {
+        int64_t k = i % num_distinct;
+        checksum += next_hop_table->SelectNextHop(
+                current_and_target[k].first,
+                current_and_target[k].second,
+                reference_five_tuple_hash(hasher, headers[k], packets[k], current_and_target[k].first)
+        );
+    }
+    int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    print_benchmark_result("Reference (header deserialization + murmur3)", num_lookups, duration_ns, checksum);
+
+    // Arbiter decisions for each of the hash functions, with and without flow hash tag
+    // (with the tag, the first lookup of each packet stamps it and all later lookups re-use it)
+    std::vector<std::pair<std::string, bool>> variants = {{"murmur3", false}, {"crc32c", false}, {"murmur3", true}};
+    for (std::pair<std::string, bool> variant : variants) {
+        std::string hash_function_name = variant.first + (variant.second ? ", flow hash tag" : "");
+        std::vector<Ptr<ArbiterEcmp>> arbiters;
+        for (int64_t i = 0; i < n; i++) {
+            arbiters.push_back(CreateObject<ArbiterEcmp>(nodes.Get(i), nodes, topology, next_hop_table, parse_ecmp_hash_function(variant.first), variant.second));
+        }
+        checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < num_lookups; i++) {
+            int64_t k = i % num_distinct;
+            checksum += arbiters[current_and_target[k].first]->TopologyPtopDecide(
+                    current_and_target[k].first,
+                    current_and_target[k].second,
+                    topology->GetAdjacencyList(current_and_target[k].first),
+                    packets[k],
+                    headers[k],
+                    false
+            );
+        }
+        duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        print_benchmark_result("ArbiterEcmp (port fast path + " + hash_function_name + ")", num_lookups, duration_ns, checksum);
+    }
+    std::cout << std::endl;
+    basicSimulation->RegisterTimestamp("ECMP lookup benchmark");
+
+    // Finalize the simulation
+    basicSimulation->Finalize();
+
+    return 0;
+
+}
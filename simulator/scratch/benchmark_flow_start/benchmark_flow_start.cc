@@ -0,0 +1,126 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+
+#include "ns3/basic-simulation.h"
+#include "ns3/flow-scheduler.h"
+#include "ns3/topology-ptop.h"
+#include "ns3/tcp-optimizer.h"
+#include "ns3/arbiter-ecmp-helper.h"
+#include "ns3/ipv4-arbiter-routing-helper.h"
+
+using namespace ns3;
+
+/**
+ * Writes a synthetic incast run into the run directory: a star of ToRs around a single
+ * switch, with all flows going from the other ToRs into ToR 0 at the very same time.
+ */
+void write_incast_run(std::string run_dir, int64_t num_tors, int64_t num_flows, int64_t start_time_ns, int64_t duration_ns) {
+    mkdir_if_not_exists(run_dir);
+
+    // Configuration
+    std::ofstream config_file(run_dir + "/config_ns3.properties");
+    config_file << "filename_topology=\"topology.properties\"" << std::endl;
+    config_file << "flow_schedule_filename=\"schedule.csv\"" << std::endl;
+    config_file << "simulation_end_time_ns=" << start_time_ns + duration_ns << std::endl;
+    config_file << "simulation_seed=123456789" << std::endl;
+    config_file << "link_data_rate_megabit_per_s=100.0" << std::endl;
+    config_file << "link_delay_ns=10000" << std::endl;
+    config_file << "link_max_queue_size_pkts=100" << std::endl;
+    config_file << "disable_qdisc_endpoint_tors_xor_servers=false" << std::endl;
+    config_file << "disable_qdisc_non_endpoint_switches=false" << std::endl;
+    config_file << "enable_flow_logging_to_file_for_flow_ids=set()" << std::endl;
+    config_file.close();
+
+    // Topology: ToRs 0 ... num_tors - 1 each connected to switch num_tors
+    std::ofstream topology_file(run_dir + "/topology.properties");
+    std::string tors;
+    std::string edges;
+    for (int64_t i = 0; i < num_tors; i++) {
+        tors += (i == 0 ? "" : ",") + std::to_string(i);
+        edges += (i == 0 ? "" : ",") + std::to_string(i) + "-" + std::to_string(num_tors);
+    }
+    topology_file << "num_nodes=" << num_tors + 1 << std::endl;
+    topology_file << "num_undirected_edges=" << num_tors << std::endl;
+    topology_file << "switches=set(" << tors << "," << num_tors << ")" << std::endl;
+    topology_file << "switches_which_are_tors=set(" << tors << ")" << std::endl;
+    topology_file << "servers=set()" << std::endl;
+    topology_file << "undirected_edges=set(" << edges << ")" << std::endl;
+    topology_file.close();
+
+    // Schedule: every flow starts at the same time, spread over the senders
+    std::ofstream schedule_file(run_dir + "/schedule.csv");
+    for (int64_t i = 0; i < num_flows; i++) {
+        schedule_file << i << "," << 1 + (i % (num_tors - 1)) << ",0,100000," << start_time_ns << ",," << std::endl;
+    }
+    schedule_file.close();
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve run directory
+    CommandLine cmd;
+    std::string run_dir = "";
+    int64_t num_flows = 100000;
+    int64_t num_tors = 16;
+    cmd.Usage("Usage: ./waf --run=\"benchmark_flow_start --run_dir='<path/to/run/directory>' --num_flows=<number> --num_tors=<number>\"");
+    cmd.AddValue("run_dir",  "Run directory (the incast run is generated into it)", run_dir);
+    cmd.AddValue("num_flows",  "Number of flows which start at the same time", num_flows);
+    cmd.AddValue("num_tors",  "Number of ToRs in the star (ToR 0 is the incast receiver)", num_tors);
+    cmd.Parse(argc, argv);
+    if (run_dir.compare("") == 0 || num_flows < 1 || num_tors < 2) {
+        printf("Usage: ./waf --run=\"benchmark_flow_start --run_dir='<path/to/run/directory>' --num_flows=<number> --num_tors=<number>\"");
+        return 0;
+    }
+
+    // Generate the synthetic incast run, the simulation only lasts for one microsecond
+    // after the flows start such that the flow start dominates the run time
+    const int64_t start_time_ns = 1000;
+    write_incast_run(run_dir, num_tors, num_flows, start_time_ns, 1000);
+
+    // Load basic simulation environment
+    Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(run_dir);
+
+    // Read point-to-point topology, and install routing arbiters
+    Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+    ArbiterEcmpHelper::InstallArbiters(basicSimulation, topology);
+
+    // Optimize TCP
+    TcpOptimizer::OptimizeUsingWorstCaseRtt(basicSimulation, topology->GetWorstCaseRttEstimateNs());
+
+    // Schedule flows
+    auto start = std::chrono::steady_clock::now();
+    FlowScheduler flowScheduler(basicSimulation, topology);
+    flowScheduler.Schedule();
+    int64_t setup_duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Run simulation
+    start = std::chrono::steady_clock::now();
+    basicSimulation->Run();
+    int64_t run_duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Write result
+    flowScheduler.WriteResults();
+
+    // Report
+    std::cout << "FLOW START BENCHMARK" << std::endl;
+    printf("  > Incast of %" PRId64 " flows from %" PRId64 " ToRs into ToR 0 at t=%" PRId64 " ns\n", num_flows, num_tors - 1, start_time_ns);
+    printf("    >> Scheduler setup............ %.3f s\n", setup_duration_ns / 1e9);
+    printf("    >> Simulation run............. %.3f s\n", run_duration_ns / 1e9);
+    printf("    >> Per flow started........... %.1f us\n", (double) run_duration_ns / (double) num_flows / 1e3);
+    printf("    >> Flows started per second... %.0f\n", num_flows / (run_duration_ns / 1e9));
+    std::cout << std::endl;
+    basicSimulation->RegisterTimestamp("Flow start benchmark");
+
+    // Finalize the simulation
+    basicSimulation->Finalize();
+
+    return 0;
+
+}
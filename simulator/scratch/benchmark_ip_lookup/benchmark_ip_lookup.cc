@@ -0,0 +1,129 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+#include "ns3/basic-simulation.h"
+#include "ns3/topology-ptop.h"
+#include "ns3/ip-to-node-id-index.h"
+#include "ns3/ipv4-arbiter-routing-helper.h"
+
+using namespace ns3;
+
+/**
+ * Reference of the IP to node id mapping before the shared index: every arbiter
+ * built its own ordered map of the IP addresses of all interfaces of all nodes.
+ */
+std::map<uint32_t, uint32_t> reference_ip_to_node_id_map(NodeContainer nodes) {
+    std::map<uint32_t, uint32_t> ip_to_node_id;
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+        for (uint32_t j = 1; j < nodes.Get(i)->GetObject<Ipv4>()->GetNInterfaces(); j++) {
+            ip_to_node_id.insert({nodes.Get(i)->GetObject<Ipv4>()->GetAddress(j,0).GetLocal().Get(), i});
+        }
+    }
+    return ip_to_node_id;
+}
+
+void print_construction_result(std::string name, int64_t num_built, int64_t duration_ns, int64_t num_entries) {
+    printf("  > %s\n", name.c_str());
+    printf("    >> Built...................... %" PRId64 " time(s) (entries in total: %" PRId64 ")\n", num_built, num_entries);
+    printf("    >> Total duration............. %.3f s\n", duration_ns / 1e9);
+}
+
+void print_lookup_result(std::string name, int64_t num_lookups, int64_t duration_ns, int64_t checksum) {
+    printf("  > %s\n", name.c_str());
+    printf("    >> Lookups performed.......... %" PRId64 " (checksum: %" PRId64 ")\n", num_lookups, checksum);
+    printf("    >> Total duration............. %.3f s\n", duration_ns / 1e9);
+    printf("    >> Per lookup................. %.1f ns\n", (double) duration_ns / (double) num_lookups);
+    printf("    >> Lookups per second......... %.2f million\n", num_lookups / (duration_ns / 1e3));
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve run directory
+    CommandLine cmd;
+    std::string run_dir = "";
+    int64_t num_lookups = 10000000;
+    cmd.Usage("Usage: ./waf --run=\"benchmark_ip_lookup --run_dir='<path/to/run/directory>' --num_lookups=<number>\"");
+    cmd.AddValue("run_dir",  "Run directory", run_dir);
+    cmd.AddValue("num_lookups",  "Number of IP to node id lookups", num_lookups);
+    cmd.Parse(argc, argv);
+    if (run_dir.compare("") == 0) {
+        printf("Usage: ./waf --run=\"benchmark_ip_lookup --run_dir='<path/to/run/directory>' --num_lookups=<number>\"");
+        return 0;
+    }
+
+    // Load basic simulation environment
+    Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(run_dir);
+
+    // Read point-to-point topology (which assigns the IP addresses)
+    Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+    NodeContainer nodes = topology->GetNodes();
+    int64_t n = topology->GetNumNodes();
+
+    // Construction: before, every one of the n arbiters built its own map of all IP addresses
+    std::cout << "IP TO NODE ID LOOKUP BENCHMARK" << std::endl;
+    std::vector<std::map<uint32_t, uint32_t>> maps;
+    int64_t num_entries = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < n; i++) {
+        maps.push_back(reference_ip_to_node_id_map(nodes));
+        num_entries += maps.back().size();
+    }
+    int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    print_construction_result("Reference (std::map per arbiter)", n, duration_ns, num_entries);
+    start = std::chrono::steady_clock::now();
+    Ptr<IpToNodeIdIndex> index = CreateObject<IpToNodeIdIndex>(nodes);
+    duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    print_construction_result("IpToNodeIdIndex (shared by all arbiters)", 1, duration_ns, index->GetNumEntries());
+
+    // Pre-generate the lookups (IP addresses of random interfaces) such that only the lookup itself is timed
+    std::mt19937_64 rng(123456789);
+    const int64_t num_distinct = 4096;
+    std::vector<std::pair<int64_t, uint32_t>> arbiter_and_ip;
+    for (int64_t i = 0; i < num_distinct; i++) {
+        int64_t node_id = rng() % n;
+        Ptr<Ipv4> ipv4 = nodes.Get(node_id)->GetObject<Ipv4>();
+        if (ipv4->GetNInterfaces() > 1) {
+            uint32_t j = 1 + rng() % (ipv4->GetNInterfaces() - 1);
+            arbiter_and_ip.push_back(std::make_pair(rng() % n, ipv4->GetAddress(j, 0).GetLocal().Get()));
+        }
+    }
+    if (arbiter_and_ip.empty()) {
+        throw std::runtime_error("The topology has no interfaces with an IP address to look up");
+    }
+
+    // Reference: ordered map lookup in the map of the arbiter
+    int64_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < num_lookups; i++) {
+        const std::pair<int64_t, uint32_t>& k = arbiter_and_ip[i % arbiter_and_ip.size()];
+        checksum += maps[k.first].find(k.second)->second;
+    }
+    duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    print_lookup_result("Reference (std::map per arbiter)", num_lookups, duration_ns, checksum);
+
+    // Shared open-addressing index
+    checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < num_lookups; i++) {
+        const std::pair<int64_t, uint32_t>& k = arbiter_and_ip[i % arbiter_and_ip.size()];
+        checksum += index->Lookup(k.second);
+    }
+    duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    print_lookup_result("IpToNodeIdIndex (shared by all arbiters)", num_lookups, duration_ns, checksum);
+    std::cout << std::endl;
+    basicSimulation->RegisterTimestamp("IP to node id lookup benchmark");
+
+    // Finalize the simulation
+    basicSimulation->Finalize();
+
+    return 0;
+
+}
@@ -0,0 +1,72 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+
+#include "ns3/basic-simulation.h"
+#include "ns3/ladder-queue-scheduler.h"
+#include "ns3/event-trace-scheduler.h"
+
+using namespace ns3;
+
+void print_benchmark_result(std::string name, int64_t num_operations, int64_t duration_ns, int64_t checksum) {
+    printf("  > %s\n", name.c_str());
+    printf("    >> Operations replayed........ %" PRId64 " (checksum: %" PRId64 ")\n", num_operations, checksum);
+    printf("    >> Total duration............. %.3f s\n", duration_ns / 1e9);
+    printf("    >> Per operation.............. %.1f ns\n", (double) duration_ns / (double) num_operations);
+    printf("    >> Operations per second...... %.2f million\n", num_operations / (duration_ns / 1e3));
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve the event trace
+    CommandLine cmd;
+    std::string trace_file = "";
+    std::string schedulers = "map,heap,calendar,ladder";
+    cmd.Usage("Usage: ./waf --run=\"benchmark_simulator_scheduler --trace_file='<path/to/event/trace>' --schedulers='map,heap,calendar,ladder'\"");
+    cmd.AddValue("trace_file",  "Event trace (written by a run with simulator_event_trace_filename set)", trace_file);
+    cmd.AddValue("schedulers",  "Comma-separated schedulers to replay it against", schedulers);
+    cmd.Parse(argc, argv);
+    if (trace_file.compare("") == 0) {
+        printf("Usage: ./waf --run=\"benchmark_simulator_scheduler --trace_file='<path/to/event/trace>' --schedulers='map,heap,calendar,ladder'\"");
+        return 0;
+    }
+
+    // Read the trace entirely beforehand such that only the scheduler operations are timed
+    std::cout << "EVENT TRACE" << std::endl;
+    std::vector<event_trace_record_t> trace = read_event_trace(trace_file);
+    int64_t num_operations[3] = {0, 0, 0};
+    for (event_trace_record_t& record : trace) {
+        num_operations[record.operation]++;
+    }
+    std::cout << "  > Trace file: " << trace_file << std::endl;
+    std::cout << "  > Inserts: " << num_operations[EVENT_TRACE_INSERT] << std::endl;
+    std::cout << "  > Removals of the next event: " << num_operations[EVENT_TRACE_REMOVE_NEXT] << std::endl;
+    std::cout << "  > Removals of a cancelled event: " << num_operations[EVENT_TRACE_REMOVE] << std::endl;
+    std::cout << std::endl;
+
+    // Replay it against each scheduler, which must all remove the events in the same order
+    std::cout << "SIMULATOR SCHEDULER BENCHMARK" << std::endl;
+    for (std::string name : split_string(schedulers, ",")) {
+        ObjectFactory factory;
+        factory.SetTypeId(parse_simulator_scheduler(name));
+        Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+        auto start = std::chrono::steady_clock::now();
+        int64_t checksum = replay_event_trace(trace, scheduler);
+        int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        print_benchmark_result(name + " (" + parse_simulator_scheduler(name) + ")", trace.size(), duration_ns, checksum);
+        Ptr<LadderQueueScheduler> ladder = DynamicCast<LadderQueueScheduler>(scheduler);
+        if (ladder != 0) {
+            printf("    >> Rungs spawned.............. %" PRId64 " (at most %" PRId64 " at the same time)\n", ladder->GetNumRungsSpawned(), ladder->GetMaxNumRungs());
+        }
+    }
+    std::cout << std::endl;
+
+    return 0;
+
+}
@@ -0,0 +1,86 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/buffered-log-sink.h"
+#include "ns3/flow-send-application.h"
+
+using namespace ns3;
+
+/**
+ * Convert a binary flow log (logs_dir/flow_logs_[aspect].bin) into the
+ * per-flow text files (logs_dir/flow_[id]_[aspect].txt) as written by the text format.
+ *
+ * @param logs_dir      Logs directory
+ * @param aspect        Logged aspect (progress, cwnd or rtt)
+ */
+void convert_flow_log(std::string logs_dir, std::string aspect) {
+    std::string filename_in = logs_dir + "/flow_logs_" + aspect + ".bin";
+    if (!file_exists(filename_in)) {
+        printf("  > %s: not present\n", filename_in.c_str());
+        return;
+    }
+    FILE* file_in = fopen(filename_in.c_str(), "rb");
+    if (file_in == nullptr) {
+        throw std::runtime_error(format_string("Could not open binary flow log: %s", filename_in.c_str()));
+    }
+
+    // Go over all the records, and write each to the text file of its flow
+    std::map<int64_t, Ptr<BufferedLogSink>> sinks;
+    std::vector<flow_log_record_t> records(65536);
+    int64_t num_records = 0;
+    size_t num_read;
+    while ((num_read = fread(records.data(), sizeof(flow_log_record_t), records.size(), file_in)) > 0) {
+        for (size_t i = 0; i < num_read; i++) {
+            flow_log_record_t& record = records[i];
+            std::map<int64_t, Ptr<BufferedLogSink>>::iterator it = sinks.find(record.flow_id);
+            if (it == sinks.end()) {
+                std::string filename_out = logs_dir + "/" + format_string("flow_%" PRId64 "_%s.txt", record.flow_id, aspect.c_str());
+                it = sinks.insert({record.flow_id, CreateObject<BufferedLogSink>(filename_out, 65536, false)}).first;
+            }
+            it->second->WriteCsvLine(record.flow_id, record.time_ns, record.value);
+        }
+        num_records += num_read;
+    }
+    bool truncated = !feof(file_in) || ftell(file_in) % sizeof(flow_log_record_t) != 0;
+    fclose(file_in);
+    for (std::pair<const int64_t, Ptr<BufferedLogSink>>& sink : sinks) {
+        sink.second->Close();
+    }
+    if (truncated) {
+        throw std::runtime_error(format_string("Binary flow log is not a whole number of records: %s", filename_in.c_str()));
+    }
+
+    printf("  > %s: %" PRId64 " records of %lu flows\n", filename_in.c_str(), num_records, sinks.size());
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve logs directory
+    CommandLine cmd;
+    std::string logs_dir = "";
+    cmd.Usage("Usage: ./waf --run=\"convert_flow_logs --logs_dir='<path/to/run/directory>/logs_ns3'\"");
+    cmd.AddValue("logs_dir",  "Logs directory", logs_dir);
+    cmd.Parse(argc, argv);
+    if (logs_dir.compare("") == 0) {
+        printf("Usage: ./waf --run=\"convert_flow_logs --logs_dir='<path/to/run/directory>/logs_ns3'\"");
+        return 0;
+    }
+
+    // Convert each of the logged aspects
+    std::cout << "CONVERT BINARY FLOW LOGS" << std::endl;
+    convert_flow_log(logs_dir, "progress");
+    convert_flow_log(logs_dir, "cwnd");
+    convert_flow_log(logs_dir, "rtt");
+    std::cout << std::endl;
+
+    return 0;
+
+}
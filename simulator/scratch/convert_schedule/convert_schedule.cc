@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/schedule-binary.h"
+
+using namespace ns3;
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve input and output file
+    CommandLine cmd;
+    std::string csv_filename = "";
+    std::string binary_filename = "";
+    cmd.Usage("Usage: ./waf --run=\"convert_schedule --csv='<path/to/schedule.csv>' --binary='<path/to/schedule.bin>'\"");
+    cmd.AddValue("csv",  "Schedule in CSV format (input)", csv_filename);
+    cmd.AddValue("binary",  "Schedule in binary format (output)", binary_filename);
+    cmd.Parse(argc, argv);
+    if (csv_filename.compare("") == 0 || binary_filename.compare("") == 0) {
+        printf("Usage: ./waf --run=\"convert_schedule --csv='<path/to/schedule.csv>' --binary='<path/to/schedule.bin>'\"");
+        return 0;
+    }
+
+    // Convert
+    std::cout << "CONVERT SCHEDULE TO BINARY" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    int64_t num_entries = convert_schedule_csv_to_binary(csv_filename, binary_filename);
+    double duration_s = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 1e9;
+    printf("  > %s -> %s\n", csv_filename.c_str(), binary_filename.c_str());
+    printf("    >> Entries converted.......... %" PRId64 "\n", num_entries);
+    printf("    >> Duration................... %.3f s\n", duration_s);
+    std::cout << std::endl;
+
+    return 0;
+
+}
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <thread>
+
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/ptop-utilization-tracker-helper.h"
+
+using namespace ns3;
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve logs directory and the utilization interval
+    CommandLine cmd;
+    std::string logs_dir = "";
+    int64_t interval_ns = 0;
+    bool write_uncompressed = true;
+    int64_t num_threads = 0;
+    cmd.Usage("Usage: ./waf --run=\"convert_utilization --logs_dir='<path/to/run/directory>/logs_ns3' --interval_ns=<interval (ns)>\"");
+    cmd.AddValue("logs_dir",  "Logs directory (with utilization_busy_periods.bin)", logs_dir);
+    cmd.AddValue("interval_ns",  "Utilization interval (ns)", interval_ns);
+    cmd.AddValue("write_uncompressed",  "Whether to write utilization.csv (every interval) as well", write_uncompressed);
+    cmd.AddValue("num_threads",  "Number of threads used to write the files (0 means: as many as there are hardware threads)", num_threads);
+    cmd.Parse(argc, argv);
+    if (logs_dir.compare("") == 0 || interval_ns < 1) {
+        printf("Usage: ./waf --run=\"convert_utilization --logs_dir='<path/to/run/directory>/logs_ns3' --interval_ns=<interval (ns)>\"");
+        return 0;
+    }
+    if (num_threads <= 0) {
+        num_threads = std::max((int64_t) 1, (int64_t) std::thread::hardware_concurrency());
+    }
+
+    // Read in the busy periods of every link
+    std::cout << "CONVERT UTILIZATION BUSY PERIODS" << std::endl;
+    std::string filename_in = logs_dir + "/utilization_busy_periods.bin";
+    std::vector<std::pair<int64_t, int64_t>> directed_edges;
+    std::vector<BusyPeriodLog> busy_period_logs;
+    PtopUtilizationTrackerHelper::ReadBusyPeriodLogs(filename_in, directed_edges, busy_period_logs);
+    int64_t num_busy_periods = 0;
+    for (const BusyPeriodLog& busy_period_log : busy_period_logs) {
+        num_busy_periods += busy_period_log.GetNumBusyPeriods();
+    }
+    printf("  > %s: %" PRId64 " busy periods of %lu links\n", filename_in.c_str(), num_busy_periods, busy_period_logs.size());
+
+    // Write the utilization files for the interval
+    int64_t num_compressed_intervals = PtopUtilizationTrackerHelper::WriteUtilizationFiles(
+            logs_dir, directed_edges, busy_period_logs, interval_ns, write_uncompressed, num_threads
+    );
+    printf("  > Interval of %" PRId64 " ns: %" PRId64 " compressed intervals\n", interval_ns, num_compressed_intervals);
+    std::cout << std::endl;
+
+    return 0;
+
+}
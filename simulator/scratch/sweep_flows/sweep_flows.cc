@@ -0,0 +1,286 @@
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include "ns3/basic-simulation.h"
+#include "ns3/flow-scheduler.h"
+#include "ns3/topology-ptop.h"
+#include "ns3/tcp-optimizer.h"
+#include "ns3/arbiter-ecmp-helper.h"
+#include "ns3/ipv4-arbiter-routing-helper.h"
+
+using namespace ns3;
+
+/**
+ * Read the parameter grid: each line is "key=value1|value2|..." (empty lines and
+ * lines starting with # are skipped). The runs are its Cartesian product, in which
+ * the values of the last key change fastest.
+ */
+std::vector<std::pair<std::string, std::vector<std::string>>> read_grid(const std::string& filename) {
+    if (!file_exists(filename)) {
+        throw std::runtime_error(format_string("Grid file %s does not exist.", filename.c_str()));
+    }
+    std::vector<std::pair<std::string, std::vector<std::string>>> grid;
+    std::ifstream grid_file(filename);
+    std::string line;
+    while (getline(grid_file, line)) {
+        line = trim(line);
+        if (line.empty() || starts_with(line, "#")) {
+            continue;
+        }
+        std::vector<std::string> equals_split = split_string(line, "=", 2);
+        std::vector<std::string> values;
+        for (std::string value : split_string(equals_split[1], "|")) {
+            values.push_back(trim(value));
+        }
+        grid.push_back(std::make_pair(trim(equals_split[0]), values));
+    }
+    return grid;
+}
+
+/**
+ * Create the run directory: all files of the base run directory are copied,
+ * and in the configuration the values of the grid point replace (or are added to) the base values.
+ */
+void create_run_dir(const std::string& base_run_dir, const std::string& run_dir, const std::vector<std::pair<std::string, std::string>>& grid_point) {
+    mkdir_if_not_exists(run_dir);
+    DIR* dir = opendir(base_run_dir.c_str());
+    if (dir == nullptr) {
+        throw std::runtime_error(format_string("Base run directory %s could not be opened.", base_run_dir.c_str()));
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        struct stat info;
+        if (name == "config_ns3.properties" || stat((base_run_dir + "/" + name).c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+            continue;
+        }
+        std::ifstream src(base_run_dir + "/" + name, std::ios::binary);
+        std::ofstream dst(run_dir + "/" + name, std::ios::binary);
+        dst << src.rdbuf();
+    }
+    closedir(dir);
+
+    // Configuration
+    std::set<std::string> replaced;
+    std::ifstream base_config(base_run_dir + "/config_ns3.properties");
+    std::ofstream config(run_dir + "/config_ns3.properties");
+    std::string line;
+    while (getline(base_config, line)) {
+        std::string key = trim(split_string(line + "=", "=")[0]);
+        bool is_grid_key = false;
+        for (const std::pair<std::string, std::string>& param : grid_point) {
+            if (param.first == key) {
+                config << param.first << "=" << param.second << std::endl;
+                replaced.insert(key);
+                is_grid_key = true;
+            }
+        }
+        if (!is_grid_key) {
+            config << line << std::endl;
+        }
+    }
+    for (const std::pair<std::string, std::string>& param : grid_point) {
+        if (replaced.find(param.first) == replaced.end()) {
+            config << param.first << "=" << param.second << std::endl;
+        }
+    }
+}
+
+/**
+ * Run one simulation in the run directory (the same as main_flows), optionally re-using the ECMP routing state.
+ */
+void run_flows(const std::string& run_dir, Ptr<EcmpNextHopTable> shared_ecmp_state) {
+    Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(run_dir);
+    Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+    ArbiterEcmpHelper::InstallArbiters(basicSimulation, topology, shared_ecmp_state);
+    TcpOptimizer::OptimizeUsingWorstCaseRtt(basicSimulation, topology->GetWorstCaseRttEstimateNs());
+    FlowScheduler flowScheduler(basicSimulation, topology);
+    flowScheduler.Schedule();
+    basicSimulation->Run();
+    flowScheduler.WriteResults();
+    basicSimulation->Finalize();
+}
+
+int main(int argc, char *argv[]) {
+
+    // No buffering of printf
+    setbuf(stdout, nullptr);
+
+    // Retrieve arguments
+    CommandLine cmd;
+    std::string base_run_dir = "";
+    std::string grid_file = "";
+    std::string sweep_dir = "";
+    int64_t num_parallel = 0;
+    std::string usage = "Usage: ./waf --run=\"sweep_flows --base_run_dir='<path/to/base/run/directory>' --grid_file='<path/to/grid.properties>' --sweep_dir='<path/to/sweep/directory>' --num_parallel=<number>\"";
+    cmd.Usage(usage);
+    cmd.AddValue("base_run_dir",  "Base run directory (configuration, topology and schedule files)", base_run_dir);
+    cmd.AddValue("grid_file",  "Parameter grid file (each line: key=value1|value2|...)", grid_file);
+    cmd.AddValue("sweep_dir",  "Directory in which a run directory is created for each grid point", sweep_dir);
+    cmd.AddValue("num_parallel",  "Number of runs performed at the same time (0 means: one per hardware thread)", num_parallel);
+    cmd.Parse(argc, argv);
+    if (base_run_dir.compare("") == 0 || grid_file.compare("") == 0 || sweep_dir.compare("") == 0) {
+        printf("%s\n", usage.c_str());
+        return 0;
+    }
+    if (num_parallel <= 0) {
+        num_parallel = std::max((int64_t) 1, (int64_t) std::thread::hardware_concurrency());
+    }
+
+    // Grid points
+    std::cout << "SWEEP" << std::endl;
+    std::vector<std::pair<std::string, std::vector<std::string>>> grid = read_grid(grid_file);
+    std::vector<std::vector<std::pair<std::string, std::string>>> grid_points = {{}};
+    bool grid_has_topology = false;
+    for (const std::pair<std::string, std::vector<std::string>>& param : grid) {
+        std::vector<std::vector<std::pair<std::string, std::string>>> expanded;
+        for (const std::vector<std::pair<std::string, std::string>>& point : grid_points) {
+            for (const std::string& value : param.second) {
+                std::vector<std::pair<std::string, std::string>> new_point = point;
+                new_point.push_back(std::make_pair(param.first, value));
+                expanded.push_back(new_point);
+            }
+        }
+        grid_points = expanded;
+        grid_has_topology = grid_has_topology || param.first == "filename_topology";
+    }
+    int64_t num_runs = grid_points.size();
+    std::cout << "  > Grid points (runs)..... " << num_runs << std::endl;
+    std::cout << "  > Runs at the same time.. " << num_parallel << std::endl;
+
+    // Run directories
+    mkdir_if_not_exists(sweep_dir);
+    std::vector<std::string> run_dirs;
+    for (int64_t i = 0; i < num_runs; i++) {
+        run_dirs.push_back(sweep_dir + "/" + format_string("run_%" PRId64, i));
+        create_run_dir(base_run_dir, run_dirs[i], grid_points[i]);
+        mkdir_if_not_exists(run_dirs[i] + "/logs_ns3");
+    }
+
+    // The topology is the same for all runs, so its ECMP routing state is calculated once
+    // (the forked runs share it copy-on-write)
+    Ptr<EcmpNextHopTable> shared_ecmp_state = nullptr;
+    if (!grid_has_topology) {
+        std::map<std::string, std::string> base_config = read_config(base_run_dir + "/config_ns3.properties");
+        std::string topology_filename = base_run_dir + "/" + get_param_or_fail("filename_topology", base_config);
+
+        // Same routing keys as ArbiterEcmpHelper (the cache directory is relative to the base run directory)
+        int64_t num_threads = parse_positive_int64(get_param_or_default("ecmp_routing_num_threads", "0", base_config));
+        if (num_threads == 0) {
+            num_threads = std::max((int64_t) 1, (int64_t) std::thread::hardware_concurrency());
+        }
+        std::string cache_dir = get_param_or_default("ecmp_routing_cache_dir", "", base_config);
+        if (!cache_dir.empty() && !starts_with(cache_dir, "/")) {
+            cache_dir = base_run_dir + "/" + cache_dir;
+        }
+
+        // The graph is read and checked by TopologyPtop, without creating any nodes before the runs are forked
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::set<int64_t>> adjacency_lists = TopologyPtop::ReadTopologyGraph(topology_filename).adjacency_list;
+        if (cache_dir.empty()) {
+            shared_ecmp_state = CreateObject<EcmpNextHopTable>(adjacency_lists, num_threads);
+        } else {
+            shared_ecmp_state = ArbiterEcmpHelper::CalculateOrLoadGlobalState(adjacency_lists, num_threads, topology_filename, cache_dir);
+        }
+        double duration_s = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1e6;
+        std::cout << "  > Shared ECMP routing state ready in " << duration_s << " s (" << shared_ecmp_state->GetMemoryReport() << ")" << std::endl;
+    } else {
+        std::cout << "  > Topology is part of the grid: each run calculates its own ECMP routing state" << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Fork the runs, at most num_parallel at the same time
+    std::cout << "PERFORM RUNS" << std::endl;
+    auto sweep_start = std::chrono::steady_clock::now();
+    std::map<pid_t, int64_t> running;
+    std::vector<int> exit_codes(num_runs, -1);
+    std::vector<double> durations_s(num_runs, 0.0);
+    std::vector<std::chrono::steady_clock::time_point> starts(num_runs);
+    int64_t next_run = 0;
+    while (next_run < num_runs || !running.empty()) {
+        if (next_run < num_runs && (int64_t) running.size() < num_parallel) {
+            starts[next_run] = std::chrono::steady_clock::now();
+            pid_t pid = fork();
+            if (pid < 0) {
+                throw std::runtime_error("Could not fork a run");
+            } else if (pid == 0) {
+                int exit_code = 0;
+                if (freopen((run_dirs[next_run] + "/logs_ns3/console.txt").c_str(), "w", stdout) == nullptr) {
+                    _exit(2);
+                }
+                dup2(fileno(stdout), fileno(stderr));
+                try {
+                    run_flows(run_dirs[next_run], shared_ecmp_state);
+                } catch (std::exception& e) {
+                    std::cout << "Run failed: " << e.what() << std::endl;
+                    exit_code = 1;
+                }
+                std::cout.flush();
+                fflush(stdout);
+                _exit(exit_code);
+            }
+            running[pid] = next_run;
+            next_run++;
+        } else {
+            int status;
+            pid_t pid = wait(&status);
+            if (pid < 0) {
+                throw std::runtime_error("Waiting for a run failed");
+            }
+            int64_t run_idx = running.at(pid);
+            running.erase(pid);
+            exit_codes[run_idx] = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            durations_s[run_idx] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - starts[run_idx]).count() / 1e6;
+            std::cout << "  > Finished " << run_dirs[run_idx] << " (exit code: " << exit_codes[run_idx] << ", " << durations_s[run_idx] << " s)" << std::endl;
+        }
+    }
+    double sweep_duration_s = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sweep_start).count() / 1e6;
+    std::cout << std::endl;
+
+    // Merged summary
+    std::cout << "SWEEP SUMMARY" << std::endl;
+    std::ofstream summary(sweep_dir + "/sweep_summary.csv");
+    summary << "run_idx,run_dir,exit_code,duration_s,num_flows,num_finished_flows,mean_fct_finished_ns,parameters" << std::endl;
+    int64_t num_failed = 0;
+    for (int64_t i = 0; i < num_runs; i++) {
+        int64_t num_flows = 0;
+        int64_t num_finished_flows = 0;
+        double sum_fct_ns = 0;
+        if (exit_codes[i] == 0 && file_exists(run_dirs[i] + "/logs_ns3/flows.csv")) {
+            for (std::string line : read_file_direct(run_dirs[i] + "/logs_ns3/flows.csv")) {
+                std::vector<std::string> spl = split_string(line, ",");
+                num_flows++;
+                if (spl[8] == "YES") {
+                    num_finished_flows++;
+                    sum_fct_ns += parse_positive_int64(spl[6]);
+                }
+            }
+        } else {
+            num_failed++;
+        }
+        std::string parameters;
+        for (const std::pair<std::string, std::string>& param : grid_points[i]) {
+            parameters += (parameters.empty() ? "" : ";") + param.first + "=" + param.second;
+        }
+        summary << i << "," << run_dirs[i] << "," << exit_codes[i] << "," << durations_s[i] << ","
+                << num_flows << "," << num_finished_flows << ","
+                << (num_finished_flows > 0 ? sum_fct_ns / num_finished_flows : 0) << ",\"" << parameters << "\"" << std::endl;
+    }
+    summary.close();
+    std::cout << "  > Runs performed......... " << num_runs << " (of which failed: " << num_failed << ")" << std::endl;
+    std::cout << "  > Total duration......... " << sweep_duration_s << " s" << std::endl;
+    std::cout << "  > Throughput............. " << (sweep_duration_s > 0 ? num_runs / (sweep_duration_s / 3600.0) : 0) << " runs/hour" << std::endl;
+    std::cout << "  > Summary written to: " << sweep_dir << "/sweep_summary.csv" << std::endl;
+    std::cout << std::endl;
+
+    return num_failed == 0 ? 0 : 1;
+
+}
@@ -26,6 +26,7 @@ int main(int argc, char *argv[]) {
     config_file.open (example_dir + "/config_ns3.properties");
     config_file << "filename_topology=\"topology.properties\"" << std::endl;
     config_file << "pingmesh_interval_ns=100000000" << std::endl;
+    config_file << "pingmesh_raw_sample_pairs=all" << std::endl;
     config_file << "simulation_end_time_ns=1000000000" << std::endl;
     config_file << "simulation_seed=123456789" << std::endl;
     config_file << "link_data_rate_megabit_per_s=100" << std::endl;
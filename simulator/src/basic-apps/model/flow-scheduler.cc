@@ -14,58 +14,171 @@ FlowScheduler::FlowScheduler(Ptr<BasicSimulation> basicSimulation,
       parse_set_positive_int64(m_basicSimulation->GetConfigParamOrDefault(
           "enable_flow_logging_to_file_for_flow_ids", "set()"));
 
-  // Read schedule
-  m_schedule = read_schedule(
+  // Flow logs are either per-flow text files, or shared binary files (one per logged aspect)
+  std::string flow_logging_format =
+      m_basicSimulation->GetConfigParamOrDefault("flow_logging_format", "text");
+  if (flow_logging_format == "text") {
+    m_flowLoggingBinary = false;
+  } else if (flow_logging_format == "binary") {
+    m_flowLoggingBinary = true;
+  } else {
+    throw std::invalid_argument(format_string(
+        "Invalid flow logging format: %s (valid: text, binary)",
+        flow_logging_format.c_str()));
+  }
+  if (m_flowLoggingBinary && !m_enableFlowLoggingToFileForFlowIds.empty()) {
+    m_progressLogSink = m_basicSimulation->CreateLogSink("flow_logs_progress.bin", 4194304, true);
+    m_cwndLogSink = m_basicSimulation->CreateLogSink("flow_logs_cwnd.bin", 4194304, true);
+    m_rttLogSink = m_basicSimulation->CreateLogSink("flow_logs_rtt.bin", 4194304, true);
+  }
+
+  // Open schedule, which is then read a window of upcoming flows at a time
+  int64_t schedule_window_size = parse_positive_int64(
+      m_basicSimulation->GetConfigParamOrDefault("flow_schedule_window_size",
+                                                 "4096"));
+  m_schedule = CreateObject<ScheduleStream>(
       m_basicSimulation->GetRunDir() + "/" +
           m_basicSimulation->GetConfigParamOrFail("flow_schedule_filename"),
-      m_topology, m_simulation_end_time_ns);
+      m_topology, m_simulation_end_time_ns, schedule_window_size);
   m_basicSimulation->RegisterTimestamp("Read schedule");
 
   printf("FLOW SCHEDULE\n");
-  printf("  > Read schedule (total flow start events: %lu)\n",
-         m_schedule.size());
+  printf("  > Read schedule (total flow start events: %" PRId64 ")\n",
+         m_schedule->GetNumEntries());
+  printf("  > Schedule is streamed (%s, window size: %" PRId64 ")\n",
+         m_schedule->IsBinary() ? "binary" : "csv",
+         m_schedule->GetWindowSize());
+  // Destination address of each endpoint, and a pool of idle sender applications for each node
+  m_destAddresses.resize(m_nodes.GetN());
+  for (int64_t endpoint : m_topology->GetEndpoints()) {
+    InetSocketAddress destAddress(m_nodes.Get(endpoint)
+                                      ->GetObject<Ipv4>()
+                                      ->GetAddress(1, 0)
+                                      .GetLocal(),
+                                  1025);
+
+    // All flows are set to the highest priority Interactive(6)->0 from pfifo-fast-queue-disc-test-suite.cc
+    destAddress.SetTos(0x10);
+    m_destAddresses[endpoint] = destAddress;
+  }
+  m_idleSendApps.resize(m_nodes.GetN());
+
   remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/flows.csv");
   remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/flows.txt");
   printf("  > Removed previous flow log files if present\n");
 
+  // Flow results are written through a buffer as soon as a flow has finished,
+  // and the ones of the flows which are still ongoing at Finalize
+  m_flowsLogFlushIntervalNs = parse_positive_int64(
+      m_basicSimulation->GetConfigParamOrDefault("flows_log_flush_interval_ns",
+                                                 "0"));
+  m_flowsCsvLogSink = m_basicSimulation->CreateLogSink("flows.csv", 1048576, true);
+  m_flowsTxtLogSink = m_basicSimulation->CreateLogSink("flows.txt", 1048576, true);
+  std::string header = format_string(
+      "%-12s%-10s%-10s%-16s%-18s%-18s%-16s%-16s%-13s%-16s%-14s%s\n",
+      "Flow ID", "Source", "Target", "Size", "Start time (ns)", "End time (ns)",
+      "Duration", "Sent", "Progress", "Avg. rate", "Finished?", "Metadata");
+  m_flowsTxtLogSink->Write(header.data(), header.size());
+  m_finalizeCallbackId = m_basicSimulation->RegisterFinalizeCallback(
+      MakeCallback(&FlowScheduler::WriteOngoingResults, this));
+  if (m_flowsLogFlushIntervalNs > 0) {
+    printf("  > Flow log files are flushed every %" PRId64 " ns\n",
+           m_flowsLogFlushIntervalNs);
+  }
+
   std::cout << std::endl;
 }
 
-void FlowScheduler::StartNextFlow(int i) {
-  // Fetch the flow to start
-  schedule_entry_t& entry = m_schedule[i];
+FlowScheduler::~FlowScheduler() {
+  // The simulation can outlive the scheduler, which must then not be called at Finalize
+  m_basicSimulation->UnregisterFinalizeCallback(m_finalizeCallbackId);
+
+  // Applications which were never released still have to be disposed
+  for (std::pair<const int64_t, active_flow_t>& flow : m_active_flows) {
+    flow.second.app->Dispose();
+  }
+  m_active_flows.clear();
+  for (std::vector<Ptr<FlowSendApplication>>& idle : m_idleSendApps) {
+    for (Ptr<FlowSendApplication> app : idle) {
+      app->Dispose();
+    }
+    idle.clear();
+  }
+}
+
+Ptr<FlowSendApplication> FlowScheduler::AcquireSendApplication(int64_t node_id) {
+  std::vector<Ptr<FlowSendApplication>>& idle = m_idleSendApps[node_id];
+  if (!idle.empty()) {
+    Ptr<FlowSendApplication> app = idle.back();
+    idle.pop_back();
+    m_num_send_apps_reused++;
+    return app;
+  }
+
+  // The node does not keep it in its application list, it is owned by the pool instead
+  Ptr<FlowSendApplication> app = CreateObject<FlowSendApplication>();
+  app->SetAttribute("BaseLogsDir", StringValue(m_basicSimulation->GetLogsDir()));
+  app->SetNode(m_nodes.Get(node_id));
+  app->SetFinishedCallback(MakeCallback(&FlowScheduler::FlowFinished, this));
+  m_num_send_apps_created++;
+  return app;
+}
+
+void FlowScheduler::StartNextFlows() {
+  // All flows with the same start time are started by this one event
   int64_t now_ns = Simulator::Now().GetNanoSeconds();
-  if (now_ns != entry.start_time_ns) {
+  if (m_schedule->PeekNext().start_time_ns != now_ns) {
     throw std::runtime_error("Scheduling start of a flow went horribly wrong");
   }
+  while (m_schedule->HasNext() && m_schedule->PeekNext().start_time_ns == now_ns) {
+    StartFlow(m_schedule->Next());
+  }
+  m_num_flow_start_events++;
 
-  InetSocketAddress destAddress(m_nodes.Get(entry.to_node_id)
-                                    ->GetObject<Ipv4>()
-                                    ->GetAddress(1, 0)
-                                    .GetLocal(),
-                                1025);
-
-  // All flows are set to the highest priority Interactive(6)->0 from pfifo-fast-queue-disc-test-suite.cc
-  destAddress.SetTos(0x10);  
+  // If there is a next flow to start, schedule the start of it and the ones at the same time
+  if (m_schedule->HasNext()) {
+    int64_t next_flow_ns = m_schedule->PeekNext().start_time_ns;
+    Simulator::Schedule(NanoSeconds(next_flow_ns - now_ns),
+                        &FlowScheduler::StartNextFlows, this);
+  }
+}
 
-  // Helper to install the source application
-  FlowSendHelper source(
-      "ns3::TcpSocketFactory", destAddress, entry.size_byte, entry.flow_id,
+void FlowScheduler::StartFlow(schedule_entry_t entry) {
+  // Take an idle sender application of the node, and start the flow on it right now
+  bool enable_flow_logging =
       m_enableFlowLoggingToFileForFlowIds.find(entry.flow_id) !=
-          m_enableFlowLoggingToFileForFlowIds.end(),
-      m_basicSimulation->GetLogsDir());
+      m_enableFlowLoggingToFileForFlowIds.end();
+  Ptr<FlowSendApplication> app = AcquireSendApplication(entry.from_node_id);
+  if (m_flowLoggingBinary && enable_flow_logging) {
+    app->SetFlowLogSinks(m_progressLogSink, m_cwndLogSink, m_rttLogSink, true);
+  }
+  app->StartFlow(m_destAddresses[entry.to_node_id], entry.size_byte,
+                 entry.flow_id, enable_flow_logging);
+  int64_t flow_id = entry.flow_id;
+  m_active_flows[flow_id] = {std::move(entry), app};
+  m_num_flows_started++;
+  m_max_num_active_flows =
+      std::max(m_max_num_active_flows, (int64_t)m_active_flows.size());
+}
 
-  // Install it on the node and start it right now
-  ApplicationContainer app = source.Install(m_nodes.Get(entry.from_node_id));
-  app.Start(NanoSeconds(0));
-  m_apps.push_back(app);
+void FlowScheduler::FlowFinished(int64_t flow_id) {
+  // Called from within the socket callback of the application, as such
+  // it can only be retired once that has returned
+  Simulator::ScheduleNow(&FlowScheduler::RetireFlow, this, flow_id);
+}
 
-  // If there is a next flow to start, schedule its start
-  if (i + 1 != (int)m_schedule.size()) {
-    int64_t next_flow_ns = m_schedule[i + 1].start_time_ns;
-    Simulator::Schedule(NanoSeconds(next_flow_ns - now_ns),
-                        &FlowScheduler::StartNextFlow, this, i + 1);
+void FlowScheduler::RetireFlow(int64_t flow_id) {
+  std::unordered_map<int64_t, active_flow_t>::iterator it = m_active_flows.find(flow_id);
+  if (it == m_active_flows.end()) {
+    throw std::runtime_error(format_string(
+        "Flow %" PRId64 " finished but is not active", flow_id));
   }
+
+  // Write its result, after which its application is idle again
+  WriteResultRow(it->second.entry, it->second.app);
+  m_idleSendApps[it->second.entry.from_node_id].push_back(it->second.app);
+  m_active_flows.erase(it);
+  m_num_flows_retired++;
 }
 
 void FlowScheduler::Schedule() {
@@ -81,98 +194,135 @@ void FlowScheduler::Schedule() {
   }
   m_basicSimulation->RegisterTimestamp("Setup traffic sinks");
 
+  // Flush the flow log files regularly, such that the results can be followed while it runs
+  if (m_flowsLogFlushIntervalNs > 0) {
+    Simulator::Schedule(NanoSeconds(m_flowsLogFlushIntervalNs),
+                        &FlowScheduler::FlushResults, this);
+  }
+
   // Setup all source applications
   std::cout << "  > Setting up traffic flow starter" << std::endl;
-  if (m_schedule.size() > 0) {
-    Simulator::Schedule(NanoSeconds(m_schedule[0].start_time_ns),
-                        &FlowScheduler::StartNextFlow, this, 0);
+  if (m_schedule->HasNext()) {
+    Simulator::Schedule(NanoSeconds(m_schedule->PeekNext().start_time_ns),
+                        &FlowScheduler::StartNextFlows, this);
   }
 
   std::cout << std::endl;
   m_basicSimulation->RegisterTimestamp("Setup traffic flow starter");
 }
 
-void FlowScheduler::WriteResults() {
-  std::cout << "STORE FLOW RESULTS" << std::endl;
+void FlowScheduler::WriteResultRow(const schedule_entry_t& entry,
+                                   Ptr<FlowSendApplication> flowSendApp) {
+  // Retrieve statistics
+  bool is_completed = flowSendApp->IsCompleted();
+  bool is_conn_failed = flowSendApp->IsConnFailed();
+  bool is_closed_err = flowSendApp->IsClosedByError();
+  bool is_closed_normal = flowSendApp->IsClosedNormally();
+  int64_t sent_byte = flowSendApp->GetAckedBytes();
+  int64_t fct_ns;
+  if (is_completed) {
+    fct_ns = flowSendApp->GetCompletionTimeNs() - entry.start_time_ns;
+  } else {
+    fct_ns = m_simulation_end_time_ns - entry.start_time_ns;
+  }
+  std::string finished_state;
+  if (is_completed) {
+    finished_state = "YES";
+  } else if (is_conn_failed) {
+    finished_state = "NO_CONN_FAIL";
+  } else if (is_closed_normal) {
+    finished_state = "NO_BAD_CLOSE";
+  } else if (is_closed_err) {
+    finished_state = "NO_ERR_CLOSE";
+  } else {
+    finished_state = "NO_ONGOING";
+  }
 
-  FILE* file_csv =
-      fopen((m_basicSimulation->GetLogsDir() + "/flows.csv").c_str(), "w+");
-  FILE* file_txt =
-      fopen((m_basicSimulation->GetLogsDir() + "/flows.txt").c_str(), "w+");
-  fprintf(
-      file_txt, "%-12s%-10s%-10s%-16s%-18s%-18s%-16s%-16s%-13s%-16s%-14s%s\n",
-      "Flow ID", "Source", "Target", "Size", "Start time (ns)", "End time (ns)",
-      "Duration", "Sent", "Progress", "Avg. rate", "Finished?", "Metadata");
-  std::vector<ApplicationContainer>::iterator it = m_apps.begin();
-  for (schedule_entry_t& entry : m_schedule) {
-    // Retrieve statistics
-    ApplicationContainer app = *it;
-    Ptr<FlowSendApplication> flowSendApp =
-        ((it->Get(0))->GetObject<FlowSendApplication>());
-    bool is_completed = flowSendApp->IsCompleted();
-    bool is_conn_failed = flowSendApp->IsConnFailed();
-    bool is_closed_err = flowSendApp->IsClosedByError();
-    bool is_closed_normal = flowSendApp->IsClosedNormally();
-    int64_t sent_byte = flowSendApp->GetAckedBytes();
-    int64_t fct_ns;
-    if (is_completed) {
-      fct_ns = flowSendApp->GetCompletionTimeNs() - entry.start_time_ns;
-    } else {
-      fct_ns = m_simulation_end_time_ns - entry.start_time_ns;
-    }
-    std::string finished_state;
-    if (is_completed) {
-      finished_state = "YES";
-    } else if (is_conn_failed) {
-      finished_state = "NO_CONN_FAIL";
-    } else if (is_closed_normal) {
-      finished_state = "NO_BAD_CLOSE";
-    } else if (is_closed_err) {
-      finished_state = "NO_ERR_CLOSE";
-    } else {
-      finished_state = "NO_ONGOING";
+  // Write plain to the csv
+  std::string line_csv = format_string(
+      "%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64
+      ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%s,%s\n",
+      entry.flow_id, entry.from_node_id, entry.to_node_id,
+      entry.size_byte, entry.start_time_ns, entry.start_time_ns + fct_ns,
+      fct_ns, sent_byte, finished_state.c_str(), entry.metadata.c_str());
+  m_flowsCsvLogSink->Write(line_csv.data(), line_csv.size());
+
+  // Write nicely formatted to the text
+  char str_size_megabit[100];
+  sprintf(str_size_megabit, "%.2f Mbit", byte_to_megabit(entry.size_byte));
+  char str_duration_ms[100];
+  sprintf(str_duration_ms, "%.2f ms", nanosec_to_millisec(fct_ns));
+  char str_sent_megabit[100];
+  sprintf(str_sent_megabit, "%.2f Mbit", byte_to_megabit(sent_byte));
+  char str_progress_perc[100];
+  sprintf(str_progress_perc, "%.1f%%",
+          ((double)sent_byte) / ((double)entry.size_byte) * 100.0);
+  char str_avg_rate_megabit_per_s[100];
+  sprintf(str_avg_rate_megabit_per_s, "%.1f Mbit/s",
+          byte_to_megabit(sent_byte) / nanosec_to_sec(fct_ns));
+  std::string line_txt = format_string(
+      "%-12" PRId64 "%-10" PRId64 "%-10" PRId64 "%-16s%-18" PRId64
+      "%-18" PRId64 "%-16s%-16s%-13s%-16s%-14s%s\n",
+      entry.flow_id, entry.from_node_id, entry.to_node_id,
+      str_size_megabit, entry.start_time_ns, entry.start_time_ns + fct_ns,
+      str_duration_ms, str_sent_megabit, str_progress_perc,
+      str_avg_rate_megabit_per_s, finished_state.c_str(),
+      entry.metadata.c_str());
+  m_flowsTxtLogSink->Write(line_txt.data(), line_txt.size());
+}
+
+void FlowScheduler::FlushResults() {
+  m_flowsCsvLogSink->Flush();
+  m_flowsTxtLogSink->Flush();
+  if (Simulator::Now().GetNanoSeconds() + m_flowsLogFlushIntervalNs <
+      m_simulation_end_time_ns) {
+    Simulator::Schedule(NanoSeconds(m_flowsLogFlushIntervalNs),
+                        &FlowScheduler::FlushResults, this);
+  }
+}
+
+void FlowScheduler::WriteOngoingResults() {
+  std::cout << "STORE ONGOING FLOW RESULTS" << std::endl;
+
+  // The ones which are still active are written in flow ID order
+  std::vector<int64_t> ongoing_flow_ids;
+  for (std::pair<const int64_t, active_flow_t>& flow : m_active_flows) {
+    ongoing_flow_ids.push_back(flow.first);
+  }
+  std::sort(ongoing_flow_ids.begin(), ongoing_flow_ids.end());
+  for (int64_t flow_id : ongoing_flow_ids) {
+    active_flow_t& flow = m_active_flows.at(flow_id);
+    WriteResultRow(flow.entry, flow.app);
+    flow.app->Dispose();
+  }
+  std::cout << "  > Flows still ongoing at the end: " << ongoing_flow_ids.size() << std::endl;
+  std::cout << std::endl;
+  m_active_flows.clear();
+
+  // All the sender applications are released
+  for (std::vector<Ptr<FlowSendApplication>>& idle : m_idleSendApps) {
+    for (Ptr<FlowSendApplication> app : idle) {
+      app->Dispose();
     }
+    idle.clear();
+  }
+
+  m_basicSimulation->RegisterTimestamp("Write ongoing flow results");
+}
+
+void FlowScheduler::WriteResults() {
+  std::cout << "STORE FLOW RESULTS" << std::endl;
 
-    // Write plain to the csv
-    fprintf(file_csv,
-            "%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64
-            ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%s,%s\n",
-            entry.flow_id, entry.from_node_id, entry.to_node_id,
-            entry.size_byte, entry.start_time_ns, entry.start_time_ns + fct_ns,
-            fct_ns, sent_byte, finished_state.c_str(), entry.metadata.c_str());
-
-    // Write nicely formatted to the text
-    char str_size_megabit[100];
-    sprintf(str_size_megabit, "%.2f Mbit", byte_to_megabit(entry.size_byte));
-    char str_duration_ms[100];
-    sprintf(str_duration_ms, "%.2f ms", nanosec_to_millisec(fct_ns));
-    char str_sent_megabit[100];
-    sprintf(str_sent_megabit, "%.2f Mbit", byte_to_megabit(sent_byte));
-    char str_progress_perc[100];
-    sprintf(str_progress_perc, "%.1f%%",
-            ((double)sent_byte) / ((double)entry.size_byte) * 100.0);
-    char str_avg_rate_megabit_per_s[100];
-    sprintf(str_avg_rate_megabit_per_s, "%.1f Mbit/s",
-            byte_to_megabit(sent_byte) / nanosec_to_sec(fct_ns));
-    fprintf(file_txt,
-            "%-12" PRId64 "%-10" PRId64 "%-10" PRId64 "%-16s%-18" PRId64
-            "%-18" PRId64 "%-16s%-16s%-13s%-16s%-14s%s\n",
-            entry.flow_id, entry.from_node_id, entry.to_node_id,
-            str_size_megabit, entry.start_time_ns, entry.start_time_ns + fct_ns,
-            str_duration_ms, str_sent_megabit, str_progress_perc,
-            str_avg_rate_megabit_per_s, finished_state.c_str(),
-            entry.metadata.c_str());
-
-    // Move on iterator
-    it++;
-  }
-  fclose(file_csv);
-  fclose(file_txt);
-
-  std::cout << "  > Flow log files have been written" << std::endl;
+  // Finished flows have already been written when they were retired,
+  // the ones which are still active are written at Finalize
+  std::cout << "  > Flows written when finished: " << m_num_flows_retired << std::endl;
+  std::cout << "  > Flows still active (written at finalize): " << m_active_flows.size() << std::endl;
+  std::cout << "  > Flows started: " << m_num_flows_started << " (by " << m_num_flow_start_events << " start events)" << std::endl;
+  std::cout << "  > Peak number of concurrently active flows: " << m_max_num_active_flows << std::endl;
+  std::cout << "  > Sender applications created: " << m_num_send_apps_created << " (re-used for another flow: " << m_num_send_apps_reused << " times)" << std::endl;
   std::cout << std::endl;
 
-  m_basicSimulation->RegisterTimestamp("Write flow log files");
+  m_basicSimulation->RegisterTimestamp("Summarize flow results");
 }
 
 }  // namespace ns3
@@ -3,6 +3,7 @@
 #define FLOW_SCHEDULER_H
 
 #include <map>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -28,6 +29,7 @@
 #include "ns3/topology.h"
 
 #include "ns3/schedule-reader.h"
+#include "ns3/schedule-stream.h"
 #include "ns3/flow-send-helper.h"
 #include "ns3/flow-send-application.h"
 #include "ns3/flow-sink-helper.h"
@@ -40,18 +42,47 @@ class FlowScheduler
 
 public:
     FlowScheduler(Ptr<BasicSimulation> basicSimulation, Ptr<Topology> topology);
+    ~FlowScheduler();
     void Schedule();
     void WriteResults();
 
 protected:
-    void StartNextFlow(int i);
+    struct active_flow_t {
+        schedule_entry_t entry;
+        Ptr<FlowSendApplication> app;
+    };
+
+    void StartNextFlows();
+    void StartFlow(schedule_entry_t entry);
+    void FlowFinished(int64_t flow_id);
+    void RetireFlow(int64_t flow_id);
+    void WriteResultRow(const schedule_entry_t& entry, Ptr<FlowSendApplication> flowSendApp);
+    void WriteOngoingResults();
+    void FlushResults();
+    Ptr<FlowSendApplication> AcquireSendApplication(int64_t node_id);
     Ptr<BasicSimulation> m_basicSimulation;
     int64_t m_simulation_end_time_ns;
     Ptr<Topology> m_topology = nullptr;
-    std::vector<schedule_entry_t> m_schedule;
+    Ptr<ScheduleStream> m_schedule;
     NodeContainer m_nodes;
-    std::vector<ApplicationContainer> m_apps;
+    std::unordered_map<int64_t, active_flow_t> m_active_flows; // Started but not yet retired, by flow ID
+    std::vector<std::vector<Ptr<FlowSendApplication>>> m_idleSendApps; // Pool of idle sender applications per node
+    std::vector<Address> m_destAddresses; // Destination address of each endpoint node (by node ID)
+    int64_t m_num_send_apps_created = 0;
+    int64_t m_num_send_apps_reused = 0;
+    int64_t m_num_flows_retired = 0;
+    int64_t m_max_num_active_flows = 0;
+    int64_t m_num_flows_started = 0;
+    int64_t m_num_flow_start_events = 0;
+    Ptr<BufferedLogSink> m_flowsCsvLogSink;
+    Ptr<BufferedLogSink> m_flowsTxtLogSink;
+    int64_t m_finalizeCallbackId;
+    int64_t m_flowsLogFlushIntervalNs;
     std::set<int64_t> m_enableFlowLoggingToFileForFlowIds;
+    bool m_flowLoggingBinary;
+    Ptr<BufferedLogSink> m_progressLogSink;
+    Ptr<BufferedLogSink> m_cwndLogSink;
+    Ptr<BufferedLogSink> m_rttLogSink;
 
 };
 
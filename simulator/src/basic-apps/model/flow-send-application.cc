@@ -101,7 +101,12 @@ FlowSendApplication::FlowSendApplication()
           m_closedNormally(false),
           m_closedByError(false),
           m_ackedBytes(0),
-          m_isCompleted(false) {
+          m_isCompleted(false),
+          m_progressLogSink(0),
+          m_cwndLogSink(0),
+          m_rttLogSink(0),
+          m_flowLogBinary(false),
+          m_ownsFlowLogSinks(false) {
     NS_LOG_FUNCTION(this);
 }
 
@@ -113,7 +118,15 @@ void
 FlowSendApplication::DoDispose(void) {
     NS_LOG_FUNCTION(this);
 
-    m_socket = 0;
+    // The socket of an ongoing flow must not call into the disposed application
+    if (m_socket != 0) {
+        DetachSocket();
+    }
+
+    // Flush the application's own flow logs
+    ReleaseFlowLogSinks();
+    m_finishedCallback = MakeNullCallback<void, int64_t>();
+
     // chain up
     Application::DoDispose();
 }
@@ -159,15 +172,19 @@ void FlowSendApplication::StartApplication(void) { // Called at time specified b
                 MakeCallback(&FlowSendApplication::SocketClosedError, this)
         );
         if (m_enableFlowLoggingToFile) {
-            std::ofstream ofs;
-            ofs.open(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_progress.txt", m_flowId));
-            ofs.close();
+
+            // If no shared log sinks are set, the flow has its own text files, which are only opened to flush
+            // the buffer (such that there are not three open files for each logged flow)
+            if (m_progressLogSink == 0) {
+                m_progressLogSink = CreateObject<BufferedLogSink>(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_progress.txt", m_flowId), 65536, false);
+                m_cwndLogSink = CreateObject<BufferedLogSink>(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_cwnd.txt", m_flowId), 65536, false);
+                m_rttLogSink = CreateObject<BufferedLogSink>(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_rtt.txt", m_flowId), 65536, false);
+                m_flowLogBinary = false;
+                m_ownsFlowLogSinks = true;
+            }
+
             m_socket->TraceConnectWithoutContext ("HighestRxAck", MakeCallback (&FlowSendApplication::HighestRxAckChange, this));
-            ofs.open(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_cwnd.txt", m_flowId));
-            ofs.close();
             m_socket->TraceConnectWithoutContext ("CongestionWindow", MakeCallback (&FlowSendApplication::CwndChange, this));
-            ofs.open(m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_rtt.txt", m_flowId));
-            ofs.close();
             m_socket->TraceConnectWithoutContext ("RTT", MakeCallback (&FlowSendApplication::RttChange, this));
         }
     }
@@ -235,7 +252,8 @@ void FlowSendApplication::ConnectionFailed(Ptr <Socket> socket) {
     m_closedNormally = false;
     m_ackedBytes = 0;
     m_isCompleted = false;
-    m_socket = 0;
+    DetachSocket();
+    NotifyFinished();
 }
 
 void FlowSendApplication::DataSend(Ptr <Socket>, uint32_t) {
@@ -245,8 +263,12 @@ void FlowSendApplication::DataSend(Ptr <Socket>, uint32_t) {
     }
 }
 
+int64_t FlowSendApplication::GetFlowId() {
+    return m_flowId;
+}
+
 int64_t FlowSendApplication::GetAckedBytes() {
-    if (m_closedNormally || m_closedByError) {
+    if (m_closedNormally || m_closedByError || m_connFailed) {
         return m_ackedBytes;
     } else {
         return m_totBytes - m_socket->GetObject<TcpSocketBase>()->GetTxBuffer()->Size();
@@ -283,7 +305,8 @@ void FlowSendApplication::SocketClosedNormal(Ptr <Socket> socket) {
     }
     m_ackedBytes = m_totBytes - m_socket->GetObject<TcpSocketBase>()->GetTxBuffer()->Size();
     m_isCompleted = m_ackedBytes == m_maxBytes;
-    m_socket = 0;
+    DetachSocket();
+    NotifyFinished();
 }
 
 void FlowSendApplication::SocketClosedError(Ptr <Socket> socket) {
@@ -292,34 +315,117 @@ void FlowSendApplication::SocketClosedError(Ptr <Socket> socket) {
     m_closedNormally = false;
     m_ackedBytes = m_totBytes - m_socket->GetObject<TcpSocketBase>()->GetTxBuffer()->Size();
     m_isCompleted = false;
+    DetachSocket();
+    NotifyFinished();
+}
+
+void FlowSendApplication::DetachSocket() {
+    // The socket lives on after the flow has finished (e.g., in TIME_WAIT), as such it
+    // must not call into the application anymore once that can be retired or re-used
+    m_socket->SetConnectCallback(MakeNullCallback<void, Ptr<Socket> >(), MakeNullCallback<void, Ptr<Socket> >());
+    m_socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+    m_socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket> >(), MakeNullCallback<void, Ptr<Socket> >());
+    if (m_enableFlowLoggingToFile) {
+        m_socket->TraceDisconnectWithoutContext ("HighestRxAck", MakeCallback (&FlowSendApplication::HighestRxAckChange, this));
+        m_socket->TraceDisconnectWithoutContext ("CongestionWindow", MakeCallback (&FlowSendApplication::CwndChange, this));
+        m_socket->TraceDisconnectWithoutContext ("RTT", MakeCallback (&FlowSendApplication::RttChange, this));
+    }
     m_socket = 0;
 }
 
+void FlowSendApplication::ReleaseFlowLogSinks() {
+    if (m_ownsFlowLogSinks) {
+        m_progressLogSink->Close();
+        m_cwndLogSink->Close();
+        m_rttLogSink->Close();
+    }
+    m_progressLogSink = 0;
+    m_cwndLogSink = 0;
+    m_rttLogSink = 0;
+    m_flowLogBinary = false;
+    m_ownsFlowLogSinks = false;
+}
+
+void FlowSendApplication::NotifyFinished() {
+    // The socket does not call into the application anymore, as such the flow logs are complete
+    ReleaseFlowLogSinks();
+    if (!m_finishedCallback.IsNull()) {
+        m_finishedCallback(m_flowId);
+    }
+}
+
+void
+FlowSendApplication::StartFlow(Address peer, uint64_t maxBytes, uint64_t flowId, bool enableFlowLoggingToFile)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_socket != 0) {
+        throw std::runtime_error("Flow send application can only start a new flow when it is idle");
+    }
+
+    // Reset the state of the previous flow (if any)
+    m_peer = peer;
+    m_maxBytes = maxBytes;
+    m_flowId = flowId;
+    m_enableFlowLoggingToFile = enableFlowLoggingToFile;
+    m_connected = false;
+    m_totBytes = 0;
+    m_completionTimeNs = -1;
+    m_connFailed = false;
+    m_closedNormally = false;
+    m_closedByError = false;
+    m_ackedBytes = 0;
+    m_isCompleted = false;
+
+    // Start right now
+    StartApplication();
+}
+
+void
+FlowSendApplication::SetFinishedCallback(Callback<void, int64_t> finishedCallback)
+{
+    m_finishedCallback = finishedCallback;
+}
+
+void
+FlowSendApplication::SetFlowLogSinks(Ptr<BufferedLogSink> progressLogSink, Ptr<BufferedLogSink> cwndLogSink, Ptr<BufferedLogSink> rttLogSink, bool binary)
+{
+    if (m_socket != 0) {
+        throw std::runtime_error("Flow log sinks must be set before the application starts");
+    }
+    m_progressLogSink = progressLogSink;
+    m_cwndLogSink = cwndLogSink;
+    m_rttLogSink = rttLogSink;
+    m_flowLogBinary = binary;
+    m_ownsFlowLogSinks = false;
+}
+
+void
+FlowSendApplication::WriteFlowLog(Ptr<BufferedLogSink> sink, int64_t value)
+{
+    if (m_flowLogBinary) {
+        flow_log_record_t record = {(int64_t) m_flowId, Simulator::Now ().GetNanoSeconds (), value};
+        sink->Write(&record, sizeof(flow_log_record_t));
+    } else {
+        sink->WriteCsvLine(m_flowId, Simulator::Now ().GetNanoSeconds (), value);
+    }
+}
+
 void
 FlowSendApplication::HighestRxAckChange(SequenceNumber<unsigned int, int> oldHighestRxAck, SequenceNumber<unsigned int, int> newHighestRxAck)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_progress.txt", m_flowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_flowId << "," << Simulator::Now ().GetNanoSeconds () << "," << (m_totBytes - m_socket->GetObject<TcpSocketBase>()->GetTxBuffer()->Size()) << std::endl;
-    ofs.close();
+    WriteFlowLog(m_progressLogSink, m_totBytes - m_socket->GetObject<TcpSocketBase>()->GetTxBuffer()->Size());
 }
 
 void
 FlowSendApplication::CwndChange(uint32_t oldCwnd, uint32_t newCwnd)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_cwnd.txt", m_flowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_flowId << "," << Simulator::Now ().GetNanoSeconds () << "," << newCwnd << std::endl;
-    ofs.close();
+    WriteFlowLog(m_cwndLogSink, newCwnd);
 }
 
 void
 FlowSendApplication::RttChange (Time oldRtt, Time newRtt)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("flow_%" PRIu64 "_rtt.txt", m_flowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_flowId << "," << Simulator::Now ().GetNanoSeconds () << "," << newRtt.GetNanoSeconds() << std::endl;
-    ofs.close();
+    WriteFlowLog(m_rttLogSink, newRtt.GetNanoSeconds());
 }
 
 } // Namespace ns3
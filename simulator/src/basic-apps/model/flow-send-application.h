@@ -29,12 +29,23 @@
 #include "ns3/ptr.h"
 #include "ns3/string.h"
 #include "ns3/traced-callback.h"
+#include "ns3/buffered-log-sink.h"
 
 namespace ns3 {
 
 class Address;
 class Socket;
 
+/**
+ * Record of the binary flow log format (native byte order).
+ * The text format has the same fields per line: flow_id,time_ns,value
+ */
+struct flow_log_record_t {
+    int64_t flow_id;
+    int64_t time_ns;
+    int64_t value;
+};
+
 class FlowSendApplication : public Application
 {
 public:
@@ -44,6 +55,7 @@ public:
 
   virtual ~FlowSendApplication ();
 
+  int64_t GetFlowId();
   int64_t GetAckedBytes();
   int64_t GetCompletionTimeNs();
   bool IsCompleted();
@@ -51,6 +63,40 @@ public:
   bool IsClosedByError();
   bool IsClosedNormally();
 
+  /**
+   * Log to shared sinks instead of the per-flow text files (logs_dir/flow_[id]_{progress, cwnd, rtt}.txt).
+   * Must be set before the application starts.
+   *
+   * @param progressLogSink   Progress log sink
+   * @param cwndLogSink       Congestion window log sink
+   * @param rttLogSink        RTT log sink
+   * @param binary            True iff flow_log_record_t records are written instead of text lines
+   */
+  void SetFlowLogSinks(Ptr<BufferedLogSink> progressLogSink, Ptr<BufferedLogSink> cwndLogSink, Ptr<BufferedLogSink> rttLogSink, bool binary);
+
+  /**
+   * Start a new flow right now, re-using this application. It must be idle: either it has
+   * never been started, or its previous flow has reached its final state. A new socket is
+   * created for the flow, as a TCP connection cannot be re-used after it has been closed.
+   * Shared flow log sinks (SetFlowLogSinks) are only for this flow and must be set before.
+   *
+   * @param peer                      Address of the destination
+   * @param maxBytes                  Amount of bytes to send
+   * @param flowId                    Flow identifier
+   * @param enableFlowLoggingToFile   True iff the flow progress, cwnd and RTT are logged
+   */
+  void StartFlow(Address peer, uint64_t maxBytes, uint64_t flowId, bool enableFlowLoggingToFile);
+
+  /**
+   * Set the callback which is called with the flow identifier once the flow has reached its
+   * final state (connection failed, or socket closed normally or by error). The socket callbacks
+   * and traces are detached before, as such the application can then be retired or re-used even
+   * though the socket itself lives on (e.g., in TIME_WAIT).
+   *
+   * @param finishedCallback  Finished callback
+   */
+  void SetFinishedCallback(Callback<void, int64_t> finishedCallback);
+
 protected:
   virtual void DoDispose (void);
 private:
@@ -81,6 +127,12 @@ private:
   bool m_enableFlowLoggingToFile;          //!< True iff you want to write flow logs
   std::string m_baseLogsDir;               //!< Where the flow logs will be written to:
                                            //!<   logs_dir/flow-[id]-{progress, cwnd, rtt}.txt
+  Ptr<BufferedLogSink> m_progressLogSink;  //!< Progress log sink
+  Ptr<BufferedLogSink> m_cwndLogSink;      //!< Congestion window log sink
+  Ptr<BufferedLogSink> m_rttLogSink;       //!< RTT log sink
+  bool m_flowLogBinary;                    //!< True iff the log sinks are written in binary record format
+  bool m_ownsFlowLogSinks;                 //!< True iff the log sinks are the application's own per-flow text files
+  Callback<void, int64_t> m_finishedCallback; //!< Called once the flow has reached its final state
   TracedCallback<Ptr<const Packet> > m_txTrace;
 
 private:
@@ -92,6 +144,10 @@ private:
   void RttChange(Time oldRtt, Time newRtt);
   void CwndChange(uint32_t oldCwnd, uint32_t newCwnd);
   void HighestRxAckChange(SequenceNumber<unsigned int, int> oldHighestRxAck, SequenceNumber<unsigned int, int> newHighestRxAck);
+  void WriteFlowLog(Ptr<BufferedLogSink> sink, int64_t value);
+  void DetachSocket();
+  void NotifyFinished();
+  void ReleaseFlowLogSinks();
 
 };
 
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "horovod-event-arena.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace ns3 {
+
+const int64_t HorovodEventArena::BLOCK_NUM_EVENTS;
+
+HorovodEventArena::HorovodEventArena() {
+    AddBlock();
+}
+
+void HorovodEventArena::AddBlock() {
+    m_blocks.push_back(std::unique_ptr<horovod_event_t[]>(new horovod_event_t[BLOCK_NUM_EVENTS]));
+    m_num_in_last_block = 0;
+}
+
+void HorovodEventArena::Write(std::ostream& out) const {
+    char line[128];
+    for (size_t b = 0; b < m_blocks.size(); b++) {
+        int64_t num_in_block = b + 1 == m_blocks.size() ? m_num_in_last_block : BLOCK_NUM_EVENTS;
+        for (int64_t i = 0; i < num_in_block; i++) {
+            const horovod_event_t& event = m_blocks[b][i];
+            int size;
+            switch (event.type) {
+                case HOROVOD_EVENT_BP_START:
+                    size = snprintf(line, sizeof(line), "%u,%u,BP_Start,%" PRId64 "\n", event.iteration_idx, event.layer_idx, event.time_ns);
+                    break;
+                case HOROVOD_EVENT_BP_DONE:
+                    size = snprintf(line, sizeof(line), "%u,%u,BP_Done,%" PRId64 "\n", event.iteration_idx, event.layer_idx, event.time_ns);
+                    break;
+                case HOROVOD_EVENT_FP_START:
+                    size = snprintf(line, sizeof(line), "%u,%u,FP_Start,%" PRId64 "\n", event.iteration_idx, event.layer_idx, event.time_ns);
+                    break;
+                case HOROVOD_EVENT_FP_DONE:
+                    size = snprintf(line, sizeof(line), "%u,%u,FP_Done,%" PRId64 "\n", event.iteration_idx, event.layer_idx, event.time_ns);
+                    break;
+                case HOROVOD_EVENT_START_SENDING_PARTITION:
+                    size = snprintf(line, sizeof(line), "%u,%u,Start_Sending_Partition_%u_Priority_%u,%" PRId64 "\n",
+                                    event.iteration_idx, event.layer_idx, event.partition_idx, (unsigned) event.priority, event.time_ns);
+                    break;
+                case HOROVOD_EVENT_RECEIVED_PARTITION:
+                    size = snprintf(line, sizeof(line), "%u,%u,Received_Partition_%u_Priority_%u,%" PRId64 "\n",
+                                    event.iteration_idx, event.layer_idx, event.partition_idx, (unsigned) event.priority, event.time_ns);
+                    break;
+                default:
+                    throw std::runtime_error("Unknown Horovod event type");
+            }
+            out.write(line, size);
+        }
+    }
+}
+
+int64_t HorovodEventArena::GetNumEvents() const {
+    return (m_blocks.size() - 1) * BLOCK_NUM_EVENTS + m_num_in_last_block;
+}
+
+int64_t HorovodEventArena::GetMemoryUsageByte() const {
+    return m_blocks.size() * BLOCK_NUM_EVENTS * sizeof(horovod_event_t);
+}
+
+void HorovodEventArena::Clear() {
+    m_blocks.clear();
+    AddBlock();
+}
+
+}
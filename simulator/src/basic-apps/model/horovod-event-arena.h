@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef HOROVOD_EVENT_ARENA_H
+#define HOROVOD_EVENT_ARENA_H
+
+#include <stdint.h>
+#include <cinttypes>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+enum HorovodEventType : uint8_t {
+  HOROVOD_EVENT_BP_START,
+  HOROVOD_EVENT_BP_DONE,
+  HOROVOD_EVENT_FP_START,
+  HOROVOD_EVENT_FP_DONE,
+  HOROVOD_EVENT_START_SENDING_PARTITION,  // Has partition and priority
+  HOROVOD_EVENT_RECEIVED_PARTITION        // Has partition and priority
+};
+
+typedef struct horovod_event {
+  int64_t time_ns;
+  uint32_t iteration_idx;
+  uint32_t layer_idx;
+  uint32_t partition_idx;
+  HorovodEventType type;
+  uint8_t priority;
+} horovod_event_t;
+
+/**
+ * Arena of fixed-size timeline event records of a Horovod worker.
+ * Records are stored in fixed-size blocks, such that they are never copied
+ * when the arena grows. They are only formatted as text when written out.
+ */
+class HorovodEventArena {
+ public:
+  static const int64_t BLOCK_NUM_EVENTS = 4096;
+
+  HorovodEventArena();
+
+  void Add(int64_t time_ns, uint32_t iteration_idx, uint32_t layer_idx,
+           HorovodEventType type, uint32_t partition_idx = 0, uint8_t priority = 0) {
+    if (m_num_in_last_block == BLOCK_NUM_EVENTS) {
+      AddBlock();
+    }
+    horovod_event_t& event = m_blocks.back()[m_num_in_last_block];
+    event.time_ns = time_ns;
+    event.iteration_idx = iteration_idx;
+    event.layer_idx = layer_idx;
+    event.partition_idx = partition_idx;
+    event.type = type;
+    event.priority = priority;
+    m_num_in_last_block++;
+  }
+
+  /**
+   * Write all events in order, each as a line "[iteration],[layer],[event],[time (ns)]".
+   *
+   * @param out   Output stream
+   */
+  void Write(std::ostream& out) const;
+
+  int64_t GetNumEvents() const;
+  int64_t GetMemoryUsageByte() const;
+  void Clear();
+
+ private:
+  void AddBlock();
+
+  std::vector<std::unique_ptr<horovod_event_t[]>> m_blocks;
+  int64_t m_num_in_last_block;
+};
+
+}
+
+#endif /* HOROVOD_EVENT_ARENA_H */
@@ -14,6 +14,14 @@ HorovodScheduler::HorovodScheduler(Ptr<BasicSimulation> basicSimulation, Ptr<Top
      
     m_run_horovod = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("run_horovod","false"));   
     m_prio_config =  m_basicSimulation->GetConfigParamOrDefault("horovod_initial_priority","0x08");
+
+    // Tracing of the workers into a ring buffer, which is dumped when writing the results
+    HorovodTraceLevel trace_level = parse_horovod_trace_level(m_basicSimulation->GetConfigParamOrDefault("horovod_trace_level", "none"));
+    int64_t trace_buffer_size = parse_positive_int64(m_basicSimulation->GetConfigParamOrDefault("horovod_trace_buffer_size", "65536"));
+    m_trace_buffer = CreateObject<HorovodTraceBuffer>(trace_level, trace_buffer_size);
+    if (trace_level > HOROVOD_TRACE_MAX_LEVEL) {
+        std::cout << "Horovod trace level exceeds the compile-time cutoff (HOROVOD_TRACE_MAX_LEVEL=" << HOROVOD_TRACE_MAX_LEVEL << "), messages above it are not recorded" << std::endl;
+    }
     // read config
     m_config = read_config(m_basicSimulation->GetRunDir() + "/" +
                 m_basicSimulation->GetConfigParamOrFail("horovod_config_file"));
@@ -83,6 +91,7 @@ void HorovodScheduler::Schedule(uint32_t port) {
             ApplicationContainer app = horovodworker.Install(m_nodes.Get(i));
             app.Start(Seconds(0)); // *seconds only takes integers!
             app.Get(0)->GetObject<HorovodWorker>()->SetGlobalRingallreduceSyncer(&m_global_ringallreduce_syncer);
+            app.Get(0)->GetObject<HorovodWorker>()->SetTraceBuffer(m_trace_buffer);
 
             // set num_layers
             app.Get(0)->GetObject<HorovodWorker>()->SetNumLayers(m_num_layers);
@@ -133,19 +142,22 @@ void HorovodScheduler::WriteResults() {
     if(m_run_horovod){
         std::cout<<"    > m_num_workers "<<m_num_workers<<std::endl;
         for (int i = 0; i < m_num_workers; i++){
-            std::vector<std::string> events = m_apps[i].Get(0)->GetObject<HorovodWorker>()->GetEventString();
-            // todo: compare performance vs FILE and fprintf
+            const HorovodEventArena& events = m_apps[i].Get(0)->GetObject<HorovodWorker>()->GetEventArena();
             std::ofstream ofs;
             std::string progress_file = format_string("HorovodWorker_%" PRIu32 "_layer_%" PRIu32 "_port_%u_progress.txt", i, m_num_layers, m_port);
-            std::cout<<"write to logfile: "<<m_basicSimulation->GetLogsDir()<<"/"<<progress_file<<std::endl;
-            ofs.open(m_basicSimulation->GetLogsDir() + "/" + format_string("HorovodWorker_%" PRIu32 "_layer_%" PRIu32 "_port_%u_progress.txt", i, m_num_layers, m_port),
-            std::ofstream::out | std::ofstream::app);
-            for (std::vector<std::string>::iterator it = events.begin(); it != events.end(); it++) {
-                
-                ofs << *it;
-            }
+            std::cout<<"write to logfile: "<<m_basicSimulation->GetLogsDir()<<"/"<<progress_file<<" ("<<events.GetNumEvents()<<" events)"<<std::endl;
+            ofs.open(m_basicSimulation->GetLogsDir() + "/" + progress_file, std::ofstream::out | std::ofstream::app);
+            events.Write(ofs);
             ofs.close(); 
         }
+
+        // Dump the trace ring buffer
+        if (m_trace_buffer->GetLevel() != HOROVOD_TRACE_NONE) {
+            std::string trace_file = m_basicSimulation->GetLogsDir() + "/" + format_string("horovod_trace_port_%u.txt", m_port);
+            m_trace_buffer->Dump(trace_file);
+            std::cout << "    > Trace: " << m_trace_buffer->GetNumRetained() << " of " << m_trace_buffer->GetNumRecorded()
+                      << " recorded messages written to " << trace_file << std::endl;
+        }
     }
 }
 }
@@ -29,6 +29,7 @@
 #include "ns3/exp-util.h"
 #include "ns3/topology.h"
 #include "ns3/horovod-worker-helper.h"
+#include "ns3/horovod-trace-buffer.h"
 #include "ringallreduce-syncer.h"
 
 using namespace ns3;
@@ -67,6 +68,7 @@ protected:
     std::string m_bp_compute_time_file;
     uint32_t m_port;
     GlobalRingAllReduceSyncer m_global_ringallreduce_syncer;
+    Ptr<HorovodTraceBuffer> m_trace_buffer;
 };
 
 }
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "horovod-trace-buffer.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+HorovodTraceLevel parse_horovod_trace_level(const std::string& name) {
+    if (name == "none") {
+        return HOROVOD_TRACE_NONE;
+    } else if (name == "info") {
+        return HOROVOD_TRACE_INFO;
+    } else if (name == "debug") {
+        return HOROVOD_TRACE_DEBUG;
+    } else {
+        throw std::invalid_argument(format_string("Unknown Horovod trace level: %s (valid: none, info, debug)", name.c_str()));
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED (HorovodTraceBuffer);
+TypeId HorovodTraceBuffer::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::HorovodTraceBuffer")
+            .SetParent<Object> ()
+            .SetGroupName("BasicApps")
+    ;
+    return tid;
+}
+
+HorovodTraceBuffer::HorovodTraceBuffer(HorovodTraceLevel level, int64_t capacity) {
+    if (capacity < 1) {
+        throw std::invalid_argument("Horovod trace buffer capacity must be at least 1 record");
+    }
+    m_level = level;
+    m_capacity = capacity;
+    m_next = 0;
+    m_num_recorded = 0;
+}
+
+void HorovodTraceBuffer::Record(HorovodTraceLevel level, uint32_t worker_id, uint32_t port, const std::string& message) {
+    if (level > m_level) {
+        return;
+    }
+    horovod_trace_record_t record = {Simulator::Now().GetNanoSeconds(), worker_id, port, level, message};
+    if ((int64_t) m_records.size() < m_capacity) {
+        m_records.push_back(record);
+    } else {
+        m_records[m_next] = record;
+    }
+    m_next = (m_next + 1) % m_capacity;
+    m_num_recorded++;
+}
+
+void HorovodTraceBuffer::Dump(std::ostream& out) const {
+
+    // Oldest record first: if the buffer has wrapped around, that is the one which is overwritten next
+    int64_t start = (int64_t) m_records.size() < m_capacity ? 0 : m_next;
+    for (int64_t i = 0; i < (int64_t) m_records.size(); i++) {
+        const horovod_trace_record_t& record = m_records[(start + i) % m_records.size()];
+        out << record.time_ns << " Worker ID: " << record.worker_id << " Port: " << record.port
+            << " " << (record.level == HOROVOD_TRACE_DEBUG ? "DEBUG" : "INFO") << " " << record.message << std::endl;
+    }
+
+}
+
+void HorovodTraceBuffer::Dump(const std::string& filename) const {
+    std::ofstream ofs(filename);
+    if (!ofs) {
+        throw std::runtime_error(format_string("Could not open Horovod trace file: %s", filename.c_str()));
+    }
+    Dump(ofs);
+    ofs.close();
+}
+
+void HorovodTraceBuffer::Clear() {
+    m_records.clear();
+    m_next = 0;
+}
+
+HorovodTraceLevel HorovodTraceBuffer::GetLevel() const {
+    return m_level;
+}
+
+int64_t HorovodTraceBuffer::GetCapacity() const {
+    return m_capacity;
+}
+
+int64_t HorovodTraceBuffer::GetNumRetained() const {
+    return m_records.size();
+}
+
+int64_t HorovodTraceBuffer::GetNumRecorded() const {
+    return m_num_recorded;
+}
+
+}
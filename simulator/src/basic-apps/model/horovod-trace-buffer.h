@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef HOROVOD_TRACE_BUFFER_H
+#define HOROVOD_TRACE_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cinttypes>
+#include "ns3/object.h"
+#include "ns3/exp-util.h"
+
+// Compile-time cutoff of the Horovod tracing: messages above this level are not
+// compiled in at all (e.g., CXXFLAGS="-DHOROVOD_TRACE_MAX_LEVEL=0" removes all of them)
+#ifndef HOROVOD_TRACE_MAX_LEVEL
+#define HOROVOD_TRACE_MAX_LEVEL 2
+#endif
+
+/**
+ * Record a trace message (stream expression) of a given level into the trace buffer.
+ * Requires m_trace_buffer, m_trace_level, m_worker_id and m_port to be in scope.
+ * If the level is not enabled, nothing is formatted: the cost is a single comparison,
+ * or nothing at all if the level is above the compile-time cutoff.
+ */
+#define HOROVOD_TRACE(level, str) \
+  do { \
+    if ((level) <= HOROVOD_TRACE_MAX_LEVEL && (level) <= m_trace_level) { \
+      std::ostringstream horovod_trace_oss; \
+      horovod_trace_oss << str; \
+      m_trace_buffer->Record(level, m_worker_id, m_port, horovod_trace_oss.str()); \
+    } \
+  } while (false)
+
+namespace ns3 {
+
+// INFO: worker life-cycle and per-iteration events (connection, layer compute, ring-allreduce start and done)
+// DEBUG: additionally every received packet and partial send
+enum HorovodTraceLevel {
+  HOROVOD_TRACE_NONE = 0,
+  HOROVOD_TRACE_INFO = 1,
+  HOROVOD_TRACE_DEBUG = 2
+};
+
+/**
+ * Parse the Horovod trace level from its name ("none", "info" or "debug").
+ *
+ * @param name  Name of the level
+ *
+ * @return Trace level
+ */
+HorovodTraceLevel parse_horovod_trace_level(const std::string& name);
+
+typedef struct horovod_trace_record {
+  int64_t time_ns;
+  uint32_t worker_id;
+  uint32_t port;
+  HorovodTraceLevel level;
+  std::string message;
+} horovod_trace_record_t;
+
+/**
+ * Fixed-capacity ring buffer of trace records shared by the Horovod workers.
+ * Once full, the oldest records are overwritten. It is only written to file
+ * when it is dumped.
+ */
+class HorovodTraceBuffer : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * Create a trace buffer.
+   *
+   * @param level         Runtime trace level (records of a higher level are not recorded)
+   * @param capacity      Maximum number of records retained (at least 1)
+   */
+  HorovodTraceBuffer(HorovodTraceLevel level, int64_t capacity);
+
+  void Record(HorovodTraceLevel level, uint32_t worker_id, uint32_t port, const std::string& message);
+  void Dump(std::ostream& out) const;
+  void Dump(const std::string& filename) const;
+  void Clear();
+
+  HorovodTraceLevel GetLevel() const;
+  int64_t GetCapacity() const;
+  int64_t GetNumRetained() const;
+  int64_t GetNumRecorded() const;
+
+private:
+  HorovodTraceLevel m_level;
+  std::vector<horovod_trace_record_t> m_records;
+  int64_t m_capacity;
+  int64_t m_next;
+  int64_t m_num_recorded;
+};
+
+}
+
+#endif /* HOROVOD_TRACE_BUFFER_H */
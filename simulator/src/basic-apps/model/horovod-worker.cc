@@ -296,23 +296,23 @@ void HorovodWorker::HandleRead(Ptr<Socket> socket) {
     Address from;
     while ((packet = socket->RecvFrom(from))) {
         if (packet->GetSize() == 0) { // EOFs
-            DEBUG_MSG("Received 0 length packets");
+            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "Received 0 length packets");
             break;
         }
         
         m_totalRx += packet->GetSize ();
         // std::cout<<"  > Received up to "<< m_totalRx<<"\n";
-        DEBUG_MSG("  > Received up to "<< m_totalRx);
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "  > Received up to "<< m_totalRx);
         // std::cout<<"  > Curr time: "<< Simulator::Now()<<std::endl;
         std::map<uint32_t, FusionPartition*> map = m_leftneighbor->GetInflightFusions();
-        DEBUG_MSG("left neighbor bytes sent vector lastest: "<<m_leftneighbor->GetBytesSentVector().back());
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "left neighbor bytes sent vector lastest: "<<m_leftneighbor->GetBytesSentVector().back());
         // for( std::vector<uint32_t>::reverse_iterator it = m_leftneighbor->GetBytesSentVector().rbegin(); it != m_leftneighbor->GetBytesSentVector().rend(); ++it ){
         uint32_t update_last_received_index = m_last_received_index;
         for( std::vector<uint64_t>::iterator it = m_leftneighbor->GetBytesSentVector().begin() + m_last_received_index; it != m_leftneighbor->GetBytesSentVector().end(); ++it ){
             // Debug(format_string("left neighbor byte sent vector: %u", *it));
 
             if (m_totalRx >= *it) {
-                DEBUG_MSG("m_totalRx:"<<m_totalRx<<" >= *it "<<*it);
+                HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "m_totalRx:"<<m_totalRx<<" >= *it "<<*it);
                 // Debug(format_string("received vector empty %u", m_bytes_received_vector.empty()));
                 // std::cout<<"received vector empty"<< m_bytes_received_vector.empty()<<std::endl;
                 // if((m_bytes_received_vector.empty()) || (*it != m_bytes_received_vector.back())){
@@ -321,13 +321,13 @@ void HorovodWorker::HandleRead(Ptr<Socket> socket) {
                     // found fusion, push it back to received vector
                     m_bytes_received_vector.push_back(*it);
                     // matches whats being sent by the neighbor
-                    DEBUG_MSG("     > Left neighbor is: "<<m_leftneighbor->GetWorkerID());
-                    DEBUG_MSG("    > FOUND FUSION : "<<map[*it]);
+                    HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "     > Left neighbor is: "<<m_leftneighbor->GetWorkerID());
+                    HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "    > FOUND FUSION : "<<map[*it]);
 
                     uint32_t partition_idx = map[*it]->GetIdx();
 
                     for(auto layer: map[*it]->GetParent()->GetTensors()){
-                        RecordEvent(layer, format_string("Received_Partition_%" PRIu32 "_Priority_%" PRIu64, partition_idx, uint64_t(m_send_socket->GetPriority())));
+                        RecordEvent(layer, HOROVOD_EVENT_RECEIVED_PARTITION, partition_idx, m_send_socket->GetPriority());
                     }
 
                     uint32_t new_progress = map[*it]->GetProgress() +1;
@@ -337,12 +337,12 @@ void HorovodWorker::HandleRead(Ptr<Socket> socket) {
                     // if (map[*it]->GetProgress() < 2 * (m_num_workers-1) ) // not yet fully synced
                     if (new_progress < 2 * (m_num_workers-1) ) // not yet fully synced
                     {
-                        DEBUG_MSG("    > Not fully synced, send Partition "<<partition_idx<<" to neighbor");
+                        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "    > Not fully synced, send Partition "<<partition_idx<<" to neighbor");
 
                         // send to right neighbor, add to transmission queue
                         m_maxBytes += map[*it]->GetSize();
                         m_bytes_sent += map[*it]->GetSize();
-                        DEBUG_MSG("    > Update fusion map ["<<m_bytes_sent<<"] "<< partition_idx);
+                        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "    > Update fusion map ["<<m_bytes_sent<<"] "<< partition_idx);
                         m_inflight_fusion_map[m_bytes_sent] = m_inflight_allreduce->GetPartitions()[partition_idx];
                         m_bytes_sent_vector.push_back(m_bytes_sent);   
 
@@ -359,26 +359,26 @@ void HorovodWorker::HandleRead(Ptr<Socket> socket) {
                         // Check if all paritions have truly been synced and if other workers have done, otherwise                         
                         if(CheckAllPartitionSynced(partition_idx)){
                             // std::cout<<"    > all local partitions are synced "<<std::endl;
-                            DEBUG_MSG("    > all local partitions are synced for Prio "<< m_inflight_allreduce->GetPriority());
-                            DEBUG_MSG("    > Update Global ");
+                            HOROVOD_TRACE(HOROVOD_TRACE_INFO, "    > all local partitions are synced for Prio "<< m_inflight_allreduce->GetPriority());
+                            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "    > Update Global ");
                             UpdateGlobalRingallreduceSyncer();
  
                             if(CheckAllWorkersSynced()){
                                 // std::cout<<"    > RingAllreduce done for: "<<m_inflight_allreduce->GetPriority()<<"\n";
                                 // std::cout<<"    > All workers are synced notify other workers" <<std::endl;
-                                DEBUG_MSG("    > RingAllreduce done for: "<<m_inflight_allreduce->GetPriority());
-                                DEBUG_MSG("    > All workers are synced notify other workers");
+                                HOROVOD_TRACE(HOROVOD_TRACE_INFO, "    > RingAllreduce done for: "<<m_inflight_allreduce->GetPriority());
+                                HOROVOD_TRACE(HOROVOD_TRACE_INFO, "    > All workers are synced notify other workers");
                                 NotifyAllOtherWorkers();
                             }
                             else{
                                 //  Not all workers have finished syncing
                                 // std::cout <<"     > Not all workers have finished syncing" <<std::endl;
-                                DEBUG_MSG("     > Not all workers have finished syncing");
+                                HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "     > Not all workers have finished syncing");
                             }
                         }
                         else{
                             // std::cout <<"      > Not all partitions are synced"<<std::endl;
-                            DEBUG_MSG("      > Not all partitions are synced");
+                            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "      > Not all partitions are synced");
                             // std::cout<<"      > Not ready to remove inflight ringallreduce yet"<<std::endl;
                         }
                     }
@@ -480,7 +480,7 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
     NS_LOG_FUNCTION(this);
     if ( ((m_qdisc == FIFOQDISC) && m_fifo_transmission_queue.empty() && (m_ringallreduce_inflight_status != true) ) || ((m_qdisc == PERFECTPRIORITY) && m_perfectpriority_queue.empty() && (m_ringallreduce_inflight_status != true))){
         // std::cout<<"  > fifo or priority transmission queue empty \n";
-        DEBUG_MSG("  > fifo or priority transmission queue empty");
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "  > fifo or priority transmission queue empty");
         // sendData otherwise is always called right after connection is established
         return;
     }
@@ -493,7 +493,7 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
         if(m_global_ringallreduce_syncer->Empty()){
             m_global_ringallreduce_syncer->AddRingallreduce(prio);
             // std::cout<<" Add to global ringallreduce: "<<prio<<" progress: "<< m_global_ringallreduce_syncer->GetProgress() <<std::endl;
-            DEBUG_MSG(" Add to global ringallreduce: "<<prio<<" progress: "<< m_global_ringallreduce_syncer->GetProgress() );
+            HOROVOD_TRACE(HOROVOD_TRACE_INFO, " Add to global ringallreduce: "<<prio<<" progress: "<< m_global_ringallreduce_syncer->GetProgress() );
         }
         else if( m_global_ringallreduce_syncer->GetPriority() != prio){
             // Not allowed, all workers need to agree on one ringallreduce to work with
@@ -502,7 +502,7 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
             // Todo! check the queue to see if desired ringallreduce exist, if it does, deque it first
         }
         else{
-            DEBUG_MSG(" >Working on the same global ringallreduce: "<< prio);
+            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, " >Working on the same global ringallreduce: "<< prio);
         }
 
         DequeTransmission();
@@ -519,9 +519,9 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
         m_bytes_sent += m_inflight_allreduce->GetPartitionSize();
         // m_bytes_sent += m_maxBytes;
         // std::cout<<"  > Add to fusion map key: " <<m_bytes_sent<< " Partition: " <<p_idx <<std::endl;
-        DEBUG_MSG("  > Add m_bytes_sent_vector: " <<m_bytes_sent<< " Partition: " <<p_idx);
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "  > Add m_bytes_sent_vector: " <<m_bytes_sent<< " Partition: " <<p_idx);
         m_bytes_sent_vector.push_back(m_bytes_sent);
-        DEBUG_MSG("    > Update fusion map ["<<m_bytes_sent<<"] "<< m_worker_id);
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "    > Update fusion map ["<<m_bytes_sent<<"] "<< m_worker_id);
         m_inflight_fusion_map[m_bytes_sent] = m_inflight_allreduce->GetPartitions()[m_worker_id];
 
         // ***** Scheduling scheme 1:
@@ -539,8 +539,8 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
         // }
 
         for(auto layer: m_inflight_allreduce->GetTensors()){
-            RecordEvent(layer, format_string("Start_Sending_Partition_%" PRIu32 "_Priority_%" PRIu64, m_worker_id, uint64_t(m_send_socket->GetPriority())));
-            DEBUG_MSG("Start_Sending_Partition_"<<m_worker_id<<"_Priority_"<< uint64_t(m_send_socket->GetPriority()) << " layer: "<< layer);
+            RecordEvent(layer, HOROVOD_EVENT_START_SENDING_PARTITION, m_worker_id, m_send_socket->GetPriority());
+            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "Start_Sending_Partition_"<<m_worker_id<<"_Priority_"<< uint64_t(m_send_socket->GetPriority()) << " layer: "<< layer);
         }
     }
     
@@ -564,13 +564,12 @@ void HorovodWorker::SendData(Ptr <Socket>, uint32_t) {
         // buffer is full. The "DataSent" callback will pop when
         // some buffer space has freed up.
         if ( actual == -1) {
-            std::cout<<"  > Break from sendData, actual: "<<actual <<" toSend: "<<toSend<<std::endl;
-            std::cout<<"  > curr time in nana: "<< Simulator::Now()<<std::endl;
+            HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "  > Break from sendData, actual: "<<actual <<" toSend: "<<toSend);
             break;
         }
     }
     if (m_maxBytes == 0){
-        DEBUG_MSG("Sent everything, m_maxBytes is zero, total bytes sent "<<m_bytes_sent);
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "Sent everything, m_maxBytes is zero, total bytes sent "<<m_bytes_sent);
         
     }
 }
@@ -581,7 +580,7 @@ void HorovodWorker::BackPropagationStart(uint32_t layer_idx){
     int64_t curr_timestamp = Simulator::Now().GetNanoSeconds();
     float compute_time_ms = m_bp_layer_compute_time_ms[layer_idx];
     m_timeline["Start_BP"].push_back(curr_timestamp);
-    RecordEvent(layer_idx, "BP_Start");
+    RecordEvent(layer_idx, HOROVOD_EVENT_BP_START);
     // std::cout <<"  > Start_BP "<<m_timeline["Start_BP"].back()<<"\n";
     // std::cout <<"    > compute_time_ms: "<<compute_time_ms<<"\n";
     uint32_t compute_time_ns = uint32_t(compute_time_ms * 1000000.0);
@@ -595,7 +594,7 @@ void HorovodWorker::ForwardPropagationStart(uint32_t layer_idx){
     // std::cout<<"  > Trying to start FP["<<layer_idx<<"]"<<std::endl;
     if(m_gradients_received[layer_idx] == false){
         // std::cout<<" > Have not received gradients for FP["<<layer_idx<<"]"<<std::endl;
-        DEBUG_MSG(" > Have not received gradients for FP["<<layer_idx<<"]");
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, " > Have not received gradients for FP["<<layer_idx<<"]");
         return;
     }
 
@@ -603,10 +602,10 @@ void HorovodWorker::ForwardPropagationStart(uint32_t layer_idx){
     {
         float compute_time_ms = m_fp_layer_compute_time_ms[layer_idx];        
         // std::cout<<"  > Schedule FP["<<layer_idx<<"] to finish in "<< compute_time_ms<<" ms"<<std::endl;
-        RecordEvent(layer_idx, "FP_Start");
+        RecordEvent(layer_idx, HOROVOD_EVENT_FP_START);
         uint32_t compute_time_ns = uint32_t(compute_time_ms * 1000000.0);
         // std::cout<<"  > Schedule FP["<<layer_idx<<"] to finish in "<< compute_time_ns<<" ns"<<std::endl;
-        DEBUG_MSG("  > Schedule FP["<<layer_idx<<"] to finish in ");
+        HOROVOD_TRACE(HOROVOD_TRACE_INFO, "  > Schedule FP["<<layer_idx<<"] to finish in "<< compute_time_ns<<" ns");
         Simulator::Schedule(NanoSeconds(compute_time_ns), &HorovodWorker::ForwardPropagationDone, this, layer_idx);
     }
 
@@ -622,7 +621,7 @@ void HorovodWorker::ForwardPropagationDone(uint32_t layer_idx){
     m_fp_finished_status[layer_idx - 1] = false;
     m_fp_finished_status[layer_idx] = true;
     m_gradients_received[layer_idx] = false;
-    RecordEvent(layer_idx, "FP_Done");
+    RecordEvent(layer_idx, HOROVOD_EVENT_FP_DONE);
     // std::cout<<"  > ForwardProp Done "<<layer_idx<<std::endl;
     if(layer_idx == m_num_layers-1){
         /********** Enforce a max iteration limit
@@ -644,6 +643,7 @@ void HorovodWorker::ForwardPropagationDone(uint32_t layer_idx){
 
         // Debug(format_string("FP Done, start BP for iter: " PRIu32, m_iteration_idx));
         // std::cout<<"    > FP Done, start BP for iter: "<< m_iteration_idx<<std::endl;
+        HOROVOD_TRACE(HOROVOD_TRACE_INFO, "    > FP Done, start BP for iter: "<< m_iteration_idx);
         BackPropagationStart(m_num_layers-1);
 
 
@@ -700,6 +700,11 @@ void HorovodWorker::SetNumWorkers(uint32_t num_workers){
     m_num_workers=num_workers;
 }
 
+void HorovodWorker::SetTraceBuffer(Ptr<HorovodTraceBuffer> trace_buffer){
+    m_trace_buffer = trace_buffer;
+    m_trace_level = trace_buffer->GetLevel();
+}
+
 void HorovodWorker::InitializeLayerWeight(){
     std::string filename = m_runDir + "/" + "layer_size.csv";
     m_layer_size_bytes = read_layer_size(filename);
@@ -811,7 +816,7 @@ RingAllReduce* HorovodWorker::QueuePeek(){
 void HorovodWorker::StartRingAllReduce(uint32_t layer_idx){
     if(m_ringallreduce_map.find(layer_idx) != m_ringallreduce_map.end())
     {
-        DEBUG_MSG("  > add to fifo queue a new ringallreduce of priority "<< layer_idx);
+        HOROVOD_TRACE(HOROVOD_TRACE_INFO, "  > add to fifo queue a new ringallreduce of priority "<< layer_idx);
         //Todo: send updates to worker 0 and worker 0 will broadcast to all workers when its ready to start ringallreduce
         EnqueTransmission(m_ringallreduce_map[layer_idx]);
         SendData(m_send_socket, 0);
@@ -825,8 +830,8 @@ void HorovodWorker::BackPropagationDone(uint32_t layer_idx){
     NS_LOG_FUNCTION(this);
     // NS_ASSERT(m_bp_compute.IsExpired());
     // std::cout<<"  > Done_BP["<< layer_idx<<"]: "<<Simulator::Now().GetNanoSeconds() <<"\n";
-    DEBUG_MSG("  > Done_BP["<< layer_idx<<"]: "<<Simulator::Now().GetNanoSeconds() );
-    RecordEvent(layer_idx, "BP_Done");
+    HOROVOD_TRACE(HOROVOD_TRACE_INFO, "  > Done_BP["<< layer_idx<<"]: "<<Simulator::Now().GetNanoSeconds() );
+    RecordEvent(layer_idx, HOROVOD_EVENT_BP_DONE);
     StartRingAllReduce(layer_idx);
 
     if(layer_idx != 0){
@@ -861,6 +866,7 @@ void HorovodWorker::ConnectionSucceeded(Ptr <Socket> socket) {
     NS_LOG_LOGIC("HorovodWorker Connection succeeded");
     WORKER;
     printf("  > HorovodWorker Connection succeeded\n");
+    HOROVOD_TRACE(HOROVOD_TRACE_INFO, "  > Connection succeeded, start BP for iter: "<< m_iteration_idx);
     m_connected = true;
 
     BackPropagationStart(m_num_layers-1);
@@ -872,6 +878,7 @@ void HorovodWorker::ConnectionFailed(Ptr <Socket> socket) {
     NS_LOG_LOGIC("HorovodWorker, Connection Failed");
     WORKER;
     printf("HorovodWorker Connection failed\n");
+    HOROVOD_TRACE(HOROVOD_TRACE_INFO, "  > Connection failed");
 
     m_connFailed = true;
     m_closedByError = false;
@@ -881,14 +888,8 @@ void HorovodWorker::ConnectionFailed(Ptr <Socket> socket) {
     m_send_socket = 0;
 }
 
-void HorovodWorker::RecordEvent(uint32_t layer_idx, std::string event){
-    // std::ofstream ofs;
-    // ofs.open(m_baseLogsDir + "/" + format_string("HorovodWorker_%" PRIu32 "_layer_%" PRIu32 "_port_%u_progress.txt", m_worker_id, m_num_layers, m_port),
-    // std::ofstream::out | std::ofstream::app);
-    // ofs << m_iteration_idx << "," << layer_idx << "," <<  event << ","<<Simulator::Now().GetNanoSeconds()<< std::endl;
-    // ofs.close(); 
-    std::string event_str = format_string("%d,%d,%s,%" PRId64 "\n", m_iteration_idx,layer_idx,event.c_str(),Simulator::Now().GetNanoSeconds());
-    m_event_strings.push_back(event_str);
+void HorovodWorker::RecordEvent(uint32_t layer_idx, HorovodEventType type, uint32_t partition_idx, uint8_t priority){
+    m_events.Add(Simulator::Now().GetNanoSeconds(), m_iteration_idx, layer_idx, type, partition_idx, priority);
 }
 
 
@@ -949,7 +950,6 @@ bool HorovodWorker::IsClosedByError() {
 }
 
 void HorovodWorker::SocketClosedNormal(Ptr <Socket> socket) {
-    DEBUG_MSG("SOCKET CLOSED NORMAL");
     std::cout<<"SOCKET CLOSED NORMAL"<<std::endl;
     m_completionTimeNs = Simulator::Now().GetNanoSeconds();
     m_connFailed = false;
@@ -965,7 +965,6 @@ void HorovodWorker::SocketClosedNormal(Ptr <Socket> socket) {
 }
 
 void HorovodWorker::SocketClosedError(Ptr <Socket> socket) {
-    DEBUG_MSG("SocketClosedError");
     std::cout<<"Worker ID: " << HorovodWorker::GetWorkerID()<<"SocketClosedError"<<std::endl;
 
     m_connFailed = false;
@@ -33,6 +33,8 @@
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/fusion-partition.h"
+#include "ns3/horovod-trace-buffer.h"
+#include "ns3/horovod-event-arena.h"
 #include "ns3/ptr.h"
 #include "ns3/socket.h"
 #include "ns3/traced-callback.h"
@@ -42,13 +44,6 @@
 #define ITERBARRIER 1
 
 
-#define DEBUG
-#ifdef DEBUG
-#define DEBUG_MSG(str) do {WORKER; std::cout << str << std::endl; } while( false )
-#else
-#define DEBUG_MSG(str) do { } while ( false )
-#endif
-
 namespace ns3 {
 
 // class Address;
@@ -135,6 +130,7 @@ class HorovodWorker : public Application {
   void SetNumWorkers(uint32_t num_workers);
   void SetFPComputeTime(std::map<int, float> compute_time);
   void SetBPComputeTime(std::map<int, float> compute_time);
+  void SetTraceBuffer(Ptr<HorovodTraceBuffer> trace_buffer);
 
   void SetInflightRingallreduceStatus(bool status){
     m_ringallreduce_inflight_status = status;
@@ -149,8 +145,8 @@ class HorovodWorker : public Application {
     return m_bytes_sent_vector;
   };
 
-  std::vector<std::string> & GetEventString(){
-    return m_event_strings; 
+  const HorovodEventArena & GetEventArena(){
+    return m_events;
   };
 
  protected:
@@ -250,7 +246,11 @@ class HorovodWorker : public Application {
   std::vector<uint64_t> m_bytes_sent_vector;
   std::vector<uint64_t> m_bytes_received_vector;
   std::uint32_t m_last_received_index = 0;
-  std::vector<std::string> m_event_strings;
+  HorovodEventArena m_events;  // Timeline events, formatted only when written
+
+  // Tracing (see HOROVOD_TRACE)
+  Ptr<HorovodTraceBuffer> m_trace_buffer;
+  HorovodTraceLevel m_trace_level = HOROVOD_TRACE_NONE;
 
  private:
   void ConnectionSucceeded(Ptr<Socket> socket);
@@ -270,7 +270,7 @@ class HorovodWorker : public Application {
   void DequeTransmission();
   void EnqueTransmission(RingAllReduce *ringallreduce);
   RingAllReduce *QueuePeek();
-  void RecordEvent(uint32_t layer_idx, std::string event);
+  void RecordEvent(uint32_t layer_idx, HorovodEventType type, uint32_t partition_idx = 0, uint8_t priority = 0);
   void Debug(std::string event);
   void DebugAll(std::string event);
   void InitializeLayerWeight();
@@ -280,13 +280,13 @@ class HorovodWorker : public Application {
   bool CheckAllPartitionSynced(uint32_t excluded_partition_idx){
     // excluded partition implicitly is at program 2(num_workers - 1)
     uint32_t max_progress = 2 * (m_num_workers - 1);
-    DEBUG_MSG("excluded_partition_idx "<< excluded_partition_idx);
+    HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, "excluded_partition_idx "<< excluded_partition_idx);
     for (uint32_t i=0; i< m_num_workers; ++i){
       uint32_t wrapped_around_partition_idx = (excluded_partition_idx + i) % m_num_workers;
       uint32_t progress = m_inflight_allreduce->GetPartitions()[wrapped_around_partition_idx]->GetProgress();
       if (progress != max_progress - i){
 
-        DEBUG_MSG(" Partition: "<<wrapped_around_partition_idx <<" not fully synced, at progress "
+        HOROVOD_TRACE(HOROVOD_TRACE_DEBUG, " Partition: "<<wrapped_around_partition_idx <<" not fully synced, at progress "
                                 <<progress <<" , expecting progress "
                                   << max_progress-i);
         return false;
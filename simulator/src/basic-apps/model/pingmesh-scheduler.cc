@@ -47,6 +47,23 @@ PingmeshScheduler::PingmeshScheduler(Ptr<BasicSimulation> basicSimulation, Ptr<T
     // Sort the pairs ascending such that we can do some spacing
     std::sort(m_pingmesh_endpoint_pairs.begin(), m_pingmesh_endpoint_pairs.end());
 
+    // Pairs of which every ping is retained and written to pingmesh.csv,
+    // of the others only the summary (pingmesh.txt) is kept (by default none are retained,
+    // such that the memory does not grow with the duration of the run)
+    std::string raw_sample_pairs_str = basicSimulation->GetConfigParamOrDefault("pingmesh_raw_sample_pairs", "none");
+    m_raw_samples_all_pairs = raw_sample_pairs_str == "all";
+    if (!m_raw_samples_all_pairs && raw_sample_pairs_str != "none") {
+        std::set<std::string> string_set = parse_set_string(raw_sample_pairs_str);
+        for (std::string s : string_set) {
+            std::vector<std::string> spl = split_string(s, "-", 2);
+            std::pair<int64_t, int64_t> pair = std::make_pair(parse_positive_int64(spl[0]), parse_positive_int64(spl[1]));
+            if (!std::binary_search(m_pingmesh_endpoint_pairs.begin(), m_pingmesh_endpoint_pairs.end(), pair)) {
+                throw std::invalid_argument(format_string("Pingmesh raw sample pair is not a pingmesh pair: %" PRId64 "-%" PRId64 "", pair.first, pair.second));
+            }
+            m_raw_sample_pairs.insert(pair);
+        }
+    }
+
 
 }
 
@@ -55,6 +72,7 @@ void PingmeshScheduler::Schedule() {
 
     // Info
     std::cout << "  > Ping interval: " << m_interval_ns << " ns" << std::endl;
+    std::cout << "  > Raw samples kept of: " << (m_raw_samples_all_pairs ? "all pairs" : std::to_string(m_raw_sample_pairs.size()) + " pair(s)") << std::endl;
 
     // Endpoints
     std::set<int64_t> endpoints = m_topology->GetEndpoints();
@@ -68,8 +86,8 @@ void PingmeshScheduler::Schedule() {
     }
     m_basicSimulation->RegisterTimestamp("Setup pingmesh servers");
 
-    // Install echo client from each node to each other node
-    std::cout << "  > Setting up " << m_pingmesh_endpoint_pairs.size() << " pingmesh clients" << std::endl;
+    // Install a single prober on each source node, which pings all its targets through one socket
+    // (the pairs are sorted, as such the targets of a source are consecutive and in ascending order)
     int64_t in_between_ns = m_interval_ns / (endpoints.size() - 1);
     int counter = 0;
     int64_t prev_i = -1;
@@ -78,24 +96,29 @@ void PingmeshScheduler::Schedule() {
         if (p.first != prev_i) {
             prev_i = p.first;
             counter = 0;
+
+            // Install it on the node and start it right now
+            Ptr<UdpRttProber> prober = CreateObject<UdpRttProber>();
+            prober->SetAttribute("Interval", TimeValue(NanoSeconds(m_interval_ns)));
+            prober->SetAttribute("RemotePort", UintegerValue(1025));
+            prober->SetAttribute("FromNodeId", UintegerValue(p.first));
+            m_nodes.Get(p.first)->AddApplication(prober);
+            prober->SetStartTime(Seconds(0.0));
+            m_probers.push_back(prober);
+
         }
 
-        // Helper to install the source application
-        UdpRttClientHelper source(
+        // Each target of a source is pinged staggered in between the others
+        m_probers.back()->AddTarget(
+                p.second,
                 m_nodes.Get(p.second)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal(),
-                1025,
-                p.first,
-                p.second
+                counter * in_between_ns,
+                m_raw_samples_all_pairs || m_raw_sample_pairs.find(p) != m_raw_sample_pairs.end()
         );
-        source.SetAttribute("Interval", TimeValue(NanoSeconds(m_interval_ns)));
-
-        // Install it on the node and start it right now
-        ApplicationContainer app = source.Install(m_nodes.Get(p.first));
-        app.Start(NanoSeconds(counter * in_between_ns));
-        m_apps.push_back(app);
 
         counter++;
     }
+    std::cout << "  > Set up " << m_probers.size() << " pingmesh probers for " << m_pingmesh_endpoint_pairs.size() << " pairs" << std::endl;
 
     std::cout << std::endl;
     m_basicSimulation->RegisterTimestamp("Setup pingmesh clients");
@@ -107,97 +130,72 @@ void PingmeshScheduler::WriteResults() {
     // Write to CSV and TXT
     FILE* file_csv = fopen((m_basicSimulation->GetLogsDir() + "/pingmesh.csv").c_str(), "w+");
     FILE* file_txt = fopen((m_basicSimulation->GetLogsDir() + "/pingmesh.txt").c_str(), "w+");
-    fprintf(file_txt, "%-10s%-10s%-22s%-22s%-16s%-16s%-16s%-16s%s\n",
+    fprintf(file_txt, "%-10s%-10s%-22s%-22s%-16s%-16s%-16s%-16s%-16s%-16s%-16s%s\n",
             "Source", "Target", "Mean latency there", "Mean latency back",
-            "Min. RTT", "Mean RTT", "Max. RTT", "Smp.std. RTT", "Reply arrival");
-    for (uint32_t i = 0; i < m_apps.size(); i++) {
-        Ptr<UdpRttClient> client = m_apps[i].Get(0)->GetObject<UdpRttClient>();
-
-        // Data about this pair
-        int64_t from_node_id = client->GetFromNodeId();
-        int64_t to_node_id = client->GetToNodeId();
-        uint32_t sent = client->GetSent();
-        std::vector<int64_t> sendRequestTimestamps = client->GetSendRequestTimestamps();
-        std::vector<int64_t> replyTimestamps = client->GetReplyTimestamps();
-        std::vector<int64_t> receiveReplyTimestamps = client->GetReceiveReplyTimestamps();
-
-        int total = 0;
-        double sum_latency_to_there_ns = 0.0;
-        double sum_latency_from_there_ns = 0.0;
-        std::vector<int64_t> rtts_ns;
-        for (uint32_t j = 0; j < sent; j++) {
-
-            // Outcome
-            bool reply_arrived = replyTimestamps[j] != -1;
-            std::string reply_arrived_str = reply_arrived ? "YES" : "LOST";
-
-            // Latencies
-            int64_t latency_to_there_ns = reply_arrived ? replyTimestamps[j] - sendRequestTimestamps[j] : -1;
-            int64_t latency_from_there_ns = reply_arrived ? receiveReplyTimestamps[j] - replyTimestamps[j] : -1;
-            int64_t rtt_ns = reply_arrived ? latency_to_there_ns + latency_from_there_ns : -1;
-
-            // Write plain to the csv
-            fprintf(
-                    file_csv,
-                    "%" PRId64 ",%" PRId64 ",%u,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%s\n",
-                    from_node_id, to_node_id, j, sendRequestTimestamps[j], replyTimestamps[j], receiveReplyTimestamps[j],
-                    latency_to_there_ns, latency_from_there_ns, rtt_ns, reply_arrived_str.c_str()
-            );
+            "Min. RTT", "Mean RTT", "Max. RTT", "Smp.std. RTT", "p50 RTT", "p99 RTT", "p99.9 RTT", "Reply arrival");
+    for (Ptr<UdpRttProber> prober : m_probers) {
+        for (uint32_t t = 0; t < prober->GetNumTargets(); t++) {
+
+            // Data about this pair
+            int64_t from_node_id = prober->GetFromNodeId();
+            int64_t to_node_id = prober->GetToNodeId(t);
+            const RttSummary& summary = prober->GetRttSummary(t);
+
+            // Every ping is only known if the raw samples are kept
+            if (prober->IsKeepingRawSamples(t)) {
+                uint32_t sent = prober->GetSent(t);
+                const std::vector<int64_t>& sendRequestTimestamps = prober->GetSendRequestTimestamps(t);
+                const std::vector<int64_t>& replyTimestamps = prober->GetReplyTimestamps(t);
+                const std::vector<int64_t>& receiveReplyTimestamps = prober->GetReceiveReplyTimestamps(t);
+                for (uint32_t j = 0; j < sent; j++) {
+
+                    // Outcome
+                    bool reply_arrived = replyTimestamps[j] != -1;
+                    std::string reply_arrived_str = reply_arrived ? "YES" : "LOST";
+
+                    // Latencies
+                    int64_t latency_to_there_ns = reply_arrived ? replyTimestamps[j] - sendRequestTimestamps[j] : -1;
+                    int64_t latency_from_there_ns = reply_arrived ? receiveReplyTimestamps[j] - replyTimestamps[j] : -1;
+                    int64_t rtt_ns = reply_arrived ? latency_to_there_ns + latency_from_there_ns : -1;
+
+                    // Write plain to the csv
+                    fprintf(
+                            file_csv,
+                            "%" PRId64 ",%" PRId64 ",%u,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%s\n",
+                            from_node_id, to_node_id, j, sendRequestTimestamps[j], replyTimestamps[j], receiveReplyTimestamps[j],
+                            latency_to_there_ns, latency_from_there_ns, rtt_ns, reply_arrived_str.c_str()
+                    );
 
-            // Add to statistics
-            if (reply_arrived) {
-                total++;
-                sum_latency_to_there_ns += latency_to_there_ns;
-                sum_latency_from_there_ns += latency_from_there_ns;
-                rtts_ns.push_back(rtt_ns);
+                }
             }
 
-        }
+            // Write nicely formatted to the text (the statistics are all -1 if no reply came through)
+            char str_latency_to_there_ms[100];
+            sprintf(str_latency_to_there_ms, "%.2f ms", nanosec_to_millisec(summary.GetMeanLatencyToThereNs()));
+            char str_latency_from_there_ms[100];
+            sprintf(str_latency_from_there_ms, "%.2f ms", nanosec_to_millisec(summary.GetMeanLatencyFromThereNs()));
+            char str_min_rtt_ms[100];
+            sprintf(str_min_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetMinRttNs()));
+            char str_mean_rtt_ms[100];
+            sprintf(str_mean_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetMeanRttNs()));
+            char str_max_rtt_ms[100];
+            sprintf(str_max_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetMaxRttNs()));
+            char str_sample_std_rtt_ms[100];
+            sprintf(str_sample_std_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetSampleStdRttNs()));
+            char str_p50_rtt_ms[100];
+            sprintf(str_p50_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetRttQuantileNs(0.5)));
+            char str_p99_rtt_ms[100];
+            sprintf(str_p99_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetRttQuantileNs(0.99)));
+            char str_p999_rtt_ms[100];
+            sprintf(str_p999_rtt_ms, "%.2f ms", nanosec_to_millisec(summary.GetRttQuantileNs(0.999)));
+            fprintf(
+                    file_txt, "%-10" PRId64 "%-10" PRId64 "%-22s%-22s%-16s%-16s%-16s%-16s%-16s%-16s%-16s%" PRId64 "/%" PRId64 " (%.0f%%)\n",
+                    from_node_id, to_node_id, str_latency_to_there_ms, str_latency_from_there_ms, str_min_rtt_ms, str_mean_rtt_ms, str_max_rtt_ms, str_sample_std_rtt_ms,
+                    str_p50_rtt_ms, str_p99_rtt_ms, str_p999_rtt_ms,
+                    summary.GetNumReplies(), summary.GetNumSent(), ((double) summary.GetNumReplies() / (double) summary.GetNumSent()) * 100.0
+            );
 
-        // Finalize the statistics
-        int64_t min_rtt_ns = 10000000000000; // 10000s should be sufficiently high
-        int64_t max_rtt_ns = -1;
-        double mean_rtt_ns = (sum_latency_to_there_ns + sum_latency_from_there_ns) / total;
-        double sum_sq = 0.0;
-        for (uint32_t j = 0; j < rtts_ns.size(); j++) {
-            min_rtt_ns = std::min(min_rtt_ns, rtts_ns[j]);
-            max_rtt_ns = std::max(max_rtt_ns, rtts_ns[j]);
-            sum_sq += std::pow(rtts_ns[j] - mean_rtt_ns, 2);
         }
-        double sample_std_rtt_ns;
-        double mean_latency_to_there_ns;
-        double mean_latency_from_there_ns;
-        if (rtts_ns.size() == 0) { // If no measurements came through, it should all be -1
-            mean_latency_to_there_ns = -1;
-            mean_latency_from_there_ns = -1;
-            min_rtt_ns = -1;
-            max_rtt_ns = -1;
-            mean_rtt_ns = -1;
-            sample_std_rtt_ns = -1;
-        } else {
-            mean_latency_to_there_ns = sum_latency_to_there_ns / total;
-            mean_latency_from_there_ns = sum_latency_from_there_ns / total;
-            sample_std_rtt_ns = rtts_ns.size() > 1 ? std::sqrt((1.0 / (rtts_ns.size() - 1)) * sum_sq) : 0.0;
-        }
-
-        // Write nicely formatted to the text
-        char str_latency_to_there_ms[100];
-        sprintf(str_latency_to_there_ms, "%.2f ms", nanosec_to_millisec(mean_latency_to_there_ns));
-        char str_latency_from_there_ms[100];
-        sprintf(str_latency_from_there_ms, "%.2f ms", nanosec_to_millisec(mean_latency_from_there_ns));
-        char str_min_rtt_ms[100];
-        sprintf(str_min_rtt_ms, "%.2f ms", nanosec_to_millisec(min_rtt_ns));
-        char str_mean_rtt_ms[100];
-        sprintf(str_mean_rtt_ms, "%.2f ms", nanosec_to_millisec(mean_rtt_ns));
-        char str_max_rtt_ms[100];
-        sprintf(str_max_rtt_ms, "%.2f ms", nanosec_to_millisec(max_rtt_ns));
-        char str_sample_std_rtt_ms[100];
-        sprintf(str_sample_std_rtt_ms, "%.2f ms", nanosec_to_millisec(sample_std_rtt_ns));
-        fprintf(
-                file_txt, "%-10" PRId64 "%-10" PRId64 "%-22s%-22s%-16s%-16s%-16s%-16s%d/%d (%.0f%%)\n",
-                from_node_id, to_node_id, str_latency_to_there_ms, str_latency_from_there_ms, str_min_rtt_ms, str_mean_rtt_ms, str_max_rtt_ms, str_sample_std_rtt_ms, total, sent, ((double) total / (double) sent) * 100.0
-        );
-
     }
     fclose(file_csv);
     fclose(file_txt);
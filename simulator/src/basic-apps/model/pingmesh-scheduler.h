@@ -30,6 +30,7 @@
 #include "ns3/topology.h"
 #include "ns3/udp-rtt-helper.h"
 #include "ns3/udp-rtt-client.h"
+#include "ns3/udp-rtt-prober.h"
 #include "ns3/udp-rtt-server.h"
 
 using namespace ns3;
@@ -49,9 +50,11 @@ protected:
     int64_t m_simulation_end_time_ns;
     Ptr<Topology> m_topology = nullptr;
     NodeContainer m_nodes;
-    std::vector<ApplicationContainer> m_apps;
+    std::vector<Ptr<UdpRttProber>> m_probers; // One per source node, in ascending order
     int64_t m_interval_ns;
     std::vector<std::pair<int64_t, int64_t>> m_pingmesh_endpoint_pairs;
+    bool m_raw_samples_all_pairs;
+    std::set<std::pair<int64_t, int64_t>> m_raw_sample_pairs;
 
 };
 
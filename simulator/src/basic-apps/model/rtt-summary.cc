@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "rtt-summary.h"
+
+namespace ns3 {
+
+QuantileSketch::QuantileSketch(double relative_accuracy) {
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        throw std::invalid_argument(format_string("Quantile sketch relative accuracy must be in (0, 1): %f", relative_accuracy));
+    }
+    m_relative_accuracy = relative_accuracy;
+    m_gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    m_log_gamma = std::log(m_gamma);
+    m_bucket_offset = 0;
+    m_zero_count = 0;
+    m_count = 0;
+}
+
+void QuantileSketch::Grow(int32_t bucket) {
+    if (m_buckets.empty()) {
+        m_bucket_offset = bucket;
+        m_buckets.resize(1, 0);
+    } else if (bucket < m_bucket_offset) {
+        m_buckets.insert(m_buckets.begin(), m_bucket_offset - bucket, 0);
+        m_bucket_offset = bucket;
+    } else if (bucket >= m_bucket_offset + (int32_t) m_buckets.size()) {
+        m_buckets.resize(bucket - m_bucket_offset + 1, 0);
+    }
+}
+
+void QuantileSketch::Add(double value) {
+    if (value <= 0.0) {
+        m_zero_count++;
+    } else {
+        int32_t bucket = (int32_t) std::ceil(std::log(value) / m_log_gamma);
+        Grow(bucket);
+        m_buckets[bucket - m_bucket_offset]++;
+    }
+    m_count++;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+    if (other.m_relative_accuracy != m_relative_accuracy) {
+        throw std::invalid_argument("Only quantile sketches of the same relative accuracy can be merged");
+    }
+    if (!other.m_buckets.empty()) {
+        Grow(other.m_bucket_offset);
+        Grow(other.m_bucket_offset + (int32_t) other.m_buckets.size() - 1);
+        for (size_t i = 0; i < other.m_buckets.size(); i++) {
+            m_buckets[other.m_bucket_offset + i - m_bucket_offset] += other.m_buckets[i];
+        }
+    }
+    m_zero_count += other.m_zero_count;
+    m_count += other.m_count;
+}
+
+double QuantileSketch::GetQuantile(double q) const {
+    if (m_count == 0) {
+        throw std::runtime_error("Cannot retrieve a quantile of an empty quantile sketch");
+    }
+    if (q < 0.0 || q > 1.0) {
+        throw std::invalid_argument(format_string("Quantile must be in [0, 1]: %f", q));
+    }
+    int64_t rank = (int64_t) (q * (m_count - 1));
+    if (rank < m_zero_count) {
+        return 0.0;
+    }
+    int64_t seen = m_zero_count;
+    size_t i = 0;
+    while (seen + m_buckets[i] <= rank) {
+        seen += m_buckets[i];
+        i++;
+    }
+
+    // Every value x in bucket b has gamma^(b - 1) < x <= gamma^b, of which this is within the relative accuracy
+    return 2.0 * std::pow(m_gamma, (double) (m_bucket_offset + (int32_t) i)) / (m_gamma + 1.0);
+}
+
+int64_t QuantileSketch::GetCount() const {
+    return m_count;
+}
+
+int64_t QuantileSketch::GetNumBuckets() const {
+    return m_buckets.size();
+}
+
+double QuantileSketch::GetRelativeAccuracy() const {
+    return m_relative_accuracy;
+}
+
+constexpr double RttSummary::RTT_QUANTILE_RELATIVE_ACCURACY;
+
+RttSummary::RttSummary() : m_rtt_sketch(RTT_QUANTILE_RELATIVE_ACCURACY) {
+    m_num_sent = 0;
+    m_num_replies = 0;
+    m_sum_latency_to_there_ns = 0.0;
+    m_sum_latency_from_there_ns = 0.0;
+    m_min_rtt_ns = INT64_MAX;
+    m_max_rtt_ns = INT64_MIN;
+    m_mean_rtt_ns = 0.0;
+    m_m2_rtt_ns = 0.0;
+}
+
+void RttSummary::RecordSent() {
+    m_num_sent++;
+}
+
+void RttSummary::RecordReply(int64_t latency_to_there_ns, int64_t latency_from_there_ns) {
+    int64_t rtt_ns = latency_to_there_ns + latency_from_there_ns;
+    m_num_replies++;
+    m_sum_latency_to_there_ns += latency_to_there_ns;
+    m_sum_latency_from_there_ns += latency_from_there_ns;
+    m_min_rtt_ns = std::min(m_min_rtt_ns, rtt_ns);
+    m_max_rtt_ns = std::max(m_max_rtt_ns, rtt_ns);
+    double delta = rtt_ns - m_mean_rtt_ns;
+    m_mean_rtt_ns += delta / m_num_replies;
+    m_m2_rtt_ns += delta * (rtt_ns - m_mean_rtt_ns);
+    m_rtt_sketch.Add(rtt_ns);
+}
+
+void RttSummary::Merge(const RttSummary& other) {
+    if (other.m_num_replies > 0) {
+
+        // Combined mean and sum of squared differences (Chan et al.)
+        int64_t num_replies = m_num_replies + other.m_num_replies;
+        double delta = other.m_mean_rtt_ns - m_mean_rtt_ns;
+        m_m2_rtt_ns += other.m_m2_rtt_ns + delta * delta * ((double) m_num_replies * other.m_num_replies / num_replies);
+        m_mean_rtt_ns += delta * other.m_num_replies / num_replies;
+        m_num_replies = num_replies;
+
+        m_sum_latency_to_there_ns += other.m_sum_latency_to_there_ns;
+        m_sum_latency_from_there_ns += other.m_sum_latency_from_there_ns;
+        m_min_rtt_ns = std::min(m_min_rtt_ns, other.m_min_rtt_ns);
+        m_max_rtt_ns = std::max(m_max_rtt_ns, other.m_max_rtt_ns);
+        m_rtt_sketch.Merge(other.m_rtt_sketch);
+
+    }
+    m_num_sent += other.m_num_sent;
+}
+
+int64_t RttSummary::GetNumSent() const {
+    return m_num_sent;
+}
+
+int64_t RttSummary::GetNumReplies() const {
+    return m_num_replies;
+}
+
+int64_t RttSummary::GetNumLost() const {
+    return m_num_sent - m_num_replies;
+}
+
+double RttSummary::GetMeanLatencyToThereNs() const {
+    return m_num_replies == 0 ? -1 : m_sum_latency_to_there_ns / m_num_replies;
+}
+
+double RttSummary::GetMeanLatencyFromThereNs() const {
+    return m_num_replies == 0 ? -1 : m_sum_latency_from_there_ns / m_num_replies;
+}
+
+int64_t RttSummary::GetMinRttNs() const {
+    return m_num_replies == 0 ? -1 : m_min_rtt_ns;
+}
+
+int64_t RttSummary::GetMaxRttNs() const {
+    return m_num_replies == 0 ? -1 : m_max_rtt_ns;
+}
+
+double RttSummary::GetMeanRttNs() const {
+    return m_num_replies == 0 ? -1 : m_mean_rtt_ns;
+}
+
+double RttSummary::GetSampleStdRttNs() const {
+    if (m_num_replies == 0) {
+        return -1;
+    }
+    return m_num_replies > 1 ? std::sqrt(m_m2_rtt_ns / (m_num_replies - 1)) : 0.0;
+}
+
+double RttSummary::GetRttQuantileNs(double q) const {
+    if (m_num_replies == 0) {
+        return -1;
+    }
+
+    // The lowest and highest rank are known exactly, and the others can be no further out than those
+    int64_t rank = (int64_t) (q * (m_num_replies - 1));
+    if (rank == 0) {
+        return m_min_rtt_ns;
+    } else if (rank == m_num_replies - 1) {
+        return m_max_rtt_ns;
+    }
+    return std::min((double) m_max_rtt_ns, std::max((double) m_min_rtt_ns, m_rtt_sketch.GetQuantile(q)));
+}
+
+} // namespace ns3
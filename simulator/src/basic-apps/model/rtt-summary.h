@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef RTT_SUMMARY_H
+#define RTT_SUMMARY_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cinttypes>
+#include "ns3/exp-util.h"
+
+namespace ns3 {
+
+/**
+ * Streaming quantile sketch with a relative error guarantee (as DDSketch, Masson et al., 2019).
+ *
+ * Each positive value x goes into bucket ceil(log_gamma(x)) with gamma = (1 + a) / (1 - a),
+ * of which the representative value is within relative accuracy a of every value in it.
+ * The buckets are a dense array from the lowest to the highest bucket in use, as such
+ * its size only depends on the ratio between the highest and lowest value (e.g., ~600 buckets
+ * for 1 us to 1 s with a = 1%), not on the number of values. Sketches of the same
+ * accuracy can be merged, which is the same as if all values were added to one.
+ */
+class QuantileSketch
+{
+public:
+
+  /**
+   * Create an empty sketch.
+   *
+   * @param relative_accuracy   Relative accuracy a of the quantiles (0 < a < 1)
+   */
+  QuantileSketch(double relative_accuracy);
+
+  void Add(double value);
+  void Merge(const QuantileSketch& other);
+
+  /**
+   * Value at quantile q, i.e., the value of rank floor(q * (count - 1)) in ascending order,
+   * within the relative accuracy.
+   *
+   * @param q   Quantile (0 <= q <= 1)
+   *
+   * @return Value at the quantile (the sketch must not be empty)
+   */
+  double GetQuantile(double q) const;
+
+  int64_t GetCount() const;
+  int64_t GetNumBuckets() const;
+  double GetRelativeAccuracy() const;
+
+private:
+  double m_relative_accuracy;
+  double m_gamma;
+  double m_log_gamma;
+
+  // Buckets m_bucket_offset, ..., m_bucket_offset + m_buckets.size() - 1
+  std::vector<int64_t> m_buckets;
+  int32_t m_bucket_offset;
+
+  // Values which are not positive
+  int64_t m_zero_count;
+  int64_t m_count;
+
+  void Grow(int32_t bucket);
+};
+
+/**
+ * Streaming summary of the pings from one node to another: the number sent and replied,
+ * the minimum, maximum, mean and variance of the RTT (Welford), the mean latencies there
+ * and back, and a quantile sketch of the RTT. Its size does not depend on the number of pings.
+ */
+class RttSummary
+{
+public:
+
+  // Relative accuracy of the RTT quantiles
+  static constexpr double RTT_QUANTILE_RELATIVE_ACCURACY = 0.005;
+
+  RttSummary();
+
+  void RecordSent();
+  void RecordReply(int64_t latency_to_there_ns, int64_t latency_from_there_ns);
+  void Merge(const RttSummary& other);
+
+  int64_t GetNumSent() const;
+  int64_t GetNumReplies() const;
+  int64_t GetNumLost() const;
+
+  // Statistics of the replies, which are all -1 if there are no replies
+  double GetMeanLatencyToThereNs() const;
+  double GetMeanLatencyFromThereNs() const;
+  int64_t GetMinRttNs() const;
+  int64_t GetMaxRttNs() const;
+  double GetMeanRttNs() const;
+  double GetSampleStdRttNs() const;
+  double GetRttQuantileNs(double q) const;
+
+private:
+  int64_t m_num_sent;
+  int64_t m_num_replies;
+  double m_sum_latency_to_there_ns;
+  double m_sum_latency_from_there_ns;
+  int64_t m_min_rtt_ns;
+  int64_t m_max_rtt_ns;
+  double m_mean_rtt_ns;
+  double m_m2_rtt_ns;
+  QuantileSketch m_rtt_sketch;
+};
+
+} // namespace ns3
+
+#endif /* RTT_SUMMARY_H */
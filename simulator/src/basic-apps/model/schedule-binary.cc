@@ -0,0 +1,273 @@
+#include "schedule-binary.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace ns3 {
+
+#define SCHEDULE_BINARY_FILE_MAGIC "FSCHED01"
+#define SCHEDULE_BINARY_FILE_BYTE_ORDER 0x01020304
+
+typedef struct schedule_binary_file_header {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t record_size_byte;
+    int64_t num_entries;
+    int64_t num_strings;
+    uint64_t string_data_size_byte;
+} schedule_binary_file_header_t;
+
+NS_OBJECT_ENSURE_REGISTERED (ScheduleBinary);
+TypeId ScheduleBinary::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::ScheduleBinary")
+            .SetParent<Object> ()
+            .SetGroupName("BasicApps")
+    ;
+    return tid;
+}
+
+ScheduleBinary::ScheduleBinary(const std::string& filename, Ptr<Topology> topology, const int64_t simulation_end_time_ns) {
+    m_mapped = nullptr;
+    m_mapped_size_byte = 0;
+
+    // Map the file
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error(format_string("File %s could not be read.", filename.c_str()));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(schedule_binary_file_header_t)) {
+        close(fd);
+        throw std::runtime_error(format_string("Binary schedule file %s is too small.", filename.c_str()));
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error(format_string("Binary schedule file %s could not be memory-mapped.", filename.c_str()));
+    }
+    m_mapped = mapped;
+    m_mapped_size_byte = info.st_size;
+
+    // Validate the header and the size
+    const schedule_binary_file_header_t* header = (const schedule_binary_file_header_t*) mapped;
+    if (std::memcmp(header->magic, SCHEDULE_BINARY_FILE_MAGIC, 8) != 0
+        || header->byte_order != SCHEDULE_BINARY_FILE_BYTE_ORDER
+        || header->record_size_byte != sizeof(schedule_binary_record_t)) {
+        Unmap();
+        throw std::runtime_error(format_string("Binary schedule file %s has an invalid header.", filename.c_str()));
+    }
+    m_num_entries = header->num_entries;
+    m_num_strings = header->num_strings;
+    if (m_num_entries < 0 || m_num_strings < 1
+        || sizeof(schedule_binary_file_header_t)
+           + m_num_entries * sizeof(schedule_binary_record_t)
+           + (m_num_strings + 1) * sizeof(uint64_t)
+           + header->string_data_size_byte != m_mapped_size_byte) {
+        Unmap();
+        throw std::runtime_error(format_string("Binary schedule file %s does not have the size indicated by its header.", filename.c_str()));
+    }
+
+    // The arrays are within the mapping
+    const char* data = (const char*) mapped + sizeof(schedule_binary_file_header_t);
+    m_records = (const schedule_binary_record_t*) data;
+    data += m_num_entries * sizeof(schedule_binary_record_t);
+    m_string_offsets = (const uint64_t*) data;
+    data += (m_num_strings + 1) * sizeof(uint64_t);
+    m_string_data = data;
+
+    // String table must be consistent
+    if (m_string_offsets[0] != 0 || m_string_offsets[1] != 0 || m_string_offsets[m_num_strings] != header->string_data_size_byte) {
+        Unmap();
+        throw std::runtime_error(format_string("Binary schedule file %s has an inconsistent string table.", filename.c_str()));
+    }
+    for (int64_t s = 0; s < m_num_strings; s++) {
+        if (m_string_offsets[s] > m_string_offsets[s + 1]) {
+            Unmap();
+            throw std::runtime_error(format_string("Binary schedule file %s has an inconsistent string table.", filename.c_str()));
+        }
+    }
+
+    // Check each entry the same way as a schedule.csv line (the strings are not needed for that)
+    try {
+        int64_t prev_start_time_ns = 0;
+        schedule_entry_t entry = {};
+        for (int64_t i = 0; i < m_num_entries; i++) {
+            const schedule_binary_record_t& record = m_records[i];
+            if (record.from_node_id < 0 || record.to_node_id < 0 || record.size_byte < 0 || record.start_time_ns < 0) {
+                throw std::invalid_argument(format_string("Negative value in binary schedule entry with flow ID: %" PRId64 ".", record.flow_id));
+            }
+            if (record.additional_parameters_idx >= m_num_strings || record.metadata_idx >= m_num_strings) {
+                throw std::invalid_argument(format_string("Invalid string index in binary schedule entry with flow ID: %" PRId64 ".", record.flow_id));
+            }
+            entry.flow_id = record.flow_id;
+            entry.from_node_id = record.from_node_id;
+            entry.to_node_id = record.to_node_id;
+            entry.size_byte = record.size_byte;
+            entry.start_time_ns = record.start_time_ns;
+            check_schedule_entry(entry, i, prev_start_time_ns, topology, simulation_end_time_ns);
+            prev_start_time_ns = entry.start_time_ns;
+        }
+    } catch (...) {
+        Unmap();
+        throw;
+    }
+
+}
+
+ScheduleBinary::~ScheduleBinary() {
+    Unmap();
+}
+
+void ScheduleBinary::Unmap() {
+    if (m_mapped != nullptr) {
+        munmap(m_mapped, m_mapped_size_byte);
+        m_mapped = nullptr;
+    }
+}
+
+std::string ScheduleBinary::GetString(uint32_t idx) const {
+    return std::string(m_string_data + m_string_offsets[idx], m_string_offsets[idx + 1] - m_string_offsets[idx]);
+}
+
+int64_t ScheduleBinary::GetNumEntries() {
+    return m_num_entries;
+}
+
+schedule_entry_t ScheduleBinary::GetEntry(int64_t i) {
+    if (i < 0 || i >= m_num_entries) {
+        throw std::out_of_range(format_string("Schedule entry %" PRId64 " does not exist.", i));
+    }
+    const schedule_binary_record_t& record = m_records[i];
+    schedule_entry_t entry;
+    entry.flow_id = record.flow_id;
+    entry.from_node_id = record.from_node_id;
+    entry.to_node_id = record.to_node_id;
+    entry.size_byte = record.size_byte;
+    entry.start_time_ns = record.start_time_ns;
+    entry.additional_parameters = GetString(record.additional_parameters_idx);
+    entry.metadata = GetString(record.metadata_idx);
+    return entry;
+}
+
+size_t ScheduleBinary::GetFileSizeByte() {
+    return m_mapped_size_byte;
+}
+
+/**
+ * Check whether a schedule file is in the binary format (else it is a schedule.csv).
+ *
+ * @param filename  Schedule file name
+ *
+ * @return True iff it starts with the binary schedule magic
+ */
+bool is_binary_schedule(const std::string& filename) {
+    char magic[8] = {};
+    std::ifstream ifs(filename, std::ifstream::binary);
+    ifs.read(magic, 8);
+    return ifs.gcount() == 8 && std::memcmp(magic, SCHEDULE_BINARY_FILE_MAGIC, 8) == 0;
+}
+
+/**
+ * Convert a schedule.csv into the binary schedule format.
+ *
+ * The lines are streamed, as such only the distinct strings are kept in memory.
+ * All checks which do not need the topology or simulation end time are already done here.
+ *
+ * @param csv_filename      Schedule.csv file name
+ * @param binary_filename   Binary schedule file name to write to
+ *
+ * @return Number of entries converted
+ */
+int64_t convert_schedule_csv_to_binary(const std::string& csv_filename, const std::string& binary_filename) {
+
+    // Input
+    std::ifstream csv_file(csv_filename);
+    if (!csv_file) {
+        throw std::runtime_error(format_string("File %s could not be read.", csv_filename.c_str()));
+    }
+
+    // Output (written to a temporary file unique to this process first)
+    std::string temp_filename = format_string("%s.%d.tmp", binary_filename.c_str(), (int) getpid());
+    std::ofstream ofs(temp_filename, std::ofstream::binary);
+    if (!ofs) {
+        throw std::runtime_error(format_string("Binary schedule file %s could not be written.", temp_filename.c_str()));
+    }
+    schedule_binary_file_header_t header = {};
+    std::memcpy(header.magic, SCHEDULE_BINARY_FILE_MAGIC, 8);
+    header.byte_order = SCHEDULE_BINARY_FILE_BYTE_ORDER;
+    header.record_size_byte = sizeof(schedule_binary_record_t);
+    ofs.write((const char*) &header, sizeof(header));
+
+    // Distinct strings (index 0 is the empty string)
+    std::unordered_map<std::string, uint32_t> string_to_idx;
+    std::vector<uint64_t> string_offsets;
+    std::string string_data;
+    string_to_idx[""] = 0;
+    string_offsets.push_back(0);
+    string_offsets.push_back(0);
+
+    // Stream the lines into records
+    try {
+        std::string line;
+        int64_t line_counter = 0;
+        int64_t prev_start_time_ns = 0;
+        while (getline(csv_file, line)) {
+            schedule_entry_t entry = parse_schedule_line(line);
+            check_schedule_entry(entry, line_counter, prev_start_time_ns, nullptr, INT64_MAX);
+            prev_start_time_ns = entry.start_time_ns;
+            if (entry.from_node_id > INT32_MAX || entry.to_node_id > INT32_MAX) {
+                throw std::invalid_argument(format_string("Node ID out of range for the binary schedule in flow ID: %" PRId64 ".", entry.flow_id));
+            }
+            schedule_binary_record_t record = {};
+            record.flow_id = entry.flow_id;
+            record.start_time_ns = entry.start_time_ns;
+            record.size_byte = entry.size_byte;
+            record.from_node_id = (int32_t) entry.from_node_id;
+            record.to_node_id = (int32_t) entry.to_node_id;
+            for (int s = 0; s < 2; s++) {
+                const std::string& str = s == 0 ? entry.additional_parameters : entry.metadata;
+                auto it = string_to_idx.find(str);
+                uint32_t idx;
+                if (it == string_to_idx.end()) {
+                    idx = string_to_idx.size();
+                    string_to_idx[str] = idx;
+                    string_data += str;
+                    string_offsets.push_back(string_data.size());
+                } else {
+                    idx = it->second;
+                }
+                (s == 0 ? record.additional_parameters_idx : record.metadata_idx) = idx;
+            }
+            ofs.write((const char*) &record, sizeof(record));
+            line_counter++;
+        }
+        header.num_entries = line_counter;
+    } catch (...) {
+        ofs.close();
+        remove_file_if_exists(temp_filename);
+        throw;
+    }
+
+    // String table, and finally the header now that the counts are known
+    header.num_strings = string_to_idx.size();
+    header.string_data_size_byte = string_data.size();
+    ofs.write((const char*) string_offsets.data(), string_offsets.size() * sizeof(uint64_t));
+    ofs.write(string_data.data(), string_data.size());
+    ofs.seekp(0);
+    ofs.write((const char*) &header, sizeof(header));
+    ofs.close();
+    if (!ofs || std::rename(temp_filename.c_str(), binary_filename.c_str()) != 0) {
+        remove_file_if_exists(temp_filename);
+        throw std::runtime_error(format_string("Binary schedule file %s could not be written.", binary_filename.c_str()));
+    }
+    return header.num_entries;
+
+}
+
+}
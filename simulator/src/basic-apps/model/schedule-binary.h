@@ -0,0 +1,80 @@
+#ifndef SCHEDULE_BINARY_H
+#define SCHEDULE_BINARY_H
+
+#include <string>
+#include <vector>
+#include <cinttypes>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/topology.h"
+#include "ns3/schedule-reader.h"
+
+namespace ns3 {
+
+/**
+ * Fixed-size record of a schedule entry in the binary schedule format.
+ * The two strings are indices into the string table of the file, in which
+ * each distinct string is only stored once (index 0 is the empty string).
+ */
+typedef struct schedule_binary_record {
+    int64_t flow_id;
+    int64_t start_time_ns;
+    int64_t size_byte;
+    int32_t from_node_id;
+    int32_t to_node_id;
+    uint32_t additional_parameters_idx;
+    uint32_t metadata_idx;
+} schedule_binary_record_t;
+
+/**
+ * Binary schedule, which is memory-mapped instead of read.
+ *
+ * The file is a header, followed by a record per entry (in order), followed by
+ * the string table: (num_strings + 1) uint64 offsets into the string data, and the string data.
+ * It is written by convert_schedule_csv_to_binary() from a schedule.csv.
+ *
+ * All entries are checked when the file is mapped, with the same rules as the schedule.csv,
+ * but an entry is only turned into a schedule_entry_t when it is requested.
+ */
+class ScheduleBinary : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Map and check a binary schedule.
+     *
+     * @param filename                  Binary schedule file
+     * @param topology                  Topology
+     * @param simulation_end_time_ns    Simulation end time (ns) : all flows must start less than this value
+     */
+    ScheduleBinary(const std::string& filename, Ptr<Topology> topology, const int64_t simulation_end_time_ns);
+    ~ScheduleBinary();
+
+    // Accessors
+    int64_t GetNumEntries();
+    schedule_entry_t GetEntry(int64_t i);
+    inline int64_t GetStartTimeNs(int64_t i) const {
+        return m_records[i].start_time_ns;
+    }
+    size_t GetFileSizeByte();
+
+private:
+    std::string GetString(uint32_t idx) const;
+    void Unmap();
+
+    void* m_mapped;
+    size_t m_mapped_size_byte;
+    int64_t m_num_entries;
+    int64_t m_num_strings;
+    const schedule_binary_record_t* m_records;
+    const uint64_t* m_string_offsets;
+    const char* m_string_data;
+};
+
+bool is_binary_schedule(const std::string& filename);
+int64_t convert_schedule_csv_to_binary(const std::string& csv_filename, const std::string& binary_filename);
+
+}
+
+#endif //SCHEDULE_BINARY_H
@@ -1,9 +1,81 @@
 #include "schedule-reader.h"
+#include "schedule-binary.h"
 
 namespace ns3 {
 
 /**
- * Read the schedule.csv into a schedule.
+ * Parse a line of the schedule.csv into a schedule entry.
+ *
+ * @param line      Line (flow_id,from_node_id,to_node_id,size_byte,start_time_ns,additional_parameters,metadata)
+ *
+ * @return Schedule entry
+ */
+schedule_entry_t parse_schedule_line(const std::string& line) {
+
+    // Split on ,
+    std::vector<std::string> comma_split = split_string(line, ",", 7);
+
+    // Fill entry
+    schedule_entry_t entry = {};
+    entry.flow_id = parse_positive_int64(comma_split[0]);
+    entry.from_node_id = parse_positive_int64(comma_split[1]);
+    entry.to_node_id = parse_positive_int64(comma_split[2]);
+    entry.size_byte = parse_positive_int64(comma_split[3]);
+    entry.start_time_ns = parse_positive_int64(comma_split[4]);
+    entry.additional_parameters = comma_split[5];
+    entry.metadata = comma_split[6];
+    return entry;
+
+}
+
+/**
+ * Check a schedule entry, the same way for any schedule format.
+ *
+ * @param entry                     Schedule entry
+ * @param expected_flow_id          Flow ID it must have (its position in the schedule)
+ * @param prev_start_time_ns        Start time (ns) of the previous entry (0 if it is the first)
+ * @param topology                  Topology (if nullptr, the endpoints are not checked against it)
+ * @param simulation_end_time_ns    Simulation end time (ns) : all flows must start less than this value
+ */
+void check_schedule_entry(const schedule_entry_t& entry, int64_t expected_flow_id, int64_t prev_start_time_ns, Ptr<Topology> topology, const int64_t simulation_end_time_ns) {
+
+    // Flow ID must be ascending by one
+    if (entry.flow_id != expected_flow_id) {
+        throw std::invalid_argument(format_string("Flow ID is not ascending by one each line (violation: %" PRId64 ")\n", entry.flow_id));
+    }
+
+    // Must be weakly ascending start time
+    if (prev_start_time_ns > entry.start_time_ns) {
+        throw std::invalid_argument(format_string("Start time is not weakly ascending (on line with flow ID: %" PRId64 ", violation: %" PRId64 ")\n", entry.flow_id, entry.start_time_ns));
+    }
+
+    // Check node IDs
+    if (entry.from_node_id == entry.to_node_id) {
+        throw std::invalid_argument(format_string("Flow to itself at node ID: %" PRId64 ".", entry.to_node_id));
+    }
+
+    // Check endpoint validity
+    if (topology != nullptr) {
+        if (!topology->IsValidEndpoint(entry.from_node_id)) {
+            throw std::invalid_argument(format_string("Invalid from-endpoint for a schedule entry based on topology: %d", entry.from_node_id));
+        }
+        if (!topology->IsValidEndpoint(entry.to_node_id)) {
+            throw std::invalid_argument(format_string("Invalid to-endpoint for a schedule entry based on topology: %d", entry.to_node_id));
+        }
+    }
+
+    // Check start time
+    if (entry.start_time_ns >= simulation_end_time_ns) {
+        throw std::invalid_argument(format_string(
+                "Flow %" PRId64 " has invalid start time %" PRId64 " >= %" PRId64 ".",
+                entry.flow_id, entry.start_time_ns, simulation_end_time_ns
+        ));
+    }
+
+}
+
+/**
+ * Read the schedule.csv (or its binary form, see ScheduleBinary) into a schedule.
  *
  * @param filename                  File name of the schedule.csv
  * @param topology                  Topology
@@ -19,6 +91,16 @@ std::vector<schedule_entry_t> read_schedule(const std::string& filename, Ptr<Top
         throw std::runtime_error(format_string("File %s does not exist.", filename.c_str()));
     }
 
+    // Binary schedule is already checked when it is mapped
+    if (is_binary_schedule(filename)) {
+        Ptr<ScheduleBinary> binary = CreateObject<ScheduleBinary>(filename, topology, simulation_end_time_ns);
+        schedule.reserve(binary->GetNumEntries());
+        for (int64_t i = 0; i < binary->GetNumEntries(); i++) {
+            schedule.push_back(binary->GetEntry(i));
+        }
+        return schedule;
+    }
+
     // Open file
     std::string line;
     std::ifstream schedule_file(filename);
@@ -29,49 +111,11 @@ std::vector<schedule_entry_t> read_schedule(const std::string& filename, Ptr<Top
         int64_t prev_start_time_ns = 0;
         while (getline(schedule_file, line)) {
 
-            // Split on ,
-            std::vector<std::string> comma_split = split_string(line, ",", 7);
-
-            // Fill entry
-            schedule_entry_t entry = {};
-            entry.flow_id = parse_positive_int64(comma_split[0]);
-            if (entry.flow_id != (int64_t) line_counter) {
-                throw std::invalid_argument(format_string("Flow ID is not ascending by one each line (violation: %" PRId64 ")\n", entry.flow_id));
-            }
-            entry.from_node_id = parse_positive_int64(comma_split[1]);
-            entry.to_node_id = parse_positive_int64(comma_split[2]);
-            entry.size_byte = parse_positive_int64(comma_split[3]);
-            entry.start_time_ns = parse_positive_int64(comma_split[4]);
-            entry.additional_parameters = comma_split[5];
-            entry.metadata = comma_split[6];
-
-            // Must be weakly ascending start time
-            if (prev_start_time_ns > entry.start_time_ns) {
-                throw std::invalid_argument(format_string("Start time is not weakly ascending (on line with flow ID: %" PRId64 ", violation: %" PRId64 ")\n", entry.flow_id, entry.start_time_ns));
-            }
+            // Parse and check entry
+            schedule_entry_t entry = parse_schedule_line(line);
+            check_schedule_entry(entry, line_counter, prev_start_time_ns, topology, simulation_end_time_ns);
             prev_start_time_ns = entry.start_time_ns;
 
-            // Check node IDs
-            if (entry.from_node_id == entry.to_node_id) {
-                throw std::invalid_argument(format_string("Flow to itself at node ID: %" PRId64 ".", entry.to_node_id));
-            }
-
-            // Check endpoint validity
-            if (!topology->IsValidEndpoint(entry.from_node_id)) {
-                throw std::invalid_argument(format_string("Invalid from-endpoint for a schedule entry based on topology: %d", entry.from_node_id));
-            }
-            if (!topology->IsValidEndpoint(entry.to_node_id)) {
-                throw std::invalid_argument(format_string("Invalid to-endpoint for a schedule entry based on topology: %d", entry.to_node_id));
-            }
-
-            // Check start time
-            if (entry.start_time_ns >= simulation_end_time_ns) {
-                throw std::invalid_argument(format_string(
-                        "Flow %" PRId64 " has invalid start time %" PRId64 " >= %" PRId64 ".",
-                        entry.flow_id, entry.start_time_ns, simulation_end_time_ns
-                ));
-            }
-
             // Put into schedule
             schedule.push_back(entry);
 
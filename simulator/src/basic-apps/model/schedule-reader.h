@@ -25,6 +25,8 @@ struct schedule_entry_t {
     std::string metadata;
 };
 
+schedule_entry_t parse_schedule_line(const std::string& line);
+void check_schedule_entry(const schedule_entry_t& entry, int64_t expected_flow_id, int64_t prev_start_time_ns, Ptr<Topology> topology, const int64_t simulation_end_time_ns);
 std::vector<schedule_entry_t> read_schedule(const std::string& filename, Ptr<Topology> topology, const int64_t simulation_end_time_ns);
 
 }
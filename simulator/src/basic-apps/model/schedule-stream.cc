@@ -0,0 +1,119 @@
+#include "schedule-stream.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ScheduleStream);
+TypeId ScheduleStream::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::ScheduleStream")
+            .SetParent<Object> ()
+            .SetGroupName("BasicApps")
+    ;
+    return tid;
+}
+
+ScheduleStream::ScheduleStream(const std::string& filename, Ptr<Topology> topology, const int64_t simulation_end_time_ns, int64_t window_size) {
+    m_filename = filename;
+    m_window_size = window_size;
+    m_num_entries = 0;
+    m_num_entries_read = 0;
+    m_num_windows_read = 0;
+    if (m_window_size < 1) {
+        throw std::invalid_argument(format_string("Schedule window size must be at least 1 (given: %" PRId64 ").", m_window_size));
+    }
+
+    // Check that the file exists
+    if (!file_exists(filename)) {
+        throw std::runtime_error(format_string("File %s does not exist.", filename.c_str()));
+    }
+
+    // Binary schedule is checked when it is mapped
+    if (is_binary_schedule(filename)) {
+        m_binary = CreateObject<ScheduleBinary>(filename, topology, simulation_end_time_ns);
+        m_num_entries = m_binary->GetNumEntries();
+        return;
+    }
+
+    // First pass over the schedule.csv only checks it
+    std::ifstream check_file(filename);
+    if (!check_file) {
+        throw std::runtime_error(format_string("File %s could not be read.", filename.c_str()));
+    }
+    std::string line;
+    int64_t prev_start_time_ns = 0;
+    while (getline(check_file, line)) {
+        schedule_entry_t entry = parse_schedule_line(line);
+        check_schedule_entry(entry, m_num_entries, prev_start_time_ns, topology, simulation_end_time_ns);
+        prev_start_time_ns = entry.start_time_ns;
+        m_num_entries++;
+    }
+    check_file.close();
+
+    // Second pass is done window by window
+    m_csv_file.open(filename);
+    if (!m_csv_file) {
+        throw std::runtime_error(format_string("File %s could not be read.", filename.c_str()));
+    }
+
+}
+
+void ScheduleStream::FillWindow() {
+    int64_t num_to_read = std::min(m_window_size, m_num_entries - m_num_entries_read);
+    std::string line;
+    for (int64_t i = 0; i < num_to_read; i++) {
+        if (m_binary != nullptr) {
+            m_window.push_back(m_binary->GetEntry(m_num_entries_read));
+        } else {
+            if (!getline(m_csv_file, line)) {
+                throw std::runtime_error(format_string("Schedule file %s changed while it was being read.", m_filename.c_str()));
+            }
+            m_window.push_back(parse_schedule_line(line));
+        }
+        m_num_entries_read++;
+    }
+    if (num_to_read > 0) {
+        m_num_windows_read++;
+    }
+    if (m_binary == nullptr && m_num_entries_read == m_num_entries) {
+        m_csv_file.close();
+    }
+}
+
+bool ScheduleStream::HasNext() {
+    return !m_window.empty() || m_num_entries_read < m_num_entries;
+}
+
+const schedule_entry_t& ScheduleStream::PeekNext() {
+    if (m_window.empty()) {
+        FillWindow();
+    }
+    if (m_window.empty()) {
+        throw std::runtime_error("There is no next schedule entry.");
+    }
+    return m_window.front();
+}
+
+schedule_entry_t ScheduleStream::Next() {
+    PeekNext();
+    schedule_entry_t entry = std::move(m_window.front());
+    m_window.pop_front();
+    return entry;
+}
+
+int64_t ScheduleStream::GetNumEntries() {
+    return m_num_entries;
+}
+
+int64_t ScheduleStream::GetWindowSize() {
+    return m_window_size;
+}
+
+int64_t ScheduleStream::GetNumWindowsRead() {
+    return m_num_windows_read;
+}
+
+bool ScheduleStream::IsBinary() {
+    return m_binary != nullptr;
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef SCHEDULE_STREAM_H
+#define SCHEDULE_STREAM_H
+
+#include <string>
+#include <deque>
+#include <fstream>
+#include <cinttypes>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/topology.h"
+#include "ns3/schedule-reader.h"
+#include "ns3/schedule-binary.h"
+
+namespace ns3 {
+
+/**
+ * Schedule which is read incrementally, a window of upcoming entries at a time,
+ * instead of all at once. It can be a schedule.csv or a binary schedule.
+ *
+ * The entire schedule is still checked when the stream is created (the schedule.csv by
+ * a first pass over the file which does not keep any entry), such that an invalid
+ * schedule is refused before the simulation starts rather than halfway through it.
+ */
+class ScheduleStream : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Open and check a schedule.
+     *
+     * @param filename                  Schedule file name (schedule.csv or binary schedule)
+     * @param topology                  Topology
+     * @param simulation_end_time_ns    Simulation end time (ns) : all flows must start less than this value
+     * @param window_size               Maximum number of upcoming entries in memory at a time (at least 1)
+     */
+    ScheduleStream(const std::string& filename, Ptr<Topology> topology, const int64_t simulation_end_time_ns, int64_t window_size);
+
+    bool HasNext();
+    const schedule_entry_t& PeekNext();
+    schedule_entry_t Next();
+
+    // Accessors
+    int64_t GetNumEntries();
+    int64_t GetWindowSize();
+    int64_t GetNumWindowsRead();
+    bool IsBinary();
+
+private:
+    void FillWindow();
+
+    std::string m_filename;
+    int64_t m_window_size;
+    int64_t m_num_entries;
+    int64_t m_num_entries_read;
+    int64_t m_num_windows_read;
+    std::deque<schedule_entry_t> m_window;
+    Ptr<ScheduleBinary> m_binary;
+    std::ifstream m_csv_file;
+};
+
+}
+
+#endif //SCHEDULE_STREAM_H
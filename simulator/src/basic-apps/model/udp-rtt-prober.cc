@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "udp-rtt-prober.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("UdpRttProberApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (UdpRttProber);
+
+TypeId
+UdpRttProber::GetTypeId(void) {
+    static TypeId tid = TypeId("ns3::UdpRttProber")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<UdpRttProber>()
+            .AddAttribute("Interval",
+                          "The time to wait between packets to the same target",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&UdpRttProber::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("RemotePort",
+                          "The destination port of the outbound packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&UdpRttProber::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("FromNodeId",
+                          "From node identifier",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&UdpRttProber::m_fromNodeId),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+UdpRttProber::UdpRttProber() {
+    NS_LOG_FUNCTION(this);
+    m_socket = 0;
+    m_sendEvent = EventId();
+    m_nextTarget = 0;
+    m_startNs = 0;
+    m_periodStartNs = 0;
+}
+
+UdpRttProber::~UdpRttProber() {
+    NS_LOG_FUNCTION(this);
+    m_socket = 0;
+}
+
+void
+UdpRttProber::DoDispose(void) {
+    NS_LOG_FUNCTION(this);
+    Application::DoDispose();
+}
+
+void
+UdpRttProber::AddTarget(uint32_t to_node_id, Ipv4Address address, int64_t offset_ns, bool keep_raw_samples) {
+    if (m_socket != 0) {
+        throw std::runtime_error("Targets cannot be added to a prober which has already started");
+    }
+    if (offset_ns < 0 || offset_ns >= m_interval.GetNanoSeconds()) {
+        throw std::invalid_argument(format_string("Prober target offset %" PRId64 " ns is not within the interval", offset_ns));
+    }
+    if (!m_targets.empty() && offset_ns < m_targets.back().offsetNs) {
+        throw std::invalid_argument("Prober targets must be added in ascending order of their offset");
+    }
+    if (!m_targetAddresses.insert(address.Get()).second) {
+        throw std::invalid_argument(format_string("Prober target node %u has an address which is already a target", to_node_id));
+    }
+    Target target;
+    target.toNodeId = to_node_id;
+    target.address = address;
+    target.offsetNs = offset_ns;
+    target.keepRawSamples = keep_raw_samples;
+    target.sent = 0;
+    m_targets.push_back(target);
+}
+
+void
+UdpRttProber::StartApplication(void) {
+    NS_LOG_FUNCTION(this);
+    if (m_socket == 0) {
+        TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+        m_socket = Socket::CreateSocket(GetNode(), tid);
+        if (m_socket->Bind() == -1) {
+            NS_FATAL_ERROR("Failed to bind socket");
+        }
+    }
+    m_socket->SetRecvCallback(MakeCallback(&UdpRttProber::HandleRead, this));
+    m_startNs = Simulator::Now().GetNanoSeconds();
+    m_periodStartNs = m_startNs;
+    m_nextTarget = 0;
+    if (!m_targets.empty()) {
+        ScheduleNextSlot();
+    }
+}
+
+void
+UdpRttProber::StopApplication() {
+    NS_LOG_FUNCTION(this);
+    if (m_socket != 0) {
+        m_socket->Close();
+        m_socket->SetRecvCallback(MakeNullCallback < void, Ptr < Socket > > ());
+    }
+    Simulator::Cancel(m_sendEvent);
+}
+
+void
+UdpRttProber::ScheduleNextSlot() {
+    int64_t slot_ns = m_periodStartNs + m_targets[m_nextTarget].offsetNs;
+    m_sendEvent = Simulator::Schedule(NanoSeconds(slot_ns - Simulator::Now().GetNanoSeconds()), &UdpRttProber::SendSlot, this);
+}
+
+void
+UdpRttProber::SendSlot(void) {
+    NS_LOG_FUNCTION(this);
+
+    // Every target of which the offset is that of this slot
+    int64_t offset_ns = m_targets[m_nextTarget].offsetNs;
+    while (m_nextTarget < m_targets.size() && m_targets[m_nextTarget].offsetNs == offset_ns) {
+        Send(m_nextTarget);
+        m_nextTarget++;
+    }
+
+    // After the last slot, the wheel goes around to the next interval
+    if (m_nextTarget == m_targets.size()) {
+        m_nextTarget = 0;
+        m_periodStartNs += m_interval.GetNanoSeconds();
+    }
+    ScheduleNextSlot();
+
+}
+
+void
+UdpRttProber::Send(uint32_t index) {
+    Target& target = m_targets[index];
+
+    // Packet with the target index as payload (in network byte order), which the server echoes
+    // back as is, and the sequence number (per target) and timestamp in the header
+    uint8_t payload[4] = {(uint8_t) (index >> 24), (uint8_t) (index >> 16), (uint8_t) (index >> 8), (uint8_t) index};
+    Ptr<Packet> p = Create<Packet>(payload, 4);
+    SeqTsHeader seqTs; // Creates one with the current timestamp
+    seqTs.SetSeq(target.sent);
+    p->AddHeader(seqTs);
+
+    // Packets are sent at a fixed interval, as such the send timestamp need not be retained
+    target.rttSummary.RecordSent();
+    if (target.keepRawSamples) {
+        target.sendRequestTimestamps.push_back(Simulator::Now().GetNanoSeconds());
+        target.replyTimestamps.push_back(-1);
+        target.receiveReplyTimestamps.push_back(-1);
+    }
+    target.sent++;
+
+    // Send out
+    m_socket->SendTo(p, 0, InetSocketAddress(target.address, m_peerPort));
+
+}
+
+void
+UdpRttProber::HandleRead(Ptr <Socket> socket) {
+    NS_LOG_FUNCTION(this << socket);
+    Ptr <Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from))) {
+
+        // A multi-homed target can reply from any of its interfaces, as such the reply is
+        // attributed to its target by the index it carries instead of its source address.
+        // Anything which is not a reply to one of our pings is dropped.
+        SeqTsHeader incomingSeqTs;
+        if (packet->GetSize() != incomingSeqTs.GetSerializedSize() + 4) {
+            NS_LOG_WARN("Prober on node " << m_fromNodeId << " dropped a packet of unexpected size " << packet->GetSize());
+            continue;
+        }
+        packet->RemoveHeader (incomingSeqTs);
+        uint8_t payload[4];
+        packet->CopyData(payload, 4);
+        uint32_t index = (((uint32_t) payload[0]) << 24) | (((uint32_t) payload[1]) << 16) | (((uint32_t) payload[2]) << 8) | payload[3];
+        uint32_t seqNo = incomingSeqTs.GetSeq();
+        if (index >= m_targets.size() || seqNo >= m_targets[index].sent) {
+            NS_LOG_WARN("Prober on node " << m_fromNodeId << " dropped a reply to a ping it did not send");
+            continue;
+        }
+        Target& target = m_targets[index];
+
+        // Timestamps
+        int64_t send_request_ns = m_startNs + target.offsetNs + seqNo * m_interval.GetNanoSeconds();
+        int64_t reply_ns = incomingSeqTs.GetTs().GetNanoSeconds();
+        int64_t receive_reply_ns = Simulator::Now().GetNanoSeconds();
+
+        // Add to the summary, and update the raw samples
+        target.rttSummary.RecordReply(reply_ns - send_request_ns, receive_reply_ns - reply_ns);
+        if (target.keepRawSamples) {
+            target.replyTimestamps[seqNo] = reply_ns;
+            target.receiveReplyTimestamps[seqNo] = receive_reply_ns;
+        }
+
+    }
+}
+
+UdpRttProber::Target& UdpRttProber::GetTarget(uint32_t target) {
+    if (target >= m_targets.size()) {
+        throw std::out_of_range(format_string("Prober target %u does not exist", target));
+    }
+    return m_targets[target];
+}
+
+uint32_t UdpRttProber::GetFromNodeId() {
+    return m_fromNodeId;
+}
+
+uint32_t UdpRttProber::GetNumTargets() {
+    return m_targets.size();
+}
+
+uint32_t UdpRttProber::GetToNodeId(uint32_t target) {
+    return GetTarget(target).toNodeId;
+}
+
+uint32_t UdpRttProber::GetSent(uint32_t target) {
+    return GetTarget(target).sent;
+}
+
+const RttSummary& UdpRttProber::GetRttSummary(uint32_t target) {
+    return GetTarget(target).rttSummary;
+}
+
+bool UdpRttProber::IsKeepingRawSamples(uint32_t target) {
+    return GetTarget(target).keepRawSamples;
+}
+
+const std::vector<int64_t>& UdpRttProber::GetSendRequestTimestamps(uint32_t target) {
+    return GetTarget(target).sendRequestTimestamps;
+}
+
+const std::vector<int64_t>& UdpRttProber::GetReplyTimestamps(uint32_t target) {
+    return GetTarget(target).replyTimestamps;
+}
+
+const std::vector<int64_t>& UdpRttProber::GetReceiveReplyTimestamps(uint32_t target) {
+    return GetTarget(target).receiveReplyTimestamps;
+}
+
+} // Namespace ns3
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef UDP_RTT_PROBER_H
+#define UDP_RTT_PROBER_H
+
+#include <vector>
+#include <unordered_set>
+#include <stdexcept>
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/exp-util.h"
+#include "ns3/rtt-summary.h"
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * Pings any number of targets from a single node through a single UDP socket,
+ * of which each target has to run a UdpRttServer.
+ *
+ * Every target is pinged at the same interval, each at its own fixed offset within it.
+ * The targets are kept ordered by offset (as a timing wheel with a slot per distinct offset),
+ * as such there is only one send event pending at a time regardless of the number of targets.
+ * A reply is attributed to its target by the target index carried in the payload (which
+ * the server echoes), as a multi-homed target can reply from any of its interfaces, and
+ * to its ping by the sequence number in the SeqTsHeader (which counts per target).
+ * Packets which are not a reply to one of its pings are dropped.
+ */
+class UdpRttProber : public Application
+{
+public:
+  static TypeId GetTypeId (void);
+  UdpRttProber ();
+  virtual ~UdpRttProber ();
+
+  /**
+   * Add a target, which is only possible before the application starts.
+   *
+   * @param to_node_id          Target node identifier
+   * @param address             Target address (a target can only be added once)
+   * @param offset_ns           Offset of its pings within the interval (at least that of the previous target, less than the interval)
+   * @param keep_raw_samples    True iff the timestamps of every ping are retained
+   */
+  void AddTarget (uint32_t to_node_id, Ipv4Address address, int64_t offset_ns, bool keep_raw_samples);
+
+  uint32_t GetFromNodeId();
+  uint32_t GetNumTargets();
+  uint32_t GetToNodeId(uint32_t target);
+  uint32_t GetSent(uint32_t target);
+  const RttSummary& GetRttSummary(uint32_t target);
+
+  // Raw samples of a target (only retained if it was added to keep them, else empty)
+  bool IsKeepingRawSamples(uint32_t target);
+  const std::vector<int64_t>& GetSendRequestTimestamps(uint32_t target);
+  const std::vector<int64_t>& GetReplyTimestamps(uint32_t target);
+  const std::vector<int64_t>& GetReceiveReplyTimestamps(uint32_t target);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+
+  struct Target {
+    uint32_t toNodeId;
+    Ipv4Address address;
+    int64_t offsetNs;
+    bool keepRawSamples;
+    uint32_t sent;
+    RttSummary rttSummary;
+    std::vector<int64_t> sendRequestTimestamps;
+    std::vector<int64_t> replyTimestamps;
+    std::vector<int64_t> receiveReplyTimestamps;
+  };
+
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+  void ScheduleNextSlot (void);
+  void SendSlot (void);
+  void Send (uint32_t index);
+  void HandleRead (Ptr<Socket> socket);
+  Target& GetTarget (uint32_t target);
+
+  Time m_interval; //!< Packet inter-send time of each target
+  uint16_t m_peerPort; //!< Remote port of every target
+  uint32_t m_fromNodeId;
+  Ptr<Socket> m_socket; //!< Socket
+  EventId m_sendEvent; //!< Event to send the packets of the next slot
+
+  std::vector<Target> m_targets; //!< Ordered by offset
+  std::unordered_set<uint32_t> m_targetAddresses; //!< Addresses of the targets (each can only be added once)
+  size_t m_nextTarget; //!< First target of the next slot
+  int64_t m_startNs; //!< The i-th packet to a target is sent at m_startNs + offset + i * interval
+  int64_t m_periodStartNs; //!< Start of the interval of the next slot
+
+};
+
+} // namespace ns3
+
+#endif /* UDP_RTT_PROBER_H */
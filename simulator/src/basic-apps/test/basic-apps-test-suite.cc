@@ -6,6 +6,9 @@
 #include "end-to-end-flows-test.h"
 #include "end-to-end-pingmesh-test.h"
 #include "hrvd-config-reader-test.h"
+#include "horovod-trace-buffer-test.h"
+#include "horovod-event-arena-test.h"
+#include "rtt-summary-test.h"
 
 using namespace ns3;
 
@@ -14,6 +17,8 @@ public:
     BasicAppsTestSuite() : TestSuite("basic-apps", UNIT) {
         AddTestCase(new ScheduleReaderNormalTestCase, TestCase::QUICK);
         AddTestCase(new ScheduleReaderInvalidTestCase, TestCase::QUICK);
+        AddTestCase(new ScheduleReaderBinaryTestCase, TestCase::QUICK);
+        AddTestCase(new ScheduleReaderStreamTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndFlowsOneToOneEqualStartTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndFlowsOneToOneSimpleStartTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndFlowsOneToOneApartStartTestCase, TestCase::QUICK);
@@ -21,9 +26,18 @@ public:
         AddTestCase(new EndToEndFlowsEcmpRemainTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndFlowsNonExistentRunDirTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndFlowsOneDropOneNotTestCase, TestCase::QUICK);
+        AddTestCase(new EndToEndFlowsQueueTraceTestCase, TestCase::QUICK);
+        AddTestCase(new EndToEndFlowsReuseTimeWaitTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndPingmeshNineAllTestCase, TestCase::QUICK);
         AddTestCase(new EndToEndPingmeshNinePairsTestCase, TestCase::QUICK);
+        AddTestCase(new EndToEndPingmeshNineRawPairsTestCase, TestCase::QUICK);
+        AddTestCase(new EndToEndPingmeshMultiHomedTestCase, TestCase::QUICK);
+        AddTestCase(new PingmeshProberAddTargetTestCase, TestCase::QUICK);
         AddTestCase(new HorovodWorkerConfigReaderTestCase, TestCase::QUICK);
+        AddTestCase(new HorovodTraceBufferTestCase, TestCase::QUICK);
+        AddTestCase(new HorovodEventArenaTestCase, TestCase::QUICK);
+        AddTestCase(new RttSummaryQuantileSketchTestCase, TestCase::QUICK);
+        AddTestCase(new RttSummaryStatisticsTestCase, TestCase::QUICK);
     }
 };
 static BasicAppsTestSuite basicAppsTestSuite;
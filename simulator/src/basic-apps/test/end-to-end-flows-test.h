@@ -23,6 +23,13 @@ public:
     }
 };
 
+// Flows are written in the order in which they finish, as such the lines (from first on) are sorted by flow ID
+void sort_flow_lines_by_flow_id(std::vector<std::string>& lines, size_t first) {
+    std::stable_sort(lines.begin() + first, lines.end(), [](const std::string& a, const std::string& b) {
+        return std::stoll(a) < std::stoll(b);
+    });
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
 class EndToEndFlowsTestCase : public TestCase {
@@ -37,7 +44,7 @@ public:
         remove_file_if_exists(temp_dir + "/schedule.csv");
     }
 
-    void write_basic_config(int64_t simulation_end_time_ns, int64_t simulation_seed, double link_data_rate_megabit_per_s, int64_t link_delay_ns) {
+    void write_basic_config(int64_t simulation_end_time_ns, int64_t simulation_seed, double link_data_rate_megabit_per_s, int64_t link_delay_ns, std::string additional_config_lines = "", std::string enable_flow_logging_to_file_for_flow_ids = "set(0)") {
         std::ofstream config_file;
         config_file.open (temp_dir + "/config_ns3.properties");
         config_file << "filename_topology=\"topology.properties\"" << std::endl;
@@ -49,7 +56,8 @@ public:
         config_file << "link_max_queue_size_pkts=100" << std::endl;
         config_file << "disable_qdisc_endpoint_tors_xor_servers=false" << std::endl;
         config_file << "disable_qdisc_non_endpoint_switches=false" << std::endl;
-        config_file << "enable_flow_logging_to_file_for_flow_ids=set(0)" << std::endl;
+        config_file << "enable_flow_logging_to_file_for_flow_ids=" << enable_flow_logging_to_file_for_flow_ids << std::endl;
+        config_file << additional_config_lines;
         config_file.close();
     }
 
@@ -65,6 +73,11 @@ public:
         topology_file.close();
     }
 
+    // Called after the validation of the flow logs, before the logs directory is removed
+    virtual void validate_and_remove_additional_logs() {
+        // Nothing by default
+    }
+
     void test_run_and_simple_validate(int64_t simulation_end_time_ns, std::string temp_dir, std::vector<schedule_entry_t> write_schedule, std::vector<int64_t>& end_time_ns_list, std::vector<int64_t>& sent_byte_list, BeforeRunOperation* beforeRunOperation) {
 
         // Make sure these are removed
@@ -107,6 +120,7 @@ public:
 
         // Check flows.csv
         std::vector<std::string> lines_csv = read_file_direct(temp_dir + "/logs_ns3/flows.csv");
+        sort_flow_lines_by_flow_id(lines_csv, 0);
         ASSERT_EQUAL(lines_csv.size(), write_schedule.size());
         int i = 0;
         for (std::string line : lines_csv) {
@@ -132,6 +146,7 @@ public:
         // Check flows.txt
         std::vector<std::string> lines_txt = read_file_direct(temp_dir + "/logs_ns3/flows.txt");
         ASSERT_EQUAL(lines_txt.size(), write_schedule.size() + 1);
+        sort_flow_lines_by_flow_id(lines_txt, 1);
         i = 0;
         for (std::string line : lines_txt) {
             if (i == 0) {
@@ -169,12 +184,16 @@ public:
             i++;
         }
 
+        // Log files specific to the test case
+        validate_and_remove_additional_logs();
+
         // Make sure these are removed
         remove_file_if_exists(temp_dir + "/config_ns3.properties");
         remove_file_if_exists(temp_dir + "/topology.properties");
         remove_file_if_exists(temp_dir + "/schedule.csv");
         remove_file_if_exists(temp_dir + "/logs_ns3/finished.txt");
         remove_file_if_exists(temp_dir + "/logs_ns3/timing_results.txt");
+        remove_file_if_exists(temp_dir + "/logs_ns3/route_cache.csv");
         remove_file_if_exists(temp_dir + "/logs_ns3/flows.csv");
         remove_file_if_exists(temp_dir + "/logs_ns3/flows.txt");
         remove_file_if_exists(temp_dir + "/logs_ns3/flow_0_cwnd.txt");
@@ -377,6 +396,121 @@ public:
     }
 };
 
+class EndToEndFlowsQueueTraceTestCase : public EndToEndFlowsTestCase
+{
+public:
+    EndToEndFlowsQueueTraceTestCase () : EndToEndFlowsTestCase ("end-to-end-flows queue-trace") {};
+
+    void validate_and_remove_additional_logs() {
+
+        // Each of the three bands of both endpoints has its own trace, and the data went through node 0
+        int64_t num_lines_node_0 = 0;
+        for (int64_t node_id = 0; node_id < 2; node_id++) {
+            for (int band = 0; band < 3; band++) {
+                std::string filename = temp_dir + "/logs_ns3/" + format_string("Node_%" PRId64 "_queue_band_%d.txt", node_id, band);
+                ASSERT_TRUE(file_exists(filename));
+                std::vector<std::string> lines = read_file_direct(filename);
+                for (std::string line : lines) {
+                    std::vector<std::string> spl = split_string(line, " ", 5);
+                    ASSERT_EQUAL(spl[0], "TcBytesInQueue");
+                    ASSERT_EQUAL(spl[2], "to");
+                }
+                if (node_id == 0) {
+                    num_lines_node_0 += lines.size();
+                }
+                remove_file_if_exists(filename);
+            }
+        }
+        ASSERT_TRUE(num_lines_node_0 > 0);
+
+    }
+
+    void DoRun () {
+        prepare_test_dir();
+
+        int64_t simulation_end_time_ns = 5000000000;
+
+        // One-to-one, 5s, 10.0 Mbit/s, 100 microseconds delay, with queue tracing of every change
+        write_basic_config(simulation_end_time_ns, 123456, 10.0, 100000, "queue_trace_enabled=true\nqueue_trace_mode=change\n");
+        write_single_topology();
+
+        // One flow
+        std::vector<schedule_entry_t> schedule;
+        schedule.push_back({0, 0, 1, 1000000, 0, "", ""});
+
+        // Perform the run
+        std::vector<int64_t> end_time_ns_list;
+        std::vector<int64_t> sent_byte_list;
+        BeforeRunOperationNothing op;
+        test_run_and_simple_validate(simulation_end_time_ns, temp_dir, schedule, end_time_ns_list, sent_byte_list, &op);
+        ASSERT_EQUAL(sent_byte_list[0], 1000000);
+
+    }
+};
+
+class EndToEndFlowsReuseTimeWaitTestCase : public EndToEndFlowsTestCase
+{
+public:
+    EndToEndFlowsReuseTimeWaitTestCase () : EndToEndFlowsTestCase ("end-to-end-flows reuse-time-wait") {};
+
+    void validate_and_remove_additional_logs() {
+
+        // The logs of each flow only have its own records, within its own lifetime, up to its full size
+        for (int64_t flow_id = 0; flow_id < 2; flow_id++) {
+            for (std::string kind : {"progress", "cwnd", "rtt"}) {
+                std::string filename = temp_dir + "/logs_ns3/" + format_string("flow_%" PRId64 "_%s.txt", flow_id, kind.c_str());
+                std::vector<std::string> lines = read_file_direct(filename);
+                ASSERT_TRUE(lines.size() > 0);
+                for (std::string line : lines) {
+                    std::vector<std::string> spl = split_string(line, ",", 3);
+                    ASSERT_EQUAL(parse_positive_int64(spl[0]), flow_id);
+                    int64_t time_ns = parse_positive_int64(spl[1]);
+                    ASSERT_TRUE(time_ns >= m_start_time_ns_list[flow_id] && time_ns <= m_end_time_ns_list[flow_id]);
+                }
+                if (kind == "progress") {
+                    ASSERT_EQUAL(parse_positive_int64(split_string(lines.back(), ",", 3)[2]), 100000);
+                }
+                if (flow_id != 0) {
+                    remove_file_if_exists(filename);
+                }
+            }
+        }
+
+    }
+
+    void DoRun () {
+        prepare_test_dir();
+
+        int64_t simulation_end_time_ns = 5000000000;
+
+        // One-to-one, 5s, 10.0 Mbit/s, 100 microseconds delay, with flow logging of both flows
+        write_basic_config(simulation_end_time_ns, 123456, 10.0, 100000, "", "set(0,1)");
+        write_single_topology();
+
+        // The second flow re-uses the sender application of the first, of which the
+        // socket is then still in TIME_WAIT (which lasts 2 * 120s by default)
+        std::vector<schedule_entry_t> schedule;
+        schedule.push_back({0, 0, 1, 100000, 0, "", ""});
+        schedule.push_back({1, 0, 1, 100000, 1000000000, "", ""});
+
+        // Perform the run (the end times are taken from flows.csv before the logs are validated)
+        m_start_time_ns_list = {0, 1000000000};
+        std::vector<int64_t> sent_byte_list;
+        BeforeRunOperationNothing op;
+        test_run_and_simple_validate(simulation_end_time_ns, temp_dir, schedule, m_end_time_ns_list, sent_byte_list, &op);
+
+        // Both completed, without interference
+        ASSERT_EQUAL(sent_byte_list[0], 100000);
+        ASSERT_EQUAL(sent_byte_list[1], 100000);
+        ASSERT_EQUAL(m_end_time_ns_list[0], m_end_time_ns_list[1] - 1000000000);
+
+    }
+
+private:
+    std::vector<int64_t> m_start_time_ns_list;
+    std::vector<int64_t> m_end_time_ns_list;
+};
+
 class ArbiterSpecificDrop: public ArbiterPtop
 {
 public:
@@ -25,7 +25,7 @@ public:
         remove_file_if_exists(temp_dir + "/topology.properties");
     }
 
-    void write_basic_config(int64_t simulation_end_time_ns, int64_t pingmesh_interval_ns, std::string pingmesh_endpoint_pairs) {
+    void write_basic_config(int64_t simulation_end_time_ns, int64_t pingmesh_interval_ns, std::string pingmesh_endpoint_pairs, std::string pingmesh_raw_sample_pairs = "") {
         std::ofstream config_file;
         config_file.open (temp_dir + "/config_ns3.properties");
         config_file << "filename_topology=\"topology.properties\"" << std::endl;
@@ -38,6 +38,9 @@ public:
         config_file << "disable_qdisc_endpoint_tors_xor_servers=true" << std::endl;
         config_file << "disable_qdisc_non_endpoint_switches=true" << std::endl;
         config_file << "pingmesh_endpoint_pairs=" << pingmesh_endpoint_pairs << std::endl;
+        if (!pingmesh_raw_sample_pairs.empty()) {
+            config_file << "pingmesh_raw_sample_pairs=" << pingmesh_raw_sample_pairs << std::endl;
+        }
         config_file.close();
     }
 
@@ -58,7 +61,22 @@ public:
         topology_file.close();
     }
 
-    void test_run_and_simple_validate(int64_t simulation_end_time_ns, std::string temp_dir, uint32_t expected_num_pings, std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency, int64_t max_delta_more_latency) {
+    //
+    // 0 - 1 - 2
+    //
+    void write_line_topology() {
+        std::ofstream topology_file;
+        topology_file.open (temp_dir + "/topology.properties");
+        topology_file << "num_nodes=3" << std::endl;
+        topology_file << "num_undirected_edges=2" << std::endl;
+        topology_file << "switches=set(0,1,2)" << std::endl;
+        topology_file << "switches_which_are_tors=set(0,1,2)" << std::endl;
+        topology_file << "servers=set()" << std::endl;
+        topology_file << "undirected_edges=set(0-1,1-2)" << std::endl;
+        topology_file.close();
+    }
+
+    void test_run_and_simple_validate(int64_t simulation_end_time_ns, std::string temp_dir, uint32_t expected_num_pings, std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency, int64_t max_delta_more_latency, std::set<std::pair<int64_t, int64_t>> expected_raw_sample_pairs = {}, bool expect_no_loss = false) {
 
         // Make sure these are removed
         remove_file_if_exists(temp_dir + "/logs_ns3/finished.txt");
@@ -84,6 +102,10 @@ public:
         std::vector<std::string> lines_csv = read_file_direct(temp_dir + "/logs_ns3/pingmesh.csv");
         std::pair<int64_t, int64_t> current = std::make_pair(-1, -1);
         int64_t counter = 0;
+        int64_t interval_ns = simulation_end_time_ns / expected_num_pings;
+        int64_t in_between_ns = interval_ns / (topology->GetEndpoints().size() - 1);
+        std::map<int64_t, int64_t> from_to_num_targets;
+        int64_t target_index = 0;
         for (std::string line : lines_csv) {
             std::vector<std::string> spl = split_string(line, ",", 10);
             int64_t from = parse_positive_int64(spl[0]);
@@ -92,6 +114,7 @@ public:
             if (std::make_pair(from, to) != current) {
                 counter = 0;
                 current = std::make_pair(from, to);
+                target_index = from_to_num_targets[from]++;
             }
             ASSERT_EQUAL(i, counter);
             counter++;
@@ -111,8 +134,13 @@ public:
             }
             ASSERT_TRUE(topology->IsValidEndpoint(from));
             ASSERT_TRUE(topology->IsValidEndpoint(to));
+            ASSERT_TRUE(expected_raw_sample_pairs.empty() || set_pair_int64_contains(expected_raw_sample_pairs, std::make_pair(from, to)));
             ASSERT_TRUE(i >= 0);
             ASSERT_TRUE(sent >= 0);
+            if (expected_raw_sample_pairs.empty()) {
+                // Each target of a source is pinged at a fixed interval, staggered in between its other targets
+                ASSERT_EQUAL(sent, target_index * in_between_ns + i * interval_ns);
+            }
             if (arrived) {
                 ASSERT_TRUE(reply >= sent);
                 ASSERT_TRUE(got_reply >= reply);
@@ -126,6 +154,11 @@ public:
                 ASSERT_TRUE(way_back <= expected_latency + max_delta_more_latency);
                 ASSERT_TRUE(way_back <= expected_latency + max_delta_more_latency);
             } else {
+                if (expect_no_loss) {
+                    // Only pings of which the reply would come after the end of the simulation are lost
+                    ASSERT_TRUE(pair_to_expected_latency.find(std::make_pair(from, to)) != pair_to_expected_latency.end());
+                    ASSERT_TRUE(sent + 2 * pair_to_expected_latency.find(std::make_pair(from, to))->second >= simulation_end_time_ns);
+                }
                 ASSERT_EQUAL(reply, -1);
                 ASSERT_EQUAL(got_reply, -1);
                 ASSERT_EQUAL(way_there, -1);
@@ -134,11 +167,25 @@ public:
             }
         }
 
+        // Check pingmesh.txt: every pair has a summary, of which the RTT percentiles are within [min, max]
+        std::vector<std::string> lines_txt = read_file_direct(temp_dir + "/logs_ns3/pingmesh.txt");
+        ASSERT_EQUAL(lines_txt.size(), pair_to_expected_latency.size() + 1);
+        ASSERT_TRUE(lines_txt[0].find("p99.9 RTT") != std::string::npos);
+        for (size_t j = 1; j < lines_txt.size(); j++) {
+            double min_rtt_ms = std::stod(lines_txt[j].substr(64, 16));
+            double max_rtt_ms = std::stod(lines_txt[j].substr(96, 16));
+            for (size_t k = 0; k < 3; k++) {
+                double percentile_rtt_ms = std::stod(lines_txt[j].substr(128 + 16 * k, 16));
+                ASSERT_TRUE(percentile_rtt_ms >= min_rtt_ms && percentile_rtt_ms <= max_rtt_ms);
+            }
+        }
+
         // Make sure these are removed
         remove_file_if_exists(temp_dir + "/config_ns3.properties");
         remove_file_if_exists(temp_dir + "/topology.properties");
         remove_file_if_exists(temp_dir + "/logs_ns3/finished.txt");
         remove_file_if_exists(temp_dir + "/logs_ns3/timing_results.txt");
+        remove_file_if_exists(temp_dir + "/logs_ns3/route_cache.csv");
         remove_file_if_exists(temp_dir + "/logs_ns3/pingmesh.csv");
         remove_file_if_exists(temp_dir + "/logs_ns3/pingmesh.txt");
         remove_dir_if_exists(temp_dir + "/logs_ns3");
@@ -157,7 +204,7 @@ public:
         prepare_test_dir();
 
         // 5 seconds, every 100ms a ping
-        write_basic_config(5000000000, 100000000, "all");
+        write_basic_config(5000000000, 100000000, "all", "all");
         write_six_topology();
         std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency;
         pair_to_expected_latency.insert(std::make_pair(std::make_pair(0, 1), 50000000));
@@ -196,7 +243,7 @@ public:
         prepare_test_dir();
 
         // 5 seconds, every 100ms a ping
-        write_basic_config(5000000000, 100000000, "set(2-1, 1-2, 0-5, 5-2, 3-1)");
+        write_basic_config(5000000000, 100000000, "set(2-1, 1-2, 0-5, 5-2, 3-1)", "all");
         write_six_topology();
         std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency;
         pair_to_expected_latency.insert(std::make_pair(std::make_pair(0, 5), 150000000));
@@ -211,4 +258,105 @@ public:
     }
 };
 
+class EndToEndPingmeshNineRawPairsTestCase : public EndToEndPingmeshTestCase
+{
+public:
+    EndToEndPingmeshNineRawPairsTestCase () : EndToEndPingmeshTestCase ("pingmesh nine-raw-pairs") {};
+
+    void DoRun () {
+        prepare_test_dir();
+
+        // 5 seconds, every 100ms a ping, of which only two pairs have each ping in pingmesh.csv
+        write_basic_config(5000000000, 100000000, "set(2-1, 1-2, 0-5, 5-2, 3-1)", "set(0-5, 3-1)");
+        write_six_topology();
+        std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency;
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(0, 5), 150000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(1, 2), 50000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(2, 1), 50000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(3, 1), 100000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(5, 2), 50000000));
+
+        // Perform the run
+        std::set<std::pair<int64_t, int64_t>> expected_raw_sample_pairs;
+        expected_raw_sample_pairs.insert(std::make_pair(0, 5));
+        expected_raw_sample_pairs.insert(std::make_pair(3, 1));
+        test_run_and_simple_validate(5000000000, temp_dir, 100, pair_to_expected_latency, 1000, expected_raw_sample_pairs);
+
+        // Raw sample pairs must be pingmesh pairs
+        prepare_test_dir();
+        write_basic_config(5000000000, 100000000, "set(2-1, 1-2)", "set(0-5)");
+        write_six_topology();
+        Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(temp_dir);
+        Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+        ASSERT_EXCEPTION(PingmeshScheduler(basicSimulation, topology));
+        basicSimulation->Finalize();
+        remove_file_if_exists(temp_dir + "/config_ns3.properties");
+        remove_file_if_exists(temp_dir + "/topology.properties");
+        remove_file_if_exists(temp_dir + "/logs_ns3/finished.txt");
+        remove_file_if_exists(temp_dir + "/logs_ns3/timing_results.txt");
+        remove_file_if_exists(temp_dir + "/logs_ns3/route_cache.csv");
+        remove_dir_if_exists(temp_dir + "/logs_ns3");
+        remove_dir_if_exists(temp_dir);
+
+    }
+};
+
+class EndToEndPingmeshMultiHomedTestCase : public EndToEndPingmeshTestCase
+{
+public:
+    EndToEndPingmeshMultiHomedTestCase () : EndToEndPingmeshTestCase ("pingmesh multi-homed") {};
+
+    void DoRun () {
+        prepare_test_dir();
+
+        // Node 1 is pinged at its address of interface 1 (link 0-1), but replies to
+        // node 2 leave through interface 2 (link 1-2) and as such have another source address
+        write_basic_config(5000000000, 100000000, "set(0-1, 2-1, 0-2, 2-0)", "all");
+        write_line_topology();
+        std::map<std::pair<int64_t, int64_t>, int64_t> pair_to_expected_latency;
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(0, 1), 50000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(0, 2), 100000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(2, 0), 100000000));
+        pair_to_expected_latency.insert(std::make_pair(std::make_pair(2, 1), 50000000));
+
+        // Perform the run, in which every reply must be attributed to its ping
+        test_run_and_simple_validate(5000000000, temp_dir, 100, pair_to_expected_latency, 1000, {}, true);
+
+    }
+};
+
+class PingmeshProberAddTargetTestCase : public TestCase
+{
+public:
+    PingmeshProberAddTargetTestCase () : TestCase ("pingmesh prober-add-target") {};
+
+    void DoRun () {
+        Ptr<UdpRttProber> prober = CreateObject<UdpRttProber>();
+        prober->SetAttribute("Interval", TimeValue(NanoSeconds(1000)));
+        prober->SetAttribute("FromNodeId", UintegerValue(7));
+        prober->AddTarget(3, Ipv4Address("10.0.0.3"), 0, false);
+        prober->AddTarget(1, Ipv4Address("10.0.0.1"), 0, true);
+        prober->AddTarget(9, Ipv4Address("10.0.0.9"), 500, false);
+
+        // Offsets must be ascending and within the interval, and each address only a target once
+        ASSERT_EXCEPTION(prober->AddTarget(4, Ipv4Address("10.0.0.4"), 499, false));
+        ASSERT_EXCEPTION(prober->AddTarget(4, Ipv4Address("10.0.0.4"), 1000, false));
+        ASSERT_EXCEPTION(prober->AddTarget(4, Ipv4Address("10.0.0.4"), -1, false));
+        ASSERT_EXCEPTION(prober->AddTarget(4, Ipv4Address("10.0.0.9"), 600, false));
+
+        // Targets in the order they were added
+        ASSERT_EQUAL(prober->GetFromNodeId(), 7);
+        ASSERT_EQUAL(prober->GetNumTargets(), 3);
+        ASSERT_EQUAL(prober->GetToNodeId(0), 3);
+        ASSERT_EQUAL(prober->GetToNodeId(1), 1);
+        ASSERT_EQUAL(prober->GetToNodeId(2), 9);
+        ASSERT_EXCEPTION(prober->GetToNodeId(3));
+        ASSERT_TRUE(!prober->IsKeepingRawSamples(0));
+        ASSERT_TRUE(prober->IsKeepingRawSamples(1));
+        ASSERT_EQUAL(prober->GetSent(2), 0);
+        ASSERT_EQUAL(prober->GetRttSummary(2).GetNumSent(), 0);
+        ASSERT_EQUAL(prober->GetSendRequestTimestamps(1).size(), 0);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/horovod-event-arena.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class HorovodEventArenaTestCase : public TestCase
+{
+public:
+    HorovodEventArenaTestCase () : TestCase("horovod-event-arena write") {}
+
+    void DoRun() {
+
+        // Same lines as the event strings formerly recorded
+        HorovodEventArena arena;
+        arena.Add(100, 0, 3, HOROVOD_EVENT_BP_START);
+        arena.Add(200, 0, 3, HOROVOD_EVENT_BP_DONE);
+        arena.Add(250, 0, 3, HOROVOD_EVENT_START_SENDING_PARTITION, 1, 2);
+        arena.Add(300, 0, 3, HOROVOD_EVENT_RECEIVED_PARTITION, 0, 2);
+        arena.Add(400, 1, 0, HOROVOD_EVENT_FP_START);
+        arena.Add(500, 1, 0, HOROVOD_EVENT_FP_DONE);
+        std::ostringstream out;
+        arena.Write(out);
+        ASSERT_EQUAL(out.str(),
+                     "0,3,BP_Start,100\n"
+                     "0,3,BP_Done,200\n"
+                     "0,3,Start_Sending_Partition_1_Priority_2,250\n"
+                     "0,3,Received_Partition_0_Priority_2,300\n"
+                     "1,0,FP_Start,400\n"
+                     "1,0,FP_Done,500\n");
+
+        // Across multiple blocks, in order
+        arena.Clear();
+        int64_t n = HorovodEventArena::BLOCK_NUM_EVENTS * 2 + 5;
+        for (int64_t i = 0; i < n; i++) {
+            arena.Add(i, 0, 0, HOROVOD_EVENT_FP_DONE);
+        }
+        ASSERT_EQUAL(arena.GetNumEvents(), n);
+        ASSERT_EQUAL(arena.GetMemoryUsageByte(), (int64_t) (3 * HorovodEventArena::BLOCK_NUM_EVENTS * sizeof(horovod_event_t)));
+        std::ostringstream out_blocks;
+        arena.Write(out_blocks);
+        std::istringstream in_blocks(out_blocks.str());
+        std::string line;
+        int64_t i = 0;
+        while (std::getline(in_blocks, line)) {
+            ASSERT_EQUAL(line, "0,0,FP_Done," + std::to_string(i));
+            i++;
+        }
+        ASSERT_EQUAL(i, n);
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
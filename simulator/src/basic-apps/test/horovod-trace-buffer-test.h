@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/horovod-trace-buffer.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class HorovodTraceBufferTestCase : public TestCase
+{
+public:
+    HorovodTraceBufferTestCase () : TestCase("horovod-trace-buffer ring buffer") {}
+
+    void DoRun() {
+
+        // Parsing
+        ASSERT_EQUAL(parse_horovod_trace_level("none"), HOROVOD_TRACE_NONE);
+        ASSERT_EQUAL(parse_horovod_trace_level("info"), HOROVOD_TRACE_INFO);
+        ASSERT_EQUAL(parse_horovod_trace_level("debug"), HOROVOD_TRACE_DEBUG);
+        ASSERT_EXCEPTION(parse_horovod_trace_level("all"));
+        ASSERT_EXCEPTION(CreateObject<HorovodTraceBuffer>(HOROVOD_TRACE_DEBUG, 0));
+
+        // Records above the level are dropped
+        Ptr<HorovodTraceBuffer> buffer = CreateObject<HorovodTraceBuffer>(HOROVOD_TRACE_INFO, 3);
+        buffer->Record(HOROVOD_TRACE_DEBUG, 0, 1024, "a");
+        ASSERT_EQUAL(buffer->GetNumRecorded(), 0);
+
+        // Once full, the oldest records are overwritten
+        for (int i = 0; i < 5; i++) {
+            buffer->Record(HOROVOD_TRACE_INFO, i, 1024, "m" + std::to_string(i));
+        }
+        ASSERT_EQUAL(buffer->GetNumRecorded(), 5);
+        ASSERT_EQUAL(buffer->GetNumRetained(), 3);
+        std::ostringstream out;
+        buffer->Dump(out);
+        ASSERT_EQUAL(out.str(),
+                     "0 Worker ID: 2 Port: 1024 INFO m2\n"
+                     "0 Worker ID: 3 Port: 1024 INFO m3\n"
+                     "0 Worker ID: 4 Port: 1024 INFO m4\n");
+
+        // Cleared
+        buffer->Clear();
+        ASSERT_EQUAL(buffer->GetNumRetained(), 0);
+        buffer->Record(HOROVOD_TRACE_INFO, 7, 1025, "x");
+        std::ostringstream out_after_clear;
+        buffer->Dump(out_after_clear);
+        ASSERT_EQUAL(out_after_clear.str(), "0 Worker ID: 7 Port: 1025 INFO x\n");
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <random>
+#include <algorithm>
+#include "ns3/rtt-summary.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class RttSummaryQuantileSketchTestCase : public TestCase
+{
+public:
+    RttSummaryQuantileSketchTestCase () : TestCase("rtt-summary quantile-sketch") {}
+
+    void DoRun() {
+        ASSERT_EXCEPTION(QuantileSketch(0.0));
+        ASSERT_EXCEPTION(QuantileSketch(1.0));
+        QuantileSketch empty(0.01);
+        ASSERT_EXCEPTION(empty.GetQuantile(0.5));
+
+        // Values from 10 us to 100 ms (heavy tailed), of which every quantile must be within the relative accuracy
+        std::mt19937_64 rng(123456789);
+        std::lognormal_distribution<double> distribution(std::log(100000.0), 1.0);
+        QuantileSketch sketch(0.01);
+        QuantileSketch sketch_a(0.01);
+        QuantileSketch sketch_b(0.01);
+        std::vector<double> values;
+        for (int i = 0; i < 100000; i++) {
+            double value = std::min(100000000.0, std::max(10000.0, distribution(rng)));
+            values.push_back(value);
+            sketch.Add(value);
+            if (i % 3 == 0) {
+                sketch_a.Add(value);
+            } else {
+                sketch_b.Add(value);
+            }
+        }
+        std::sort(values.begin(), values.end());
+        ASSERT_EQUAL(sketch.GetCount(), 100000);
+        ASSERT_TRUE(sketch.GetNumBuckets() <= 500);
+        ASSERT_EXCEPTION(sketch.GetQuantile(-0.1));
+        ASSERT_EXCEPTION(sketch.GetQuantile(1.1));
+        for (double q : {0.0, 0.01, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+            double exact = values[(size_t) (q * (values.size() - 1))];
+            ASSERT_TRUE(std::abs(sketch.GetQuantile(q) - exact) <= 0.01 * exact);
+        }
+
+        // Merging is the same as adding all to one
+        sketch_a.Merge(sketch_b);
+        ASSERT_EQUAL(sketch_a.GetCount(), 100000);
+        ASSERT_EQUAL(sketch_a.GetNumBuckets(), sketch.GetNumBuckets());
+        for (double q : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+            ASSERT_EQUAL(sketch_a.GetQuantile(q), sketch.GetQuantile(q));
+        }
+        QuantileSketch other_accuracy(0.02);
+        ASSERT_EXCEPTION(sketch_a.Merge(other_accuracy));
+
+        // Values which are not positive
+        QuantileSketch with_zeros(0.01);
+        with_zeros.Add(0);
+        with_zeros.Add(0);
+        with_zeros.Add(1000);
+        ASSERT_EQUAL(with_zeros.GetQuantile(0.5), 0.0);
+        ASSERT_TRUE(std::abs(with_zeros.GetQuantile(1.0) - 1000) <= 10);
+    }
+};
+
+class RttSummaryStatisticsTestCase : public TestCase
+{
+public:
+    RttSummaryStatisticsTestCase () : TestCase("rtt-summary statistics") {}
+
+    void DoRun() {
+
+        // Nothing arrived
+        RttSummary summary;
+        summary.RecordSent();
+        summary.RecordSent();
+        ASSERT_EQUAL(summary.GetNumSent(), 2);
+        ASSERT_EQUAL(summary.GetNumReplies(), 0);
+        ASSERT_EQUAL(summary.GetNumLost(), 2);
+        ASSERT_EQUAL(summary.GetMinRttNs(), -1);
+        ASSERT_EQUAL(summary.GetMaxRttNs(), -1);
+        ASSERT_EQUAL(summary.GetMeanRttNs(), -1);
+        ASSERT_EQUAL(summary.GetSampleStdRttNs(), -1);
+        ASSERT_EQUAL(summary.GetMeanLatencyToThereNs(), -1);
+        ASSERT_EQUAL(summary.GetRttQuantileNs(0.5), -1);
+
+        // RTTs of 100, 200 and 600
+        summary.RecordSent();
+        summary.RecordReply(40, 60);
+        ASSERT_EQUAL(summary.GetSampleStdRttNs(), 0.0);
+        summary.RecordSent();
+        summary.RecordReply(150, 50);
+        summary.RecordReply(300, 300);
+        ASSERT_EQUAL(summary.GetNumSent(), 4);
+        ASSERT_EQUAL(summary.GetNumReplies(), 3);
+        ASSERT_EQUAL(summary.GetNumLost(), 1);
+        ASSERT_EQUAL(summary.GetMinRttNs(), 100);
+        ASSERT_EQUAL(summary.GetMaxRttNs(), 600);
+        ASSERT_EQUAL_APPROX(summary.GetMeanRttNs(), 300.0, 0.000001);
+        ASSERT_EQUAL_APPROX(summary.GetSampleStdRttNs(), std::sqrt((200.0 * 200.0 + 100.0 * 100.0 + 300.0 * 300.0) / 2.0), 0.000001);
+        ASSERT_EQUAL_APPROX(summary.GetMeanLatencyToThereNs(), 490.0 / 3.0, 0.000001);
+        ASSERT_EQUAL_APPROX(summary.GetMeanLatencyFromThereNs(), 410.0 / 3.0, 0.000001);
+        ASSERT_TRUE(std::abs(summary.GetRttQuantileNs(0.5) - 200) <= 200 * RttSummary::RTT_QUANTILE_RELATIVE_ACCURACY);
+        ASSERT_EQUAL(summary.GetRttQuantileNs(0.0), 100); // Clamped to the exact minimum and maximum
+        ASSERT_EQUAL(summary.GetRttQuantileNs(1.0), 600);
+
+        // Merging is the same as recording all into one
+        std::mt19937_64 rng(987654321);
+        RttSummary all;
+        RttSummary a;
+        RttSummary b;
+        for (int i = 0; i < 1000; i++) {
+            int64_t there = 1000 + rng() % 100000;
+            int64_t back = 1000 + rng() % 100000;
+            RttSummary& part = (rng() % 4 == 0) ? a : b;
+            all.RecordSent();
+            part.RecordSent();
+            if (rng() % 10 != 0) {
+                all.RecordReply(there, back);
+                part.RecordReply(there, back);
+            }
+        }
+        a.Merge(b);
+        a.Merge(RttSummary());
+        ASSERT_EQUAL(a.GetNumSent(), all.GetNumSent());
+        ASSERT_EQUAL(a.GetNumReplies(), all.GetNumReplies());
+        ASSERT_EQUAL(a.GetMinRttNs(), all.GetMinRttNs());
+        ASSERT_EQUAL(a.GetMaxRttNs(), all.GetMaxRttNs());
+        ASSERT_EQUAL_APPROX(a.GetMeanRttNs(), all.GetMeanRttNs(), 0.001);
+        ASSERT_EQUAL_APPROX(a.GetSampleStdRttNs(), all.GetSampleStdRttNs(), 0.001);
+        ASSERT_EQUAL_APPROX(a.GetMeanLatencyToThereNs(), all.GetMeanLatencyToThereNs(), 0.001);
+        for (double q : {0.5, 0.99, 0.999}) {
+            ASSERT_EQUAL(a.GetRttQuantileNs(q), all.GetRttQuantileNs(q));
+        }
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,8 @@
 #include "ns3/test.h"
 #include "ns3/exp-util.h"
 #include "ns3/schedule-reader.h"
+#include "ns3/schedule-binary.h"
+#include "ns3/schedule-stream.h"
 #include "ns3/topology-ptop.h"
 #include "ns3/ipv4-arbiter-routing-helper.h"
 #include "test-helpers.h"
@@ -20,8 +22,10 @@ void cleanup_schedule_reader_test() {
     remove_file_if_exists(schedule_reader_test_dir + "/config_ns3.properties");
     remove_file_if_exists(schedule_reader_test_dir + "/topology.properties");
     remove_file_if_exists(schedule_reader_test_dir + "/schedule.csv");
+    remove_file_if_exists(schedule_reader_test_dir + "/schedule.bin");
     remove_file_if_exists(schedule_reader_test_dir + "/logs_ns3/finished.txt");
     remove_file_if_exists(schedule_reader_test_dir + "/logs_ns3/timing_results.txt");
+    remove_file_if_exists(schedule_reader_test_dir + "/logs_ns3/route_cache.csv");
     remove_dir_if_exists(schedule_reader_test_dir + "/logs_ns3");
     remove_dir_if_exists(schedule_reader_test_dir);
 }
@@ -226,3 +230,229 @@ public:
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////
+
+class ScheduleReaderBinaryTestCase : public TestCase
+{
+public:
+    ScheduleReaderBinaryTestCase () : TestCase ("schedule-reader binary") {};
+
+    void DoRun () {
+        prepare_schedule_reader_test_config();
+
+        std::ofstream schedule_file;
+        std::string csv_filename = schedule_reader_test_dir + "/schedule.csv";
+        std::string binary_filename = schedule_reader_test_dir + "/schedule.bin";
+
+        std::ofstream config_file(schedule_reader_test_dir + "/config_ns3.properties");
+        config_file << "filename_topology=\"topology.properties\"" << std::endl;
+        config_file << "filename_schedule=\"schedule.bin\"" << std::endl;
+        config_file << "simulation_end_time_ns=10000000000" << std::endl;
+        config_file << "simulation_seed=123456789" << std::endl;
+        config_file << "link_data_rate_megabit_per_s=100.0" << std::endl;
+        config_file << "link_delay_ns=10000" << std::endl;
+        config_file << "link_max_queue_size_pkts=100" << std::endl;
+        config_file << "disable_qdisc_endpoint_tors_xor_servers=true" << std::endl;
+        config_file << "disable_qdisc_non_endpoint_switches=true" << std::endl;
+        config_file.close();
+
+        std::ofstream topology_file;
+        topology_file.open (schedule_reader_test_dir + "/topology.properties");
+        topology_file << "num_nodes=5" << std::endl;
+        topology_file << "num_undirected_edges=4" << std::endl;
+        topology_file << "switches=set(0,1,2,3,4)" << std::endl;
+        topology_file << "switches_which_are_tors=set(0,1,3,4)" << std::endl; // Only 2 cannot be endpoint
+        topology_file << "servers=set()" << std::endl;
+        topology_file << "undirected_edges=set(0-1,1-2,2-3,3-4)" << std::endl;
+        topology_file.close();
+
+        Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(schedule_reader_test_dir);
+        Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+
+        // Normal: the binary schedule must read the same as the schedule.csv
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,0,1,100000,47327,a=b,test" << std::endl;
+        schedule_file << "1,4,3,7488338,1356567,a=b2," << std::endl;
+        schedule_file << "2,3,0,1,1356567,a=b,test" << std::endl;
+        schedule_file << "3,1,4,0,2000000,," << std::endl;
+        schedule_file.close();
+        ASSERT_FALSE(is_binary_schedule(csv_filename));
+        ASSERT_EQUAL(convert_schedule_csv_to_binary(csv_filename, binary_filename), 4);
+        ASSERT_TRUE(is_binary_schedule(binary_filename));
+        std::vector<schedule_entry_t> schedule_csv = read_schedule(csv_filename, topology, 10000000);
+        std::vector<schedule_entry_t> schedule_binary = read_schedule(binary_filename, topology, 10000000);
+        ASSERT_EQUAL(schedule_binary.size(), 4);
+        for (size_t i = 0; i < 4; i++) {
+            ASSERT_EQUAL(schedule_binary[i].flow_id, schedule_csv[i].flow_id);
+            ASSERT_EQUAL(schedule_binary[i].from_node_id, schedule_csv[i].from_node_id);
+            ASSERT_EQUAL(schedule_binary[i].to_node_id, schedule_csv[i].to_node_id);
+            ASSERT_EQUAL(schedule_binary[i].size_byte, schedule_csv[i].size_byte);
+            ASSERT_EQUAL(schedule_binary[i].start_time_ns, schedule_csv[i].start_time_ns);
+            ASSERT_EQUAL(schedule_binary[i].additional_parameters, schedule_csv[i].additional_parameters);
+            ASSERT_EQUAL(schedule_binary[i].metadata, schedule_csv[i].metadata);
+        }
+
+        // Entries are only materialized when requested
+        Ptr<ScheduleBinary> binary = CreateObject<ScheduleBinary>(binary_filename, topology, 10000000);
+        ASSERT_EQUAL(binary->GetNumEntries(), 4);
+        ASSERT_EQUAL(binary->GetStartTimeNs(1), 1356567);
+        ASSERT_EQUAL(binary->GetEntry(1).additional_parameters, "a=b2");
+        ASSERT_EQUAL(binary->GetEntry(1).metadata, "");
+        ASSERT_EXCEPTION(binary->GetEntry(4));
+
+        // Strings are only stored once ("", "a=b", "test", "a=b2")
+        ASSERT_EQUAL(binary->GetFileSizeByte(), 40 + 4 * sizeof(schedule_binary_record_t) + 5 * 8 + 3 + 4 + 4);
+        binary = nullptr;
+
+        // Empty
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file.close();
+        ASSERT_EQUAL(convert_schedule_csv_to_binary(csv_filename, binary_filename), 0);
+        ASSERT_EQUAL(read_schedule(binary_filename, topology, 10000000).size(), 0);
+
+        // Invalid endpoints and start times depend on the run, as such they are only checked when read
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,2,4,100000,1356567,a=b,test" << std::endl;
+        schedule_file.close();
+        convert_schedule_csv_to_binary(csv_filename, binary_filename);
+        ASSERT_EXCEPTION(read_schedule(binary_filename, topology, 10000000));
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,3,4,86959,10000000,a=b,test" << std::endl;
+        schedule_file.close();
+        convert_schedule_csv_to_binary(csv_filename, binary_filename);
+        ASSERT_EXCEPTION(read_schedule(binary_filename, topology, 10000000));
+
+        // Not ascending flow ID, not ordered time and to itself are already refused by the conversion
+        remove_file_if_exists(binary_filename);
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "1,3,4,100000,1356567,a=b,test" << std::endl;
+        schedule_file.close();
+        ASSERT_EXCEPTION(convert_schedule_csv_to_binary(csv_filename, binary_filename));
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,3,4,86959,10000,a=b,test" << std::endl;
+        schedule_file << "1,3,4,86959,9999,a=b,test" << std::endl;
+        schedule_file.close();
+        ASSERT_EXCEPTION(convert_schedule_csv_to_binary(csv_filename, binary_filename));
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,3,3,100000,1356567,a=b,test" << std::endl;
+        schedule_file.close();
+        ASSERT_EXCEPTION(convert_schedule_csv_to_binary(csv_filename, binary_filename));
+        ASSERT_FALSE(file_exists(binary_filename));
+
+        // Truncated
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,3,4,100000,1356567,a=b,test" << std::endl;
+        schedule_file.close();
+        convert_schedule_csv_to_binary(csv_filename, binary_filename);
+        ASSERT_EQUAL(truncate(binary_filename.c_str(), 60), 0);
+        ASSERT_TRUE(is_binary_schedule(binary_filename));
+        ASSERT_EXCEPTION(read_schedule(binary_filename, topology, 10000000));
+
+        basicSimulation->Finalize();
+        cleanup_schedule_reader_test();
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class ScheduleReaderStreamTestCase : public TestCase
+{
+public:
+    ScheduleReaderStreamTestCase () : TestCase ("schedule-reader stream") {};
+
+    void DoRun () {
+        prepare_schedule_reader_test_config();
+
+        std::ofstream schedule_file;
+        std::string csv_filename = schedule_reader_test_dir + "/schedule.csv";
+        std::string binary_filename = schedule_reader_test_dir + "/schedule.bin";
+
+        std::ofstream config_file(schedule_reader_test_dir + "/config_ns3.properties");
+        config_file << "filename_topology=\"topology.properties\"" << std::endl;
+        config_file << "filename_schedule=\"schedule.csv\"" << std::endl;
+        config_file << "simulation_end_time_ns=10000000000" << std::endl;
+        config_file << "simulation_seed=123456789" << std::endl;
+        config_file << "link_data_rate_megabit_per_s=100.0" << std::endl;
+        config_file << "link_delay_ns=10000" << std::endl;
+        config_file << "link_max_queue_size_pkts=100" << std::endl;
+        config_file << "disable_qdisc_endpoint_tors_xor_servers=true" << std::endl;
+        config_file << "disable_qdisc_non_endpoint_switches=true" << std::endl;
+        config_file.close();
+
+        std::ofstream topology_file;
+        topology_file.open (schedule_reader_test_dir + "/topology.properties");
+        topology_file << "num_nodes=5" << std::endl;
+        topology_file << "num_undirected_edges=4" << std::endl;
+        topology_file << "switches=set(0,1,2,3,4)" << std::endl;
+        topology_file << "switches_which_are_tors=set(0,1,3,4)" << std::endl; // Only 2 cannot be endpoint
+        topology_file << "servers=set()" << std::endl;
+        topology_file << "undirected_edges=set(0-1,1-2,2-3,3-4)" << std::endl;
+        topology_file.close();
+
+        Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(schedule_reader_test_dir);
+        Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+
+        // Ten flows
+        schedule_file = std::ofstream(csv_filename);
+        for (int i = 0; i < 10; i++) {
+            schedule_file << i << "," << (i % 2 == 0 ? 0 : 3) << ",4," << 1000 + i << "," << 100 * (i / 3) << ",a=" << i << ",m" << i << std::endl;
+        }
+        schedule_file.close();
+        convert_schedule_csv_to_binary(csv_filename, binary_filename);
+        std::vector<schedule_entry_t> schedule = read_schedule(csv_filename, topology, 10000000);
+
+        // Streamed in windows of 3 it must be the same, regardless of the format
+        for (std::string filename : {csv_filename, binary_filename}) {
+            Ptr<ScheduleStream> stream = CreateObject<ScheduleStream>(filename, topology, 10000000, 3);
+            ASSERT_EQUAL(stream->IsBinary(), filename == binary_filename);
+            ASSERT_EQUAL(stream->GetNumEntries(), 10);
+            ASSERT_EQUAL(stream->GetWindowSize(), 3);
+            ASSERT_EQUAL(stream->GetNumWindowsRead(), 0);
+            for (int i = 0; i < 10; i++) {
+                ASSERT_TRUE(stream->HasNext());
+                ASSERT_EQUAL(stream->PeekNext().flow_id, i);
+                schedule_entry_t entry = stream->Next();
+                ASSERT_EQUAL(entry.flow_id, schedule[i].flow_id);
+                ASSERT_EQUAL(entry.from_node_id, schedule[i].from_node_id);
+                ASSERT_EQUAL(entry.to_node_id, schedule[i].to_node_id);
+                ASSERT_EQUAL(entry.size_byte, schedule[i].size_byte);
+                ASSERT_EQUAL(entry.start_time_ns, schedule[i].start_time_ns);
+                ASSERT_EQUAL(entry.additional_parameters, schedule[i].additional_parameters);
+                ASSERT_EQUAL(entry.metadata, schedule[i].metadata);
+                ASSERT_EQUAL(stream->GetNumWindowsRead(), i / 3 + 1);
+            }
+            ASSERT_FALSE(stream->HasNext());
+            ASSERT_EXCEPTION(stream->Next());
+        }
+
+        // Window size must be at least one
+        ASSERT_EXCEPTION(CreateObject<ScheduleStream>(csv_filename, topology, 10000000, 0));
+
+        // The entire schedule is checked up front, also the flows after the first window
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,0,4,100000,100,a=b,test" << std::endl;
+        schedule_file << "1,0,4,100000,100,a=b,test" << std::endl;
+        schedule_file << "2,0,4,100000,99,a=b,test" << std::endl;
+        schedule_file.close();
+        ASSERT_EXCEPTION(CreateObject<ScheduleStream>(csv_filename, topology, 10000000, 1));
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file << "0,0,4,100000,100,a=b,test" << std::endl;
+        schedule_file << "1,0,2,100000,100,a=b,test" << std::endl;
+        schedule_file.close();
+        ASSERT_EXCEPTION(CreateObject<ScheduleStream>(csv_filename, topology, 10000000, 1));
+        ASSERT_EXCEPTION(CreateObject<ScheduleStream>("does-not-exist-temp.file", topology, 10000000, 1));
+
+        // Empty
+        schedule_file = std::ofstream(csv_filename);
+        schedule_file.close();
+        Ptr<ScheduleStream> stream_empty = CreateObject<ScheduleStream>(csv_filename, topology, 10000000, 3);
+        ASSERT_EQUAL(stream_empty->GetNumEntries(), 0);
+        ASSERT_FALSE(stream_empty->HasNext());
+
+        basicSimulation->Finalize();
+        cleanup_schedule_reader_test();
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -1,108 +1,122 @@
 #include "arbiter-ecmp-helper.h"
 
+#include <sstream>
+
 namespace ns3 {
 
 void ArbiterEcmpHelper::InstallArbiters (Ptr<BasicSimulation> basicSimulation, Ptr<TopologyPtop> topology) {
+    InstallArbiters(basicSimulation, topology, nullptr);
+}
+
+void ArbiterEcmpHelper::InstallArbiters (Ptr<BasicSimulation> basicSimulation, Ptr<TopologyPtop> topology, Ptr<EcmpNextHopTable> global_ecmp_state) {
     std::cout << "SETUP ECMP ROUTING" << std::endl;
 
     NodeContainer nodes = topology->GetNodes();
 
-    // Calculate and instantiate the routing
-    std::cout << "  > Calculating ECMP routing" << std::endl;
-    std::vector<std::vector<std::vector<uint32_t>>> global_ecmp_state = CalculateGlobalState(topology);
+    // Number of threads used to calculate the routing state (0 means: as many as there are hardware threads)
+    int64_t num_threads = parse_positive_int64(basicSimulation->GetConfigParamOrDefault("ecmp_routing_num_threads", "0"));
+    if (num_threads == 0) {
+        num_threads = std::max((int64_t) 1, (int64_t) std::thread::hardware_concurrency());
+    }
+
+    // Hash function applied to the 5-tuple
+    std::string hash_function_name = basicSimulation->GetConfigParamOrDefault("ecmp_hash_function", "murmur3");
+    EcmpHashFunction hash_function = parse_ecmp_hash_function(hash_function_name);
+
+    // Whether the flow hash is stamped onto the packet at the first hop and re-used at every next hop
+    bool enable_flow_hash_tag = parse_boolean(basicSimulation->GetConfigParamOrDefault("ecmp_enable_flow_hash_tag", "false"));
+
+    // Directory of the on-disk routing cache (relative to the run directory, empty means no cache)
+    std::string cache_dir = basicSimulation->GetConfigParamOrDefault("ecmp_routing_cache_dir", "");
+
+    // Whether the route cache counters of each node are written to route_cache.csv at the end
+    bool enable_route_cache_statistics = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_route_cache_statistics", "false"));
+
+    // Calculate the routing (or load it from the cache), unless it is given
+    if (global_ecmp_state == nullptr) {
+        if (cache_dir.empty()) {
+            std::cout << "  > Calculating ECMP routing (BFS per destination using " << num_threads << " thread(s))" << std::endl;
+            global_ecmp_state = CalculateGlobalState(topology, num_threads);
+        } else {
+            if (!starts_with(cache_dir, "/")) {
+                cache_dir = basicSimulation->GetRunDir() + "/" + cache_dir;
+            }
+            std::string topology_filename = basicSimulation->GetRunDir() + "/" + basicSimulation->GetConfigParamOrFail("filename_topology");
+            global_ecmp_state = CalculateOrLoadGlobalState(topology, num_threads, topology_filename, cache_dir);
+        }
+    } else {
+        if (global_ecmp_state->GetNumNodes() != topology->GetNumNodes()) {
+            throw std::invalid_argument("Given ECMP routing state is not of a topology with the same number of nodes");
+        }
+        std::cout << "  > Re-using ECMP routing state calculated before" << std::endl;
+    }
+    std::cout << "  > Next-hop table: " << global_ecmp_state->GetMemoryReport() << std::endl;
     basicSimulation->RegisterTimestamp("Calculate ECMP routing state");
 
-    std::cout << "  > Setting the routing arbiter on each node" << std::endl;
+    // Instantiate the routing
+    std::cout << "  > Setting the routing arbiter on each node (hash function: " << hash_function_name << (enable_flow_hash_tag ? ", flow hash tag" : "") << ")" << std::endl;
     for (int i = 0; i < topology->GetNumNodes(); i++) {
-        Ptr<ArbiterEcmp> arbiterEcmp = CreateObject<ArbiterEcmp>(nodes.Get(i), nodes, topology, global_ecmp_state[i]);
+        Ptr<ArbiterEcmp> arbiterEcmp = CreateObject<ArbiterEcmp>(nodes.Get(i), nodes, topology, global_ecmp_state, hash_function, enable_flow_hash_tag);
         nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4ArbiterRouting>()->SetArbiter(arbiterEcmp);
     }
     basicSimulation->RegisterTimestamp("Setup routing arbiter on each node");
+    if (enable_route_cache_statistics) {
+        basicSimulation->RegisterFinalizeCallback(MakeBoundCallback(&Ipv4ArbiterRoutingHelper::WriteRouteCacheStatistics, basicSimulation->GetLogsDir(), nodes));
+    }
 
     std::cout << std::endl;
 }
 
 // This is static
-std::vector<std::vector<std::vector<uint32_t>>> ArbiterEcmpHelper::CalculateGlobalState(Ptr<TopologyPtop> topology) {
-
-    // Final result
-    std::vector<std::vector<std::vector<uint32_t>>> global_candidate_list;
-
-    ///////////////////////////
-    // Floyd-Warshall
-
-    int64_t n = topology->GetNumNodes();
-
-    // Enforce that more than 40000 nodes is not permitted (sqrt(2^31) ~= 46340, so let's call it an even 40000)
-    if (n > 40000) {
-        throw std::runtime_error("Cannot handle more than 40000 nodes");
-    }
-
-    // Initialize with 0 distance to itself, and infinite distance to all others
-    int32_t x = n*n;
-    int32_t* dist = new int32_t[x];
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (i == j) {
-                dist[n * i + j] = 0;
-            } else {
-                dist[n * i + j] = 100000000;
-            }
-        }
-    }
+Ptr<EcmpNextHopTable> ArbiterEcmpHelper::CalculateGlobalState(Ptr<TopologyPtop> topology, int64_t num_threads) {
+    return CreateObject<EcmpNextHopTable>(topology->GetAllAdjacencyLists(), num_threads);
+}
 
-    // If there is an edge, the distance is 1
-    for (std::pair<int64_t, int64_t> edge : topology->GetUndirectedEdges()) {
-        dist[n * edge.first + edge.second] = 1;
-        dist[n * edge.second + edge.first] = 1;
-    }
+// This is static
+std::string ArbiterEcmpHelper::GetRoutingCacheFilename(const std::string& topology_filename) {
 
-    // Floyd-Warshall core
-    for (int k = 0; k < n; k++) {
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                if (dist[n * i + j] > dist[n * i + k] + dist[n * k + j]) {
-                    dist[n * i + j] = dist[n * i + k] + dist[n * k + j];
-                }
-            }
-        }
+    // Content-addressed: the same topology file content always maps onto the same cache file
+    std::ifstream ifs(topology_filename, std::ifstream::binary);
+    if (!ifs) {
+        throw std::runtime_error(format_string("Topology file %s could not be read.", topology_filename.c_str()));
     }
+    std::stringstream content;
+    content << ifs.rdbuf();
+    uint64_t hash = Hasher().GetHash64(content.str());
+    return format_string("ecmp_next_hop_table_%016" PRIx64 ".bin", hash);
 
-    ///////////////////////////
-    // Determine from the shortest path distances
-    // the possible next hops
+}
 
-    // ECMP candidate list: candidate_list[current][destination] = [ list of next hops ]
-    global_candidate_list.reserve(topology->GetNumNodes());
-    for (int i = 0; i < topology->GetNumNodes(); i++) {
-        std::vector<std::vector<uint32_t>> v;
-        v.reserve(topology->GetNumNodes());
-        for (int j = 0; j < topology->GetNumNodes(); j++) {
-            v.push_back(std::vector<uint32_t>());
-        }
-        global_candidate_list.push_back(v);
-    }
+// This is static
+Ptr<EcmpNextHopTable> ArbiterEcmpHelper::CalculateOrLoadGlobalState(Ptr<TopologyPtop> topology, int64_t num_threads, const std::string& topology_filename, const std::string& cache_dir) {
+    return CalculateOrLoadGlobalState(topology->GetAllAdjacencyLists(), num_threads, topology_filename, cache_dir);
+}
 
-    // Candidate next hops are determined in the following way:
-    // For each edge a -> b, for a destination t:
-    // If the shortest_path_distance(b, t) == shortest_path_distance(a, t) - 1
-    // then a -> b must be part of a shortest path from a towards t.
-    for (std::pair<int64_t, int64_t> edge : topology->GetUndirectedEdges()) {
-        for (int j = 0; j < n; j++) {
-            if (dist[edge.first * n + j] - 1 == dist[edge.second * n + j]) {
-                global_candidate_list[edge.first][j].push_back(edge.second);
-            }
-            if (dist[edge.second * n + j] - 1 == dist[edge.first * n + j]) {
-                global_candidate_list[edge.second][j].push_back(edge.first);
+// This is static
+Ptr<EcmpNextHopTable> ArbiterEcmpHelper::CalculateOrLoadGlobalState(const std::vector<std::set<int64_t>>& adjacency_lists, int64_t num_threads, const std::string& topology_filename, const std::string& cache_dir) {
+    std::string cache_filename = cache_dir + "/" + GetRoutingCacheFilename(topology_filename);
+
+    // Cache hit
+    if (file_exists(cache_filename)) {
+        try {
+            Ptr<EcmpNextHopTable> table = CreateObject<EcmpNextHopTable>(cache_filename);
+            if (table->GetNumNodes() == (int64_t) adjacency_lists.size()) {
+                std::cout << "  > Loaded ECMP routing from cache: " << cache_filename << std::endl;
+                return table;
             }
+            std::cout << "  > Cached ECMP routing is not of this topology, re-calculating it" << std::endl;
+        } catch (std::exception& e) {
+            std::cout << "  > Cached ECMP routing could not be loaded (" << e.what() << "), re-calculating it" << std::endl;
         }
     }
 
-    // Free up the distance matrix
-    delete[] dist;
-
-    // Return the final global candidate list
-    return global_candidate_list;
+    // Cache miss: calculate and store
+    std::cout << "  > Calculating ECMP routing (BFS per destination using " << num_threads << " thread(s))" << std::endl;
+    Ptr<EcmpNextHopTable> table = CreateObject<EcmpNextHopTable>(adjacency_lists, num_threads);
+    mkdir_if_not_exists(cache_dir);
+    table->WriteToFile(cache_filename);
+    std::cout << "  > Stored ECMP routing in cache: " << cache_filename << std::endl;
+    return table;
 
 }
 
@@ -5,7 +5,9 @@
 #include "ns3/basic-simulation.h"
 #include "ns3/topology-ptop.h"
 #include "ns3/ipv4-arbiter-routing.h"
+#include "ns3/ipv4-arbiter-routing-helper.h"
 #include "ns3/arbiter-ecmp.h"
+#include "ns3/ecmp-next-hop-table.h"
 
 namespace ns3 {
 
@@ -13,8 +15,17 @@ namespace ns3 {
     {
     public:
         static void InstallArbiters (Ptr<BasicSimulation> basicSimulation, Ptr<TopologyPtop> topology);
-    private:
-        static std::vector<std::vector<std::vector<uint32_t>>> CalculateGlobalState(Ptr<TopologyPtop> topology);
+
+        // Re-use a routing state calculated before for the same topology (e.g., shared by the runs of a sweep)
+        static void InstallArbiters (Ptr<BasicSimulation> basicSimulation, Ptr<TopologyPtop> topology, Ptr<EcmpNextHopTable> global_ecmp_state);
+
+        // Made public for testing
+        static Ptr<EcmpNextHopTable> CalculateGlobalState(Ptr<TopologyPtop> topology, int64_t num_threads);
+        static std::string GetRoutingCacheFilename(const std::string& topology_filename);
+        static Ptr<EcmpNextHopTable> CalculateOrLoadGlobalState(Ptr<TopologyPtop> topology, int64_t num_threads, const std::string& topology_filename, const std::string& cache_dir);
+
+        // Of only the graph, before any node exists (e.g., once for all the runs of a sweep)
+        static Ptr<EcmpNextHopTable> CalculateOrLoadGlobalState(const std::vector<std::set<int64_t>>& adjacency_lists, int64_t num_threads, const std::string& topology_filename, const std::string& cache_dir);
     };
 
 } // namespace ns3
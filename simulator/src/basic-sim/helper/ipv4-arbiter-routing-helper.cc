@@ -16,6 +16,10 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <fstream>
+#include <tuple>
+#include <cinttypes>
+#include "ns3/ipv4.h"
 #include "ipv4-arbiter-routing-helper.h"
 
 namespace ns3 {
@@ -38,4 +42,49 @@ Ptr<Ipv4RoutingProtocol> Ipv4ArbiterRoutingHelper::Create (Ptr<Node> node) const
   return CreateObject<Ipv4ArbiterRouting> ();
 }
 
+// This is static
+void Ipv4ArbiterRoutingHelper::WriteRouteCacheStatistics(std::string logs_dir, NodeContainer nodes) {
+
+    // Only nodes which route using an arbiter have a route cache
+    std::vector<std::tuple<uint32_t, int64_t, int64_t, int64_t>> statistics;
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+        Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
+        if (ipv4 == 0) {
+            continue;
+        }
+        Ptr<Ipv4ArbiterRouting> routing = DynamicCast<Ipv4ArbiterRouting>(ipv4->GetRoutingProtocol());
+        if (routing != 0) {
+            statistics.push_back(std::make_tuple(nodes.Get(i)->GetId(), routing->GetRouteCacheSize(), routing->GetRouteCacheHits(), routing->GetRouteCacheMisses()));
+        }
+    }
+    if (statistics.empty()) {
+        return;
+    }
+
+    std::cout << "ROUTE CACHE" << std::endl;
+
+    // Write the per-node counters to file: node_id,num_cached_routes,hits,misses
+    int64_t total_size = 0;
+    int64_t total_hits = 0;
+    int64_t total_misses = 0;
+    std::ofstream fileRouteCache(logs_dir + "/route_cache.csv");
+    for (std::tuple<uint32_t, int64_t, int64_t, int64_t>& entry : statistics) {
+        fileRouteCache << std::get<0>(entry) << "," << std::get<1>(entry) << "," << std::get<2>(entry) << "," << std::get<3>(entry) << std::endl;
+        total_size += std::get<1>(entry);
+        total_hits += std::get<2>(entry);
+        total_misses += std::get<3>(entry);
+    }
+    fileRouteCache.close();
+    std::cout << "  > Cached routes: " << total_size << std::endl;
+    printf(
+            "  > Hits: %" PRId64 ", misses: %" PRId64 " (hit rate: %.2f%%)\n",
+            total_hits,
+            total_misses,
+            total_hits + total_misses == 0 ? 0.0 : (100.0 * total_hits) / (total_hits + total_misses)
+    );
+    std::cout << "  > Per-node counters written to: " << logs_dir << "/route_cache.csv" << std::endl;
+
+    std::cout << std::endl;
+}
+
 } // namespace ns3
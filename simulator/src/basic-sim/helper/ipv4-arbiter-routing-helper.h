@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv4-arbiter-routing.h"
+#include "ns3/node-container.h"
 
 namespace ns3 {
 
@@ -33,6 +34,9 @@ public:
   Ipv4ArbiterRoutingHelper* Copy (void) const;
   virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
 
+  // Write the route cache counters of the nodes which route using an arbiter to <logs_dir>/route_cache.csv
+  static void WriteRouteCacheStatistics (std::string logs_dir, NodeContainer nodes);
+
 private:
   Ipv4ArbiterRoutingHelper &operator = (const Ipv4ArbiterRoutingHelper &);
 };
@@ -18,6 +18,13 @@
  * Author: Simon, Hanjing
  */
 
+#include <cstring>
+#include <cstdarg>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <memory>
 #include "ptop-utilization-tracker-helper.h"
 
 namespace ns3 {
@@ -45,6 +52,17 @@ namespace ns3 {
             // Read in parameters
             m_utilization_interval_ns = parse_geq_one_int64(m_basicSimulation->GetConfigParamOrFail("link_utilization_tracking_interval_ns"));
             std::cout << "  > Utilization aggregation interval... " << m_utilization_interval_ns << " ns" << std::endl;
+            m_write_uncompressed = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("link_utilization_tracking_write_uncompressed", "true"));
+            std::cout << "  > Write uncompressed utilization..... " << (m_write_uncompressed ? "yes" : "no") << std::endl;
+            m_write_busy_periods = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("link_utilization_tracking_write_busy_periods", "false"));
+            std::cout << "  > Write busy periods................. " << (m_write_busy_periods ? "yes" : "no") << std::endl;
+
+            // Number of threads used to write the results (0 means: as many as there are hardware threads)
+            m_num_threads = parse_positive_int64(m_basicSimulation->GetConfigParamOrDefault("link_utilization_tracking_num_threads", "0"));
+            if (m_num_threads == 0) {
+                m_num_threads = std::max((int64_t) 1, (int64_t) std::thread::hardware_concurrency());
+            }
+            std::cout << "  > Threads to write results........... " << m_num_threads << std::endl;
             // TODO: Add additional parameter to specifically select links
 
             // Go over every edge in the topology
@@ -57,7 +75,7 @@ namespace ns3 {
                 // One tracker a -> b
                 // if (!m_enable_distributed || m_distributed_node_system_id_assignment[edge.first] == m_system_id) {
                     Ptr<PointToPointNetDevice> networkDevice_a_b = m_topology->GetNodes().Get(edge.first)->GetObject<Ipv4>()->GetNetDevice(edge_if_idxs.first)->GetObject<PointToPointNetDevice>();
-                    Ptr<PtopUtilizationTracker> tracker_a_b = CreateObject<PtopUtilizationTracker>(networkDevice_a_b, m_utilization_interval_ns);
+                    Ptr<PtopUtilizationTracker> tracker_a_b = CreateObject<PtopUtilizationTracker>(networkDevice_a_b);
                     m_utilization_trackers.push_back(tracker_a_b);
                     m_installed_edges.push_back(edge);
                 // }
@@ -65,7 +83,7 @@ namespace ns3 {
                 // One tracker b -> a
                 // if (!m_enable_distributed || m_distributed_node_system_id_assignment[edge.second] == m_system_id) {
                     Ptr<PointToPointNetDevice> networkDevice_b_a = m_topology->GetNodes().Get(edge.second)->GetObject<Ipv4>()->GetNetDevice(edge_if_idxs.second)->GetObject<PointToPointNetDevice>();
-                    Ptr<PtopUtilizationTracker> tracker_b_a = CreateObject<PtopUtilizationTracker>(networkDevice_b_a, m_utilization_interval_ns);
+                    Ptr<PtopUtilizationTracker> tracker_b_a = CreateObject<PtopUtilizationTracker>(networkDevice_b_a);
                     m_utilization_trackers.push_back(tracker_b_a);
                     m_installed_edges.push_back(std::make_pair(edge.second, edge.first));
                 // }
@@ -74,24 +92,13 @@ namespace ns3 {
             std::cout << "  > Tracking utilization on " << m_utilization_trackers.size() << " point-to-point network devices" << std::endl;
             m_basicSimulation->RegisterTimestamp("Install utilization trackers");
 
-            // Determine filenames
-            // if (m_enable_distributed) {
-            //     m_filename_utilization_csv = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_utilization.csv";
-            //     m_filename_utilization_compressed_csv = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_utilization_compressed.csv";
-            //     m_filename_utilization_compressed_txt = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_utilization_compressed.txt";
-            //     m_filename_utilization_summary_txt = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_utilization_summary.txt";
-            // } else {
-                m_filename_utilization_csv = m_basicSimulation->GetLogsDir() + "/utilization.csv";
-                m_filename_utilization_compressed_csv = m_basicSimulation->GetLogsDir() + "/utilization_compressed.csv";
-                m_filename_utilization_compressed_txt = m_basicSimulation->GetLogsDir() + "/utilization_compressed.txt";
-                m_filename_utilization_summary_txt = m_basicSimulation->GetLogsDir() + "/utilization_summary.txt";
-            // }
-
-            // Remove files if they are there
-            remove_file_if_exists(m_filename_utilization_csv);
-            remove_file_if_exists(m_filename_utilization_compressed_csv);
-            remove_file_if_exists(m_filename_utilization_compressed_txt);
-            remove_file_if_exists(m_filename_utilization_summary_txt);
+            // Remove files if they are there (the others are written entirely at the end)
+            m_filename_utilization_busy_periods_bin = m_basicSimulation->GetLogsDir() + "/utilization_busy_periods.bin";
+            remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/utilization.csv");
+            remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/utilization_compressed.csv");
+            remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/utilization_compressed.txt");
+            remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/utilization_summary.txt");
+            remove_file_if_exists(m_filename_utilization_busy_periods_bin);
 
             printf("  > Removed previous utilization tracking files if present\n");
             m_basicSimulation->RegisterTimestamp("Remove previous utilization tracking log files");
@@ -110,120 +117,338 @@ namespace ns3 {
 
         } else {
 
-            // Open CSV file
-            std::cout << "  > Opening utilization log files:" << std::endl;
-            FILE* file_utilization_csv = fopen(m_filename_utilization_csv.c_str(), "w+");
-            std::cout << "    >> Opened: " << m_filename_utilization_csv << std::endl;
-            FILE* file_utilization_compressed_csv = fopen(m_filename_utilization_compressed_csv.c_str(), "w+");
-            std::cout << "    >> Opened: " << m_filename_utilization_compressed_csv << std::endl;
-            FILE* file_utilization_compressed_txt = fopen(m_filename_utilization_compressed_txt.c_str(), "w+");
-            std::cout << "    >> Opened: " << m_filename_utilization_compressed_txt << std::endl;
-            FILE* file_utilization_summary_txt = fopen(m_filename_utilization_summary_txt.c_str(), "w+");
-            std::cout << "    >> Opened: " << m_filename_utilization_summary_txt << std::endl;
-
-            // Print headers
-            std::cout << "  > Writing utilization compressed TXT header" << std::endl;
-            fprintf(file_utilization_compressed_txt, "From     To       Interval start (ms)   Interval end (ms)     Utilization\n");
-            std::cout << "  > Writing utilization summary TXT header" << std::endl;
-            fprintf(file_utilization_summary_txt, "From     To       Utilization\n");
-
-            // Go over every tracker
-            std::cout << "  > Writing utilization log files" << std::endl;
-            for (size_t i = 0; i < m_utilization_trackers.size(); i++) {
-
-                // Tracker
-                Ptr<PtopUtilizationTracker> tracker = m_utilization_trackers[i];
-
-                // Retrieve the corresponding directed edge
-                std::pair<int64_t, int64_t> directed_edge = m_installed_edges[i];
-
-                // Go over every utilization interval
-                const std::vector<std::tuple<int64_t, int64_t, int64_t>> intervals = tracker->FinalizeUtilization();
-                int64_t interval_left_side_ns = 0;
-                int64_t utilization_busy_sum_ns = 0;
-                int64_t running_busy_sum_ns = 0;
-                for (size_t j = 0; j < intervals.size(); j++) {
-                    utilization_busy_sum_ns += std::get<2>(intervals[j]);
-                    running_busy_sum_ns += std::get<2>(intervals[j]);
-
-                    // Write plain to the uncompressed CSV file:
-                    // <from>,<to>,<interval start (ns)>,<interval end (ns)>,<amount of busy in this interval (ns)>
-                    fprintf(file_utilization_csv,
-                            "%d,%d,%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
-                            (int) directed_edge.first,
-                            (int) directed_edge.second,
-                            std::get<0>(intervals[j]),
-                            std::get<1>(intervals[j]),
-                            std::get<2>(intervals[j])
-                    );
-
-                    // Compressed version:
-                    // Only write if it is the last one, or if the utilization is sufficiently different from the next
-                    bool print_compressed_line = (j == intervals.size() - 1);
-                    if (!print_compressed_line) {
-                        double util_j = ((double) std::get<2>(intervals[j])) / (double) (std::get<1>(intervals[j]) - std::get<0>(intervals[j]));
-                        double util_j_next = ((double) std::get<2>(intervals[j + 1])) / (double) (std::get<1>(intervals[j + 1]) - std::get<0>(intervals[j + 1]));
-                        if (std::abs(util_j - util_j_next) >= UTILIZATION_TRACKER_COMPRESSION_APPROXIMATELY_NOT_EQUAL) { // Approximately not equal
-                            print_compressed_line = true;
-                        }
-                    }
-                    if (print_compressed_line) {
+            // End the tracking, only the busy periods were logged while running
+            std::vector<BusyPeriodLog> busy_period_logs;
+            int64_t num_busy_periods = 0;
+            size_t num_busy_period_bytes = 0;
+            for (Ptr<PtopUtilizationTracker> tracker : m_utilization_trackers) {
+                busy_period_logs.push_back(tracker->FinalizeUtilization());
+                num_busy_periods += busy_period_logs.back().GetNumBusyPeriods();
+                num_busy_period_bytes += busy_period_logs.back().GetData().size();
+            }
+            std::cout << "  > Busy periods: " << num_busy_periods << " (" << num_busy_period_bytes << " byte)" << std::endl;
+            m_basicSimulation->RegisterTimestamp("Finalize utilization trackers");
 
-                        // Write plain to the compressed CSV file:
-                        // <from>,<to>,<interval start (ns)>,<interval end (ns)>,<amount of busy in this interval (ns)>
-                        fprintf(file_utilization_compressed_csv,
-                                "%d,%d,%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
-                                (int) directed_edge.first,
-                                (int) directed_edge.second,
-                                interval_left_side_ns,
-                                std::get<1>(intervals[j]),
-                                running_busy_sum_ns
-                        );
+            // Busy periods, from which the utilization can be derived again later for any interval
+            if (m_write_busy_periods) {
+                WriteBusyPeriodLogs(m_filename_utilization_busy_periods_bin, m_installed_edges, busy_period_logs);
+                std::cout << "  > Written: " << m_filename_utilization_busy_periods_bin << std::endl;
+            }
+
+            // Utilization intervals
+            std::cout << "  > Writing utilization log files (using " << m_num_threads << " thread(s))" << std::endl;
+            int64_t num_compressed_intervals = WriteUtilizationFiles(
+                    m_basicSimulation->GetLogsDir(), m_installed_edges, busy_period_logs, m_utilization_interval_ns, m_write_uncompressed, m_num_threads
+            );
+            std::cout << "  > Compressed intervals: " << num_compressed_intervals << std::endl;
+
+            // Register completion
+            std::cout << "  > Utilization log files have been written" << std::endl;
+            m_basicSimulation->RegisterTimestamp("Write utilization log files");
+
+        }
+
+        std::cout << std::endl;
+    }
 
-                        // Write nicely formatted to the TXT file
-                        fprintf(file_utilization_compressed_txt,
-                                "%-8d %-8d %-21.2f %-21.2f %.2f%%\n",
+    // Number of directed edges of which the utilization is formatted together by one thread
+    static const size_t UTILIZATION_SHARD_NUM_EDGES = 16;
+
+    // Formatted content of each of the utilization log files for a contiguous range of directed edges
+    typedef struct utilization_shard {
+        std::string csv;
+        std::string compressed_csv;
+        std::string compressed_txt;
+        std::string summary_txt;
+        int64_t num_compressed_intervals;
+    } utilization_shard_t;
+
+    static inline void append_format(std::string& out, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        va_list args_retry;
+        va_copy(args_retry, args);
+        char line[256];
+        int n = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (n < 0) {
+            va_end(args_retry);
+            throw std::runtime_error("Could not format a utilization log line");
+        }
+        if ((size_t) n < sizeof(line)) {
+            out.append(line, n);
+        } else {
+            // Longer than the line buffer: formatted again, directly at the end of the output
+            size_t old_size = out.size();
+            out.resize(old_size + n + 1);
+            vsnprintf(&out[old_size], n + 1, format, args_retry);
+            out.resize(old_size + n);
+        }
+        va_end(args_retry);
+    }
+
+    static inline void write_or_fail(const std::string& data, FILE* file, const std::string& filename) {
+        if (fwrite(data.data(), 1, data.size(), file) != data.size()) {
+            throw std::runtime_error(format_string("Could not write utilization log file: %s", filename.c_str()));
+        }
+    }
+
+    static inline void flush_or_fail(FILE* file, const std::string& filename) {
+        if (file != nullptr && fflush(file) != 0) {
+            throw std::runtime_error(format_string("Could not write utilization log file: %s", filename.c_str()));
+        }
+    }
+
+    /**
+     * Format the utilization of the directed edges [from, to) into a shard, exactly as they appear in the files.
+     */
+    static void format_utilization_shard(
+            utilization_shard_t& shard,
+            size_t from,
+            size_t to,
+            const std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+            const std::vector<BusyPeriodLog>& busy_period_logs,
+            int64_t interval_ns,
+            bool write_uncompressed
+    ) {
+        shard.num_compressed_intervals = 0;
+        for (size_t i = from; i < to; i++) {
+            const BusyPeriodLog& busy_period_log = busy_period_logs[i];
+            std::pair<int64_t, int64_t> directed_edge = directed_edges[i];
+
+            // Write plain every interval to the uncompressed CSV file:
+            // <from>,<to>,<interval start (ns)>,<interval end (ns)>,<amount of busy in this interval (ns)>
+            if (write_uncompressed) {
+                busy_period_log.ForEachInterval(interval_ns, [&](int64_t start_ns, int64_t num_intervals, int64_t length_ns, int64_t busy_ns) {
+                    for (int64_t k = 0; k < num_intervals; k++) {
+                        append_format(shard.csv,
+                                "%d,%d,%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
                                 (int) directed_edge.first,
                                 (int) directed_edge.second,
-                                interval_left_side_ns / 1000000.0,
-                                std::get<1>(intervals[j]) / 1000000.0,
-                                ((double) running_busy_sum_ns) / ((double) (std::get<1>(intervals[j]) - interval_left_side_ns)) * 100.0
+                                start_ns + k * length_ns,
+                                start_ns + (k + 1) * length_ns,
+                                busy_ns
                         );
-
-                        interval_left_side_ns = std::get<1>(intervals[j]);
-                        running_busy_sum_ns = 0;
-
                     }
-                }
+                });
+            }
+
+            // Go over every compressed utilization interval
+            std::vector<std::tuple<int64_t, int64_t, int64_t>> compressed_intervals = busy_period_log.GetCompressedUtilization(interval_ns);
+            int64_t utilization_busy_sum_ns = 0;
+            for (size_t j = 0; j < compressed_intervals.size(); j++) {
+                int64_t interval_start_ns = std::get<0>(compressed_intervals[j]);
+                int64_t interval_end_ns = std::get<1>(compressed_intervals[j]);
+                int64_t busy_ns = std::get<2>(compressed_intervals[j]);
+                utilization_busy_sum_ns += busy_ns;
+
+                // Write plain to the compressed CSV file:
+                // <from>,<to>,<interval start (ns)>,<interval end (ns)>,<amount of busy in this interval (ns)>
+                append_format(shard.compressed_csv,
+                        "%d,%d,%" PRId64 ",%" PRId64 ",%" PRId64 "\n",
+                        (int) directed_edge.first,
+                        (int) directed_edge.second,
+                        interval_start_ns,
+                        interval_end_ns,
+                        busy_ns
+                );
 
-                // Write nicely formatted to the summary TXT file
-                fprintf(file_utilization_summary_txt,
-                        "%-8d %-8d %.2f%%\n",
+                // Write nicely formatted to the TXT file
+                append_format(shard.compressed_txt,
+                        "%-8d %-8d %-21.2f %-21.2f %.2f%%\n",
                         (int) directed_edge.first,
                         (int) directed_edge.second,
-                        ((double) utilization_busy_sum_ns) / (std::get<1>(intervals[intervals.size() - 1])) * 100.0
+                        interval_start_ns / 1000000.0,
+                        interval_end_ns / 1000000.0,
+                        ((double) busy_ns) / ((double) (interval_end_ns - interval_start_ns)) * 100.0
                 );
 
             }
+            shard.num_compressed_intervals += compressed_intervals.size();
 
-            // Close log files
-            std::cout << "  > Closing utilization log files:" << std::endl;
-            fclose(file_utilization_csv);
-            std::cout << "    >> Closed: " << m_filename_utilization_csv << std::endl;
-            fclose(file_utilization_compressed_csv);
-            std::cout << "    >> Closed: " << m_filename_utilization_compressed_csv << std::endl;
-            fclose(file_utilization_compressed_txt);
-            std::cout << "    >> Closed: " << m_filename_utilization_compressed_txt << std::endl;
-            fclose(file_utilization_summary_txt);
-            std::cout << "    >> Closed: " << m_filename_utilization_summary_txt << std::endl;
+            // Write nicely formatted to the summary TXT file
+            append_format(shard.summary_txt,
+                    "%-8d %-8d %.2f%%\n",
+                    (int) directed_edge.first,
+                    (int) directed_edge.second,
+                    busy_period_log.GetEndNs() == 0 ? 0.0 : ((double) utilization_busy_sum_ns) / ((double) busy_period_log.GetEndNs()) * 100.0
+            );
 
-            // Register completion
-            std::cout << "  > Utilization log files have been written" << std::endl;
-            m_basicSimulation->RegisterTimestamp("Write utilization log files");
+        }
+    }
 
+    int64_t PtopUtilizationTrackerHelper::WriteUtilizationFiles(
+            std::string logs_dir,
+            const std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+            const std::vector<BusyPeriodLog>& busy_period_logs,
+            int64_t interval_ns,
+            bool write_uncompressed,
+            int64_t num_threads
+    ) {
+        if (num_threads < 1) {
+            throw std::invalid_argument("Number of threads to write the utilization log files must be at least 1");
         }
 
-        std::cout << std::endl;
+        // Open files (they are closed when they go out of scope, as such also if one cannot be opened or formatting fails)
+        std::string filename_utilization_csv = logs_dir + "/utilization.csv";
+        std::string filename_utilization_compressed_csv = logs_dir + "/utilization_compressed.csv";
+        std::string filename_utilization_compressed_txt = logs_dir + "/utilization_compressed.txt";
+        std::string filename_utilization_summary_txt = logs_dir + "/utilization_summary.txt";
+        std::unique_ptr<FILE, decltype(&fclose)> file_utilization_csv(
+                write_uncompressed ? fopen(filename_utilization_csv.c_str(), "w+") : nullptr, &fclose
+        );
+        std::unique_ptr<FILE, decltype(&fclose)> file_utilization_compressed_csv(fopen(filename_utilization_compressed_csv.c_str(), "w+"), &fclose);
+        std::unique_ptr<FILE, decltype(&fclose)> file_utilization_compressed_txt(fopen(filename_utilization_compressed_txt.c_str(), "w+"), &fclose);
+        std::unique_ptr<FILE, decltype(&fclose)> file_utilization_summary_txt(fopen(filename_utilization_summary_txt.c_str(), "w+"), &fclose);
+        if ((write_uncompressed && file_utilization_csv == nullptr) || file_utilization_compressed_csv == nullptr
+            || file_utilization_compressed_txt == nullptr || file_utilization_summary_txt == nullptr) {
+            throw std::runtime_error(format_string("Could not open the utilization log files in: %s", logs_dir.c_str()));
+        }
+
+        // Print headers
+        write_or_fail("From     To       Interval start (ms)   Interval end (ms)     Utilization\n", file_utilization_compressed_txt.get(), filename_utilization_compressed_txt);
+        write_or_fail("From     To       Utilization\n", file_utilization_summary_txt.get(), filename_utilization_summary_txt);
+
+        // The directed edges are split into shards, which are formatted in batches of two shards per thread
+        // (such that only a batch is held in memory), after which the batch is written in order
+        size_t num_shards = (busy_period_logs.size() + UTILIZATION_SHARD_NUM_EDGES - 1) / UTILIZATION_SHARD_NUM_EDGES;
+        size_t batch_size = 2 * num_threads;
+        std::vector<utilization_shard_t> batch(batch_size);
+        int64_t num_compressed_intervals = 0;
+        for (size_t batch_start = 0; batch_start < num_shards; batch_start += batch_size) {
+            size_t batch_end = std::min(batch_start + batch_size, num_shards);
+
+            // Format the shards of the batch (the calling thread is one of the workers)
+            std::atomic<size_t> next_shard(batch_start);
+            std::exception_ptr worker_exception;
+            std::mutex worker_exception_mutex;
+            auto worker = [&]() {
+                size_t s;
+                while ((s = next_shard.fetch_add(1)) < batch_end) {
+                    utilization_shard_t& shard = batch[s - batch_start];
+                    shard.csv.clear();
+                    shard.compressed_csv.clear();
+                    shard.compressed_txt.clear();
+                    shard.summary_txt.clear();
+                    try {
+                        format_utilization_shard(
+                                shard,
+                                s * UTILIZATION_SHARD_NUM_EDGES,
+                                std::min((s + 1) * UTILIZATION_SHARD_NUM_EDGES, busy_period_logs.size()),
+                                directed_edges, busy_period_logs, interval_ns, write_uncompressed
+                        );
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(worker_exception_mutex);
+                        worker_exception = std::current_exception();
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < std::min((size_t) num_threads, batch_end - batch_start); i++) {
+                threads.push_back(std::thread(worker));
+            }
+            worker();
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            if (worker_exception) {
+                std::rethrow_exception(worker_exception);
+            }
+
+            // Write them in order
+            for (size_t s = batch_start; s < batch_end; s++) {
+                const utilization_shard_t& shard = batch[s - batch_start];
+                if (write_uncompressed) {
+                    write_or_fail(shard.csv, file_utilization_csv.get(), filename_utilization_csv);
+                }
+                write_or_fail(shard.compressed_csv, file_utilization_compressed_csv.get(), filename_utilization_compressed_csv);
+                write_or_fail(shard.compressed_txt, file_utilization_compressed_txt.get(), filename_utilization_compressed_txt);
+                write_or_fail(shard.summary_txt, file_utilization_summary_txt.get(), filename_utilization_summary_txt);
+                num_compressed_intervals += shard.num_compressed_intervals;
+            }
+
+        }
+
+        // What is still buffered is written out here, as a failure when closing would go unnoticed
+        flush_or_fail(file_utilization_csv.get(), filename_utilization_csv);
+        flush_or_fail(file_utilization_compressed_csv.get(), filename_utilization_compressed_csv);
+        flush_or_fail(file_utilization_compressed_txt.get(), filename_utilization_compressed_txt);
+        flush_or_fail(file_utilization_summary_txt.get(), filename_utilization_summary_txt);
+
+        return num_compressed_intervals;
+    }
+
+    // Binary busy period file:
+    // "UTILBP01", <number of logs>, and then for each log:
+    // <from>, <to>, <end (ns)>, <number of busy periods>, <data size (byte)> (each int64_t), <data>
+    static const char UTILIZATION_BUSY_PERIODS_MAGIC[8] = {'U', 'T', 'I', 'L', 'B', 'P', '0', '1'};
+
+    void PtopUtilizationTrackerHelper::WriteBusyPeriodLogs(
+            std::string filename,
+            const std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+            const std::vector<BusyPeriodLog>& busy_period_logs
+    ) {
+        FILE* file = fopen(filename.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error(format_string("Could not open busy period file: %s", filename.c_str()));
+        }
+        fwrite(UTILIZATION_BUSY_PERIODS_MAGIC, 1, sizeof(UTILIZATION_BUSY_PERIODS_MAGIC), file);
+        int64_t num_logs = busy_period_logs.size();
+        fwrite(&num_logs, sizeof(int64_t), 1, file);
+        for (size_t i = 0; i < busy_period_logs.size(); i++) {
+            const BusyPeriodLog& busy_period_log = busy_period_logs[i];
+            int64_t fields[5] = {
+                    directed_edges[i].first,
+                    directed_edges[i].second,
+                    busy_period_log.GetEndNs(),
+                    busy_period_log.GetNumBusyPeriods(),
+                    (int64_t) busy_period_log.GetData().size()
+            };
+            fwrite(fields, sizeof(int64_t), 5, file);
+            fwrite(busy_period_log.GetData().data(), 1, busy_period_log.GetData().size(), file);
+        }
+        bool failed = ferror(file) != 0;
+        fclose(file);
+        if (failed) {
+            throw std::runtime_error(format_string("Could not write busy period file: %s", filename.c_str()));
+        }
+    }
+
+    void PtopUtilizationTrackerHelper::ReadBusyPeriodLogs(
+            std::string filename,
+            std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+            std::vector<BusyPeriodLog>& busy_period_logs
+    ) {
+        FILE* file = fopen(filename.c_str(), "rb");
+        if (file == nullptr) {
+            throw std::runtime_error(format_string("Could not open busy period file: %s", filename.c_str()));
+        }
+        try {
+            char magic[sizeof(UTILIZATION_BUSY_PERIODS_MAGIC)];
+            int64_t num_logs;
+            if (fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+                || std::memcmp(magic, UTILIZATION_BUSY_PERIODS_MAGIC, sizeof(magic)) != 0
+                || fread(&num_logs, sizeof(int64_t), 1, file) != 1
+                || num_logs < 0) {
+                throw std::runtime_error(format_string("Not a busy period file: %s", filename.c_str()));
+            }
+            for (int64_t i = 0; i < num_logs; i++) {
+                int64_t fields[5];
+                if (fread(fields, sizeof(int64_t), 5, file) != 5 || fields[3] < 0 || fields[4] < 0) {
+                    throw std::runtime_error(format_string("Busy period file is truncated: %s", filename.c_str()));
+                }
+                std::vector<uint8_t> data(fields[4]);
+                if (fread(data.data(), 1, data.size(), file) != data.size()) {
+                    throw std::runtime_error(format_string("Busy period file is truncated: %s", filename.c_str()));
+                }
+                directed_edges.push_back(std::make_pair(fields[0], fields[1]));
+                busy_period_logs.push_back(BusyPeriodLog(std::move(data), fields[3], fields[2]));
+            }
+        } catch (...) {
+            fclose(file);
+            throw;
+        }
+        fclose(file);
     }
 
 }
@@ -21,8 +21,6 @@
 #ifndef PTOP_UTILIZATION_TRACKER_HELPER_H
 #define PTOP_UTILIZATION_TRACKER_HELPER_H
 
-#define UTILIZATION_TRACKER_COMPRESSION_APPROXIMATELY_NOT_EQUAL 0.000001
-
 #include "ns3/basic-simulation.h"
 #include "ns3/topology-ptop.h"
 #include "ns3/ptop-utilization-tracker.h"
@@ -36,6 +34,57 @@ namespace ns3 {
         PtopUtilizationTrackerHelper(Ptr<BasicSimulation> basicSimulation, Ptr<TopologyPtop> topology);
         void WriteResults();
 
+        /**
+         * Write the utilization log files (utilization.csv, utilization_compressed.csv/txt and utilization_summary.txt)
+         * into the logs directory, of which the intervals are derived from the busy period log of each directed edge.
+         *
+         * The directed edges are split into shards which are formatted in parallel, and written
+         * in order, as such the files are the same regardless of the number of threads.
+         *
+         * @param logs_dir              Logs directory
+         * @param directed_edges        Directed edge (from, to) of each busy period log
+         * @param busy_period_logs      Busy period log of each directed edge
+         * @param interval_ns           Utilization interval (ns)
+         * @param write_uncompressed    True iff utilization.csv (every interval) is written as well
+         * @param num_threads           Number of threads which format the shards (at least 1)
+         *
+         * @return Number of compressed intervals written
+         */
+        static int64_t WriteUtilizationFiles(
+                std::string logs_dir,
+                const std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+                const std::vector<BusyPeriodLog>& busy_period_logs,
+                int64_t interval_ns,
+                bool write_uncompressed,
+                int64_t num_threads
+        );
+
+        /**
+         * Write the busy period logs into a binary file, such that the utilization can be derived later for any interval.
+         *
+         * @param filename              Binary filename (e.g., logs_dir/utilization_busy_periods.bin)
+         * @param directed_edges        Directed edge (from, to) of each busy period log
+         * @param busy_period_logs      Busy period log of each directed edge
+         */
+        static void WriteBusyPeriodLogs(
+                std::string filename,
+                const std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+                const std::vector<BusyPeriodLog>& busy_period_logs
+        );
+
+        /**
+         * Read the busy period logs from a binary file written by WriteBusyPeriodLogs().
+         *
+         * @param filename              Binary filename
+         * @param directed_edges        Directed edge (from, to) of each busy period log (output)
+         * @param busy_period_logs      Busy period log of each directed edge (output)
+         */
+        static void ReadBusyPeriodLogs(
+                std::string filename,
+                std::vector<std::pair<int64_t, int64_t>>& directed_edges,
+                std::vector<BusyPeriodLog>& busy_period_logs
+        );
+
     private:
         std::vector<Ptr<PtopUtilizationTracker>> m_utilization_trackers;
         std::vector<std::pair<int64_t, int64_t>> m_installed_edges;
@@ -43,11 +92,11 @@ namespace ns3 {
         Ptr<TopologyPtop> m_topology;
         int64_t m_utilization_interval_ns;
         bool m_enabled;
+        bool m_write_uncompressed;
+        bool m_write_busy_periods;
+        int64_t m_num_threads;
 
-        std::string m_filename_utilization_csv;
-        std::string m_filename_utilization_compressed_csv;
-        std::string m_filename_utilization_compressed_txt;
-        std::string m_filename_utilization_summary_txt;
+        std::string m_filename_utilization_busy_periods_bin;
 
         uint32_t m_system_id;
         bool m_enable_distributed;
@@ -1,7 +1,68 @@
 #include "arbiter-ecmp.h"
 
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
 namespace ns3 {
 
+EcmpHashFunction parse_ecmp_hash_function(const std::string& name) {
+    if (name == "murmur3") {
+        return ECMP_HASH_MURMUR3;
+    } else if (name == "crc32c") {
+        return ECMP_HASH_CRC32C;
+    } else {
+        throw std::invalid_argument(format_string("Unknown ECMP hash function: %s (valid: murmur3, crc32c)", name.c_str()));
+    }
+}
+
+#ifndef __SSE4_2__
+
+/**
+ * Table for the CRC32-C (Castagnoli, reflected polynomial 0x82F63B78) of a single byte.
+ *
+ * @return Table of 256 entries
+ */
+static std::vector<uint32_t> create_crc32c_table() {
+    std::vector<uint32_t> table(256);
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static const std::vector<uint32_t> crc32c_table = create_crc32c_table();
+
+#endif
+
+/**
+ * CRC32-C of the hash input buffer (17 bytes).
+ *
+ * @param buff      Buffer of 17 bytes
+ *
+ * @return CRC32-C value
+ */
+static inline uint32_t crc32c_17_bytes(const char* buff) {
+    uint32_t crc = 0xFFFFFFFF;
+#ifdef __SSE4_2__
+    uint32_t word;
+    for (int i = 0; i < 16; i += 4) {
+        std::memcpy(&word, &buff[i], 4);
+        crc = _mm_crc32_u32(crc, word);
+    }
+    crc = _mm_crc32_u8(crc, (uint8_t) buff[16]);
+#else
+    for (int i = 0; i < 17; i++) {
+        crc = (crc >> 8) ^ crc32c_table[(crc ^ (uint8_t) buff[i]) & 0xFF];
+    }
+#endif
+    return crc ^ 0xFFFFFFFF;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (ArbiterEcmp);
 TypeId ArbiterEcmp::GetTypeId (void)
 {
@@ -16,16 +77,48 @@ ArbiterEcmp::ArbiterEcmp(
         Ptr<Node> this_node,
         NodeContainer nodes,
         Ptr<TopologyPtop> topology,
-        std::vector<std::vector<uint32_t>> candidate_list
+        Ptr<EcmpNextHopTable> next_hop_table,
+        EcmpHashFunction hash_function,
+        bool enable_flow_hash_tag
 ) : ArbiterPtop(this_node, nodes, topology)
 {
-    m_candidate_list = candidate_list;
+    m_next_hop_table = next_hop_table;
+    m_hash_function = hash_function;
+    m_enable_flow_hash_tag = enable_flow_hash_tag;
 }
 
 int32_t ArbiterEcmp::TopologyPtopDecide(int32_t source_node_id, int32_t target_node_id, const std::set<int64_t>& neighbor_node_ids, Ptr<const Packet> pkt, Ipv4Header const &ipHeader, bool is_request_for_source_ip_so_no_next_header) {
-    uint32_t hash = ComputeFiveTupleHash(ipHeader, pkt, m_node_id, is_request_for_source_ip_so_no_next_header);
-    int s = m_candidate_list[target_node_id].size();
-    return m_candidate_list[target_node_id][hash % s];
+    uint32_t hash;
+    if (m_enable_flow_hash_tag && !is_request_for_source_ip_so_no_next_header) {
+        hash = MixFlowHashWithNodeId(GetOrStampFlowHash(ipHeader, pkt), m_node_id);
+    } else {
+        hash = ComputeFiveTupleHash(ipHeader, pkt, m_node_id, is_request_for_source_ip_so_no_next_header);
+    }
+    return m_next_hop_table->SelectNextHop(m_node_id, target_node_id, hash);
+}
+
+/**
+ * Retrieve the flow hash from the packet tag. If the packet does not carry one yet
+ * (i.e., this is the first hop), the 5-tuple hash (without node id) is calculated
+ * and stamped onto the packet, such that subsequent hops do not need to look at its headers.
+ *
+ * A TCP source stamps it on its first routing decision. A UDP source only routes
+ * once for its source IP without the UDP header, so there the first switch stamps it.
+ *
+ * @param header    IPv4 header
+ * @param p         Packet (with the IPv4 header removed)
+ *
+ * @return Flow hash
+ */
+uint32_t ArbiterEcmp::GetOrStampFlowHash(const Ipv4Header &header, Ptr<const Packet> p) {
+    EcmpFlowHashTag tag;
+    if (p->PeekPacketTag(tag)) {
+        return tag.GetFlowHash();
+    }
+    uint32_t flow_hash = ComputeFiveTupleHash(header, p, 0, false);
+    tag.SetFlowHash(flow_hash);
+    p->AddPacketTag(tag);
+    return flow_hash;
 }
 
 /**
@@ -69,37 +162,29 @@ ArbiterEcmp::ComputeFiveTupleHash(const Ipv4Header &header, Ptr<const Packet> p,
     } else {
 
         // If there are ports we can use, add them to the input
-        switch (protocol) {
-            case UDP_PROT_NUMBER: {
-                UdpHeader udpHeader;
-                p->PeekHeader(udpHeader);
-                uint16_t src_port = udpHeader.GetSourcePort();
-                uint16_t dst_port = udpHeader.GetDestinationPort();
-                std::memcpy(&m_hash_input_buff[13], &src_port, 2);
-                std::memcpy(&m_hash_input_buff[15], &dst_port, 2);
-                break;
-            }
-            case TCP_PROT_NUMBER: {
-                TcpHeader tcpHeader;
-                p->PeekHeader(tcpHeader);
-                uint16_t src_port = tcpHeader.GetSourcePort();
-                uint16_t dst_port = tcpHeader.GetDestinationPort();
-                std::memcpy(&m_hash_input_buff[13], &src_port, 2);
-                std::memcpy(&m_hash_input_buff[15], &dst_port, 2);
-                break;
-            }
-            default: {
-                m_hash_input_buff[13] = 0;
-                m_hash_input_buff[14] = 0;
-                m_hash_input_buff[15] = 0;
-                m_hash_input_buff[16] = 0;
-                break;
-            }
+        // Both the UDP and TCP header start with the source and destination port (in network byte order),
+        // so only those four bytes are copied instead of deserializing the entire header
+        if ((protocol == UDP_PROT_NUMBER || protocol == TCP_PROT_NUMBER) && p->CopyData(m_ports_buff, 4) == 4) {
+            uint16_t src_port = (((uint16_t) m_ports_buff[0]) << 8) | m_ports_buff[1];
+            uint16_t dst_port = (((uint16_t) m_ports_buff[2]) << 8) | m_ports_buff[3];
+            std::memcpy(&m_hash_input_buff[13], &src_port, 2);
+            std::memcpy(&m_hash_input_buff[15], &dst_port, 2);
+        } else {
+            m_hash_input_buff[13] = 0;
+            m_hash_input_buff[14] = 0;
+            m_hash_input_buff[15] = 0;
+            m_hash_input_buff[16] = 0;
         }
     }
 
-    m_hasher.clear();
-    return m_hasher.GetHash32(m_hash_input_buff, 17);
+    switch (m_hash_function) {
+        case ECMP_HASH_CRC32C:
+            return crc32c_17_bytes(m_hash_input_buff);
+        case ECMP_HASH_MURMUR3:
+        default:
+            m_hasher.clear();
+            return m_hasher.GetHash32(m_hash_input_buff, 17);
+    }
 }
 
 std::string ArbiterEcmp::StringReprOfForwardingState() {
@@ -108,7 +193,7 @@ std::string ArbiterEcmp::StringReprOfForwardingState() {
     for (int i = 0; i < m_topology->GetNumNodes(); i++) {
         res << "  -> " << i << ": {";
         bool first = true;
-        for (int j : m_candidate_list[i]) {
+        for (uint32_t j : m_next_hop_table->GetCandidates(m_node_id, i)) {
             if (!first) {
                 res << ",";
             }
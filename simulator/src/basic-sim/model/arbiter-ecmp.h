@@ -3,6 +3,8 @@
 
 #include "ns3/arbiter-ptop.h"
 #include "ns3/topology-ptop.h"
+#include "ns3/ecmp-next-hop-table.h"
+#include "ns3/ecmp-flow-hash-tag.h"
 #include "ns3/hash.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/udp-header.h"
@@ -13,6 +15,26 @@ namespace ns3 {
 const uint8_t TCP_PROT_NUMBER = 6;
 const uint8_t UDP_PROT_NUMBER = 17;
 
+/**
+ * Hash function applied to the 5-tuple (salted with the node id).
+ *
+ * ECMP_HASH_MURMUR3    ns-3 default hasher (murmur3)
+ * ECMP_HASH_CRC32C     CRC32-C, with the SSE4.2 instruction if compiled with it (e.g., -msse4.2), else table-driven
+ */
+enum EcmpHashFunction {
+    ECMP_HASH_MURMUR3,
+    ECMP_HASH_CRC32C
+};
+
+/**
+ * Parse the ECMP hash function from its name ("murmur3" or "crc32c").
+ *
+ * @param name  Name of the hash function
+ *
+ * @return ECMP hash function
+ */
+EcmpHashFunction parse_ecmp_hash_function(const std::string& name);
+
 class ArbiterEcmp : public ArbiterPtop
 {
 public:
@@ -23,7 +45,9 @@ public:
             Ptr<Node> this_node,
             NodeContainer nodes,
             Ptr<TopologyPtop> topology,
-            std::vector<std::vector<uint32_t>> candidate_list
+            Ptr<EcmpNextHopTable> next_hop_table,
+            EcmpHashFunction hash_function,
+            bool enable_flow_hash_tag
     );
 
     // ECMP implementation
@@ -41,10 +65,33 @@ public:
 
     // Made public for testing
     uint64_t ComputeFiveTupleHash(const Ipv4Header &header, Ptr<const Packet> p, int32_t node_id, bool no_other_headers);
+    uint32_t GetOrStampFlowHash(const Ipv4Header &header, Ptr<const Packet> p);
+
+    /**
+     * Mix the node id into the flow hash (murmur3 finalizer), such that
+     * every hop makes an independent choice among its candidates.
+     *
+     * @param flow_hash     Flow hash
+     * @param node_id       Node identifier
+     *
+     * @return Hash value
+     */
+    static inline uint32_t MixFlowHashWithNodeId(uint32_t flow_hash, int32_t node_id) {
+        uint32_t h = flow_hash ^ ((uint32_t) node_id * 0x9E3779B9);
+        h ^= h >> 16;
+        h *= 0x85EBCA6B;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35;
+        h ^= h >> 16;
+        return h;
+    }
 
 private:
-    std::vector<std::vector<uint32_t>> m_candidate_list;
+    Ptr<EcmpNextHopTable> m_next_hop_table; // Shared by all ECMP arbiters
+    EcmpHashFunction m_hash_function;
+    bool m_enable_flow_hash_tag;
     char m_hash_input_buff[17];
+    uint8_t m_ports_buff[4];
     ns3::Hasher m_hasher;
 
 };
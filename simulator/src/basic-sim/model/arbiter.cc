@@ -40,23 +40,21 @@ TypeId Arbiter::GetTypeId (void)
     return tid;
 }
 
-Arbiter::Arbiter(Ptr<Node> this_node, NodeContainer nodes) {
+Arbiter::Arbiter(Ptr<Node> this_node, NodeContainer nodes)
+        : Arbiter(this_node, nodes, CreateObject<IpToNodeIdIndex>(nodes)) {
+    // Left empty intentionally
+}
+
+Arbiter::Arbiter(Ptr<Node> this_node, NodeContainer nodes, Ptr<IpToNodeIdIndex> ip_to_node_id_index) {
     m_node_id = this_node->GetId();
     m_nodes = nodes;
-
-    // Store IP address to node id (each interface has an IP address, so multiple IPs per node)
-    for (uint32_t i = 0; i < m_nodes.GetN(); i++) {
-        for (uint32_t j = 1; j < m_nodes.Get(i)->GetObject<Ipv4>()->GetNInterfaces(); j++) {
-            m_ip_to_node_id.insert({m_nodes.Get(i)->GetObject<Ipv4>()->GetAddress(j,0).GetLocal().Get(), i});
-        }
-    }
-
+    m_ip_to_node_id_index = ip_to_node_id_index;
 }
 
 uint32_t Arbiter::ResolveNodeIdFromIp(uint32_t ip) {
-    m_ip_to_node_id_it = m_ip_to_node_id.find(ip);
-    if (m_ip_to_node_id_it != m_ip_to_node_id.end()) {
-        return m_ip_to_node_id_it->second;
+    int64_t node_id = m_ip_to_node_id_index->Lookup(ip);
+    if (node_id != -1) {
+        return (uint32_t) node_id;
     } else {
         throw std::invalid_argument(format_string("IP address %u is not mapped to a node id", ip));
     }
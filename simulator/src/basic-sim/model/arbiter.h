@@ -19,6 +19,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/exp-util.h"
+#include "ns3/ip-to-node-id-index.h"
 
 namespace ns3 {
 
@@ -43,6 +44,7 @@ class Arbiter : public Object
 public:
     static TypeId GetTypeId (void);
     Arbiter(Ptr<Node> this_node, NodeContainer nodes);
+    Arbiter(Ptr<Node> this_node, NodeContainer nodes, Ptr<IpToNodeIdIndex> ip_to_node_id_index);
 
     /**
      * Resolve the node identifier from an IP address.
@@ -112,8 +114,7 @@ protected:
     ns3::NodeContainer m_nodes;
 
 private:
-    std::map<uint32_t, uint32_t> m_ip_to_node_id;
-    std::map<uint32_t, uint32_t>::iterator m_ip_to_node_id_it;
+    Ptr<IpToNodeIdIndex> m_ip_to_node_id_index; // Can be shared among arbiters
 
 };
 
@@ -4,6 +4,20 @@
 
 namespace ns3 {
 
+std::string parse_simulator_scheduler(const std::string& name) {
+    if (name == "map") {
+        return "ns3::MapScheduler";
+    } else if (name == "heap") {
+        return "ns3::HeapScheduler";
+    } else if (name == "calendar") {
+        return "ns3::CalendarScheduler";
+    } else if (name == "ladder") {
+        return "ns3::LadderQueueScheduler";
+    } else {
+        throw std::invalid_argument(format_string("Unknown simulator scheduler: %s (valid: map, heap, calendar, ladder)", name.c_str()));
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (BasicSimulation);
 TypeId BasicSimulation::GetTypeId (void)
 {
@@ -47,6 +61,7 @@ void BasicSimulation::ConfigureRunDirectory() {
         printf("  > Emptying existing logs directory\n");
         remove_file_if_exists(m_logs_dir + "/finished.txt");
         remove_file_if_exists(m_logs_dir + "/timing_results.txt");
+        remove_file_if_exists(m_logs_dir + "/route_cache.csv");
     } else {
         mkdir_if_not_exists(m_logs_dir);
     }
@@ -90,6 +105,31 @@ void BasicSimulation::ConfigureSimulation() {
     ns3::RngSeedManager::SetSeed(m_simulation_seed);
     std::cout << "  > Seed: " << m_simulation_seed << std::endl;
 
+    // Event scheduler
+    std::string scheduler_name = GetConfigParamOrDefault("simulator_scheduler", "map");
+    ObjectFactory scheduler_factory;
+    scheduler_factory.SetTypeId(parse_simulator_scheduler(scheduler_name));
+    std::cout << "  > Event scheduler: " << scheduler_name << std::endl;
+
+    // Optionally, all scheduler operations are traced such that they can be replayed later on
+    std::string event_trace_filename = GetConfigParamOrDefault("simulator_event_trace_filename", "");
+    if (!event_trace_filename.empty()) {
+        ObjectFactory trace_factory;
+        trace_factory.SetTypeId("ns3::EventTraceScheduler");
+        trace_factory.Set("Scheduler", PointerValue(scheduler_factory.Create<Scheduler>()));
+        trace_factory.Set("TraceLogSink", PointerValue(CreateLogSink(event_trace_filename, 1048576, true)));
+        scheduler_factory = trace_factory;
+        std::cout << "  > Event trace: " << m_logs_dir << "/" << event_trace_filename << std::endl;
+    }
+
+    // Progress is tracked by the scheduler for each event executed, as such reporting it requires no events
+    m_progress = CreateObject<SimulationProgress>();
+    ObjectFactory progress_factory;
+    progress_factory.SetTypeId("ns3::ProgressTrackingScheduler");
+    progress_factory.Set("Scheduler", PointerValue(scheduler_factory.Create<Scheduler>()));
+    progress_factory.Set("Progress", PointerValue(m_progress));
+    Simulator::SetScheduler(progress_factory);
+
     // Set end time
     Simulator::Stop(NanoSeconds(m_simulation_end_time_ns));
     printf("  > Duration: %.2f s (%" PRId64 " ns)\n", m_simulation_end_time_ns / 1e9, m_simulation_end_time_ns);
@@ -100,41 +140,66 @@ void BasicSimulation::ConfigureSimulation() {
 
 void BasicSimulation::ShowSimulationProgress() {
     int64_t now = NowNsSinceEpoch();
-    if (now - m_last_log_time_ns_since_epoch > m_progress_interval_ns) {
-        printf(
-                "%5.2f%% - Simulation Time = %.2f s ::: Wallclock Time = %.2f s\n",
-                (Simulator::Now().GetSeconds() / (m_simulation_end_time_ns / 1e9)) * 100.0,
-                Simulator::Now().GetSeconds(),
-                (now - m_sim_start_time_ns_since_epoch) / 1e9
-        );
-        if (m_counter_progress_updates < 8 || m_counter_progress_updates % 5 == 0) { // The first 8 and every 5 progress updates we show estimate
-            int remaining_s = (int) ((m_simulation_end_time_ns / 1e9 - Simulator::Now().GetSeconds()) / (Simulator::Now().GetSeconds() / ((now - m_sim_start_time_ns_since_epoch) / 1e9)));
-            int seconds = remaining_s % 60;
-            int minutes = ((remaining_s - seconds) / 60) % 60;
-            int hours = (remaining_s - seconds - minutes * 60) / 3600;
-            std::string remainder;
-            if (hours > 0) {
-                remainder = format_string("Estimated wallclock time remaining: %d hours %d minutes", hours, minutes);
-            } else if (minutes > 0) {
-                remainder = format_string("Estimated wallclock time remaining: %d minutes %d seconds", minutes, seconds);
-            } else {
-                remainder = format_string("Estimated wallclock time remaining: %d seconds", seconds);
-            }
-            std::cout << remainder << std::endl;
+    double sim_now_s = m_progress->GetTs() * m_seconds_per_time_step;
+    int64_t num_events = m_progress->GetNumEvents();
+    double wallclock_s = (now - m_sim_start_time_ns_since_epoch) / 1e9;
+    double interval_s = (now - m_last_log_time_ns_since_epoch) / 1e9;
+    std::string line = format_string(
+            "%5.2f%% - Simulation Time = %.2f s ::: Wallclock Time = %.2f s ::: Events/s = %.0f ::: Simulated/Wallclock = %.4f\n",
+            (sim_now_s / (m_simulation_end_time_ns / 1e9)) * 100.0,
+            sim_now_s,
+            wallclock_s,
+            (num_events - m_last_log_num_events) / interval_s,
+            (sim_now_s - m_last_log_sim_time_s) / interval_s
+    );
+    if (sim_now_s > 0 && (m_counter_progress_updates < 8 || m_counter_progress_updates % 5 == 0)) { // The first 8 and every 5 progress updates we show estimate
+        int remaining_s = (int) ((m_simulation_end_time_ns / 1e9 - sim_now_s) / (sim_now_s / wallclock_s));
+        int seconds = remaining_s % 60;
+        int minutes = ((remaining_s - seconds) / 60) % 60;
+        int hours = (remaining_s - seconds - minutes * 60) / 3600;
+        if (hours > 0) {
+            line += format_string("Estimated wallclock time remaining: %d hours %d minutes\n", hours, minutes);
+        } else if (minutes > 0) {
+            line += format_string("Estimated wallclock time remaining: %d minutes %d seconds\n", minutes, seconds);
+        } else {
+            line += format_string("Estimated wallclock time remaining: %d seconds\n", seconds);
         }
-        m_last_log_time_ns_since_epoch = now;
-        if (m_counter_progress_updates < 4) {
-            m_progress_interval_ns = 10000000000; // The first five are every 10s
-        } else if (m_counter_progress_updates < 19) {
-            m_progress_interval_ns = 20000000000; // The next 15 are every 20s
-        } else if (m_counter_progress_updates < 99) {
-            m_progress_interval_ns = 60000000000; // The next 80 are every 60s
+    }
+    printf("%s", line.c_str()); // At once, as the simulation thread might print as well
+    m_last_log_time_ns_since_epoch = now;
+    m_last_log_sim_time_s = sim_now_s;
+    m_last_log_num_events = num_events;
+    if (m_counter_progress_updates < 4) {
+        m_progress_interval_ns = 10000000000; // The first five are every 10s
+    } else if (m_counter_progress_updates < 19) {
+        m_progress_interval_ns = 20000000000; // The next 15 are every 20s
+    } else if (m_counter_progress_updates < 99) {
+        m_progress_interval_ns = 60000000000; // The next 80 are every 60s
+    } else {
+        m_progress_interval_ns = 360000000000; // After that, it is every 360s = 5 minutes
+    }
+    m_counter_progress_updates++;
+}
+
+void BasicSimulation::WatchSimulationProgress() {
+    std::unique_lock<std::mutex> lock(m_progress_mutex);
+    while (!m_progress_stop) {
+        int64_t wait_ns = m_last_log_time_ns_since_epoch + (int64_t) m_progress_interval_ns - NowNsSinceEpoch();
+        if (wait_ns > 0) {
+            m_progress_cv.wait_for(lock, std::chrono::nanoseconds(wait_ns));
         } else {
-            m_progress_interval_ns = 360000000000; // After that, it is every 360s = 5 minutes
+            ShowSimulationProgress();
         }
-        m_counter_progress_updates++;
     }
-    Simulator::Schedule(Seconds(m_simulation_event_interval_s), &BasicSimulation::ShowSimulationProgress, this);
+}
+
+void BasicSimulation::StopWatchingSimulationProgress(std::thread& progress_thread) {
+    {
+        std::lock_guard<std::mutex> lock(m_progress_mutex);
+        m_progress_stop = true;
+    }
+    m_progress_cv.notify_all();
+    progress_thread.join();
 }
 
 void BasicSimulation::ConfirmAllConfigParamKeysRequested() {
@@ -151,26 +216,84 @@ void BasicSimulation::Run() {
     // Before it starts to run, we need to have processed all the config
     ConfirmAllConfigParamKeysRequested();
 
-    // Schedule progress printing
+    // Progress is printed by a separate thread which follows the wallclock
+    m_seconds_per_time_step = TimeStep(1).GetSeconds();
     m_sim_start_time_ns_since_epoch = NowNsSinceEpoch();
     m_last_log_time_ns_since_epoch = m_sim_start_time_ns_since_epoch;
-    Simulator::Schedule(Seconds(m_simulation_event_interval_s), &BasicSimulation::ShowSimulationProgress, this);
+    m_last_log_sim_time_s = 0;
+    m_last_log_num_events = m_progress->GetNumEvents();
+    int64_t num_events_start = m_last_log_num_events;
+    m_progress_stop = false;
+    std::thread progress_thread(&BasicSimulation::WatchSimulationProgress, this);
 
     // Run
     printf("Running the simulation for %.2f simulation seconds...\n", (m_simulation_end_time_ns / 1e9));
-    Simulator::Run();
+    // (the progress thread must also be joined if the run throws, else it is destroyed joinable)
+    try {
+        Simulator::Run();
+    } catch (...) {
+        StopWatchingSimulationProgress(progress_thread);
+        throw;
+    }
+    StopWatchingSimulationProgress(progress_thread);
     printf("Finished simulation.\n");
 
     // Print final duration
+    double wallclock_s = (NowNsSinceEpoch() - m_sim_start_time_ns_since_epoch) / 1e9;
+    int64_t num_events = m_progress->GetNumEvents() - num_events_start;
     printf(
-            "Simulation of %.1f seconds took in wallclock time %.1f seconds.\n\n",
+            "Simulation of %.1f seconds took in wallclock time %.1f seconds.\n",
             m_simulation_end_time_ns / 1e9,
-            (NowNsSinceEpoch() - m_sim_start_time_ns_since_epoch) / 1e9
+            wallclock_s
+    );
+    printf(
+            "Executed %" PRId64 " events (%.0f events/s), simulated-to-wallclock time ratio: %.4f\n\n",
+            num_events,
+            num_events / wallclock_s,
+            (m_simulation_end_time_ns / 1e9) / wallclock_s
     );
 
     RegisterTimestamp("Run simulation");
 }
 
+Ptr<BufferedLogSink> BasicSimulation::CreateLogSink(std::string filename, int64_t buffer_size_byte, bool keep_open) {
+    Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>(m_logs_dir + "/" + filename, buffer_size_byte, keep_open);
+    m_log_sinks.push_back(sink);
+    return sink;
+}
+
+int64_t BasicSimulation::RegisterFinalizeCallback(Callback<void> callback) {
+    int64_t callback_id = m_next_finalize_callback_id++;
+    m_finalize_callbacks.push_back(std::make_pair(callback_id, callback));
+    return callback_id;
+}
+
+void BasicSimulation::UnregisterFinalizeCallback(int64_t callback_id) {
+    // It is no longer registered once it has been called
+    for (size_t i = 0; i < m_finalize_callbacks.size(); i++) {
+        if (m_finalize_callbacks[i].first == callback_id) {
+            m_finalize_callbacks.erase(m_finalize_callbacks.begin() + i);
+            return;
+        }
+    }
+}
+
+void BasicSimulation::RunFinalizeCallbacks() {
+    // Each is only called once, even if it unregisters (or another one) while they are called
+    std::vector<std::pair<int64_t, Callback<void>>> callbacks;
+    callbacks.swap(m_finalize_callbacks);
+    for (std::pair<int64_t, Callback<void>>& callback : callbacks) {
+        callback.second();
+    }
+}
+
+void BasicSimulation::CloseLogSinks() {
+    for (Ptr<BufferedLogSink> sink : m_log_sinks) {
+        sink->Close();
+    }
+    m_log_sinks.clear();
+}
+
 void BasicSimulation::CleanUpSimulation() {
     std::cout << "CLEAN-UP" << std::endl;
     Simulator::Destroy();
@@ -208,7 +331,9 @@ void BasicSimulation::StoreTimingResults() {
 }
 
 void BasicSimulation::Finalize() {
+    RunFinalizeCallbacks();
     CleanUpSimulation();
+    CloseLogSinks();
     StoreTimingResults();
     WriteFinished(true);
 }
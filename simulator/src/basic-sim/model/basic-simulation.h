@@ -14,6 +14,9 @@
 #include <unistd.h>
 #include <chrono>
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -25,9 +28,20 @@
 #include "ns3/traffic-control-helper.h"
 
 #include "ns3/exp-util.h"
+#include "ns3/buffered-log-sink.h"
+#include "ns3/progress-tracking-scheduler.h"
 
 namespace ns3 {
 
+/**
+ * Parse the event scheduler of the simulator from its name ("map", "heap", "calendar" or "ladder").
+ *
+ * @param name  Name of the scheduler
+ *
+ * @return Type name of the scheduler (e.g., "ns3::MapScheduler")
+ */
+std::string parse_simulator_scheduler(const std::string& name);
+
 class BasicSimulation : public Object
 {
 
@@ -42,6 +56,14 @@ public:
     // Timestamps to track performance
     void RegisterTimestamp(std::string label);
 
+    // Buffered log files in the logs directory, which are closed (flushed) at Finalize
+    Ptr<BufferedLogSink> CreateLogSink(std::string filename, int64_t buffer_size_byte, bool keep_open);
+
+    // Called at the start of Finalize, while the simulator (and everything in it) still exists
+    // (the returned identifier is to unregister it, e.g. once the object it is bound to is destroyed)
+    int64_t RegisterFinalizeCallback(Callback<void> callback);
+    void UnregisterFinalizeCallback(int64_t callback_id);
+
     // Getters
     int64_t GetSimulationEndTimeNs();
     std::string GetConfigParamOrFail(std::string key);
@@ -57,7 +79,11 @@ private:
     void ReadConfig();
     void ConfigureSimulation();
     void ShowSimulationProgress();
+    void WatchSimulationProgress();
+    void StopWatchingSimulationProgress(std::thread& progress_thread);
     void RunSimulation();
+    void RunFinalizeCallbacks();
+    void CloseLogSinks();
     void CleanUpSimulation();
     void ConfirmAllConfigParamKeysRequested();
     void StoreTimingResults();
@@ -70,18 +96,31 @@ private:
     std::string m_run_dir;
     std::string m_logs_dir;
 
+    // Log sinks
+    std::vector<Ptr<BufferedLogSink>> m_log_sinks;
+
+    // Finalize callbacks
+    std::vector<std::pair<int64_t, Callback<void>>> m_finalize_callbacks;
+    int64_t m_next_finalize_callback_id = 0;
+
     // Config variables
     std::map<std::string, std::string> m_config;
     std::set<std::string> m_configRequestedKeys;
     int64_t m_simulation_seed;
     int64_t m_simulation_end_time_ns;
 
-    // Progress show variables
+    // Progress show variables (the progress is printed by a separate thread, such that it requires no events)
+    Ptr<SimulationProgress> m_progress;
+    double m_seconds_per_time_step;
+    std::mutex m_progress_mutex;
+    std::condition_variable m_progress_cv;
+    bool m_progress_stop;
     int64_t m_sim_start_time_ns_since_epoch;
     int64_t m_last_log_time_ns_since_epoch;
+    double m_last_log_sim_time_s;
+    int64_t m_last_log_num_events;
     int m_counter_progress_updates = 0;
     double m_progress_interval_ns = 10000000000; // First one after 10s
-    double m_simulation_event_interval_s = 0.00001;
 
 };
 
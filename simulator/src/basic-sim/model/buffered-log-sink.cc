@@ -0,0 +1,132 @@
+#include "buffered-log-sink.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BufferedLogSink);
+TypeId BufferedLogSink::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::BufferedLogSink")
+            .SetParent<Object> ()
+            .SetGroupName("BasicSim")
+    ;
+    return tid;
+}
+
+BufferedLogSink::BufferedLogSink(std::string filename, int64_t buffer_size_byte, bool keep_open) {
+    if (buffer_size_byte < 1) {
+        throw std::invalid_argument("Buffer size of a log sink must be at least 1 byte");
+    }
+    m_filename = filename;
+    m_keep_open = keep_open;
+    m_buffer = std::vector<char>(buffer_size_byte);
+    m_buffer_used = 0;
+    m_num_bytes_written = 0;
+    m_closed = false;
+
+    // Empty the file
+    m_file = fopen(m_filename.c_str(), "wb");
+    if (m_file == nullptr) {
+        throw std::runtime_error(format_string("Could not open log file: %s", m_filename.c_str()));
+    }
+    if (!m_keep_open) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+BufferedLogSink::~BufferedLogSink() {
+    CloseOrReport();
+}
+
+void BufferedLogSink::DoDispose(void) {
+    CloseOrReport(); // Also called upon the release of the last reference, as such it must not throw
+    Object::DoDispose();
+}
+
+void BufferedLogSink::CloseOrReport() {
+    try {
+        Close();
+    } catch (std::exception& e) {
+        std::cerr << "Could not close log sink " << m_filename << ": " << e.what() << std::endl;
+    }
+}
+
+void BufferedLogSink::WriteCsvLine(int64_t a, int64_t b, int64_t c) {
+    char line[72];
+    int size = snprintf(line, sizeof(line), "%" PRId64 ",%" PRId64 ",%" PRId64 "\n", a, b, c);
+    Write(line, size);
+}
+
+void BufferedLogSink::WriteToFile(const void* data, size_t size) {
+    if (m_keep_open) {
+        if (fwrite(data, 1, size, m_file) != size) {
+            throw std::runtime_error(format_string("Could not write to log file: %s", m_filename.c_str()));
+        }
+        fflush(m_file);
+    } else {
+        // Closed again also if the write fails
+        std::unique_ptr<FILE, decltype(&fclose)> file(fopen(m_filename.c_str(), "ab"), &fclose);
+        if (file == nullptr) {
+            throw std::runtime_error(format_string("Could not open log file: %s", m_filename.c_str()));
+        }
+        if (fwrite(data, 1, size, file.get()) != size) {
+            throw std::runtime_error(format_string("Could not write to log file: %s", m_filename.c_str()));
+        }
+    }
+    m_num_bytes_written += size;
+}
+
+void BufferedLogSink::Flush() {
+    if (m_buffer_used > 0) {
+        WriteToFile(m_buffer.data(), m_buffer_used);
+        m_buffer_used = 0;
+    }
+}
+
+void BufferedLogSink::SetPreCloseCallback(Callback<void> callback) {
+    m_pre_close_callback = callback;
+}
+
+void BufferedLogSink::Close() {
+    if (!m_closed) {
+        if (!m_pre_close_callback.IsNull()) {
+            Callback<void> callback = m_pre_close_callback;
+            m_pre_close_callback = MakeNullCallback<void>();
+            callback();
+        }
+
+        // Even if the last flush fails, the sink is closed
+        try {
+            Flush();
+        } catch (std::runtime_error& e) {
+            ReleaseFile();
+            throw;
+        }
+        ReleaseFile();
+
+    }
+}
+
+void BufferedLogSink::ReleaseFile() {
+    if (m_file != nullptr) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    m_buffer = std::vector<char>();
+    m_buffer_used = 0;
+    m_closed = true;
+}
+
+std::string BufferedLogSink::GetFilename() {
+    return m_filename;
+}
+
+int64_t BufferedLogSink::GetNumBytesWritten() {
+    return m_num_bytes_written + m_buffer_used;
+}
+
+bool BufferedLogSink::IsClosed() {
+    return m_closed;
+}
+
+}
@@ -0,0 +1,111 @@
+#ifndef BUFFERED_LOG_SINK_H
+#define BUFFERED_LOG_SINK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+
+namespace ns3 {
+
+/**
+ * Log file which is written through a large in-memory buffer, instead of
+ * opening, appending and closing the file for every single log line.
+ *
+ * The file is emptied upon construction. Either the file is kept open,
+ * or it is only opened (in append mode) when the buffer is flushed.
+ * The latter is intended for when there are many log files at the same
+ * time (e.g., one per flow), as such the number of open file descriptors stays limited.
+ *
+ * The buffer is flushed when it is full, and when the sink is closed.
+ * It should be closed explicitly (BasicSimulation::Finalize does so for the sinks
+ * it created), as errors upon closing when it is disposed of are only reported.
+ */
+class BufferedLogSink : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Create a buffered log sink.
+     *
+     * @param filename              Log filename
+     * @param buffer_size_byte      Size of the write buffer (at least 1)
+     * @param keep_open             True iff the file is kept open until it is closed
+     */
+    BufferedLogSink(std::string filename, int64_t buffer_size_byte, bool keep_open);
+    virtual ~BufferedLogSink();
+
+    /**
+     * Write data to the log.
+     *
+     * @param data  Data
+     * @param size  Size of the data (byte)
+     */
+    inline void Write(const void* data, size_t size) {
+        if (m_closed) {
+            throw std::runtime_error(format_string("Cannot write to closed log sink: %s", m_filename.c_str()));
+        }
+        if (m_buffer_used + size > m_buffer.size()) {
+            Flush();
+            if (size > m_buffer.size()) {
+                WriteToFile(data, size);
+                return;
+            }
+        }
+        std::memcpy(&m_buffer[m_buffer_used], data, size);
+        m_buffer_used += size;
+    }
+
+    /**
+     * Write a line of the form "a,b,c\n" to the log.
+     *
+     * @param a     First value
+     * @param b     Second value
+     * @param c     Third value
+     */
+    void WriteCsvLine(int64_t a, int64_t b, int64_t c);
+
+    void Flush();
+    void Close();
+
+    /**
+     * Set a callback which is called right before the sink is closed,
+     * such that the writer can write out anything it still holds back.
+     *
+     * @param callback  Callback
+     */
+    void SetPreCloseCallback(Callback<void> callback);
+
+    // Accessors
+    std::string GetFilename();
+    int64_t GetNumBytesWritten();
+    bool IsClosed();
+
+protected:
+    virtual void DoDispose (void);
+
+private:
+    void WriteToFile(const void* data, size_t size);
+    void ReleaseFile();
+    void CloseOrReport();
+
+    std::string m_filename;
+    bool m_keep_open;
+    FILE* m_file;
+    std::vector<char> m_buffer;
+    size_t m_buffer_used;
+    int64_t m_num_bytes_written;
+    bool m_closed;
+    Callback<void> m_pre_close_callback;
+
+};
+
+}
+
+#endif //BUFFERED_LOG_SINK_H
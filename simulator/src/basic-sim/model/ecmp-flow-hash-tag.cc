@@ -0,0 +1,44 @@
+#include "ecmp-flow-hash-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (EcmpFlowHashTag);
+TypeId EcmpFlowHashTag::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::EcmpFlowHashTag")
+            .SetParent<Tag> ()
+            .SetGroupName("BasicSim")
+            .AddConstructor<EcmpFlowHashTag> ()
+    ;
+    return tid;
+}
+
+TypeId EcmpFlowHashTag::GetInstanceTypeId (void) const {
+    return GetTypeId ();
+}
+
+uint32_t EcmpFlowHashTag::GetSerializedSize (void) const {
+    return 4;
+}
+
+void EcmpFlowHashTag::Serialize (TagBuffer i) const {
+    i.WriteU32(m_flow_hash);
+}
+
+void EcmpFlowHashTag::Deserialize (TagBuffer i) {
+    m_flow_hash = i.ReadU32();
+}
+
+void EcmpFlowHashTag::Print (std::ostream &os) const {
+    os << "flow_hash=" << m_flow_hash;
+}
+
+void EcmpFlowHashTag::SetFlowHash (uint32_t flow_hash) {
+    m_flow_hash = flow_hash;
+}
+
+uint32_t EcmpFlowHashTag::GetFlowHash (void) const {
+    return m_flow_hash;
+}
+
+}
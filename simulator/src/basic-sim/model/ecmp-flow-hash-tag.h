@@ -0,0 +1,35 @@
+#ifndef ECMP_FLOW_HASH_TAG_H
+#define ECMP_FLOW_HASH_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+/**
+ * Packet tag carrying the 5-tuple hash of the flow a packet belongs to.
+ *
+ * It is stamped at the first ECMP hop, after which every hop only has to
+ * mix in its own node id instead of re-computing the 5-tuple hash.
+ */
+class EcmpFlowHashTag : public Tag
+{
+public:
+    static TypeId GetTypeId (void);
+    virtual TypeId GetInstanceTypeId (void) const;
+    virtual uint32_t GetSerializedSize (void) const;
+    virtual void Serialize (TagBuffer i) const;
+    virtual void Deserialize (TagBuffer i);
+    virtual void Print (std::ostream &os) const;
+
+    void SetFlowHash (uint32_t flow_hash);
+    uint32_t GetFlowHash (void) const;
+
+private:
+    uint32_t m_flow_hash = 0;
+
+};
+
+}
+
+#endif //ECMP_FLOW_HASH_TAG_H
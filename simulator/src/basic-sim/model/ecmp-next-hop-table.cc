@@ -0,0 +1,324 @@
+#include "ecmp-next-hop-table.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (EcmpNextHopTable);
+TypeId EcmpNextHopTable::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::EcmpNextHopTable")
+            .SetParent<Object> ()
+            .SetGroupName("BasicSim")
+    ;
+    return tid;
+}
+
+EcmpNextHopTable::EcmpNextHopTable(const std::vector<std::set<int64_t>>& adjacency_list, int64_t num_threads) {
+    m_num_nodes = adjacency_list.size();
+    m_is_compact = m_num_nodes <= 65536;
+    m_mapped = nullptr;
+    m_mapped_size_byte = 0;
+    if (num_threads < 1) {
+        throw std::invalid_argument("Number of threads to calculate the ECMP routing state must be at least 1");
+    }
+
+    // Flatten the adjacency lists
+    // The adjacency lists are sets, so the neighbors are visited in ascending order,
+    // which is the same order in which the edge list produced the candidates before
+    std::vector<int64_t> adj_offsets(m_num_nodes + 1, 0);
+    std::vector<uint32_t> adj_neighbors;
+    for (int64_t i = 0; i < m_num_nodes; i++) {
+        for (int64_t neighbor_id : adjacency_list[i]) {
+            adj_neighbors.push_back((uint32_t) neighbor_id);
+        }
+        adj_offsets[i + 1] = adj_neighbors.size();
+    }
+
+    // First pass: count the number of candidates of each (current, target)
+    m_dest_offsets = std::vector<uint32_t>(m_num_nodes * (m_num_nodes + 1), 0);
+    CountOrFill(adj_offsets, adj_neighbors, num_threads, false);
+
+    // Prefix sums to go from counts to offsets
+    m_row_offsets = std::vector<uint64_t>(m_num_nodes + 1, 0);
+    for (int64_t a = 0; a < m_num_nodes; a++) {
+        uint32_t* dest_offsets = &m_dest_offsets[a * (m_num_nodes + 1)];
+        uint64_t row_sum = 0;
+        for (int64_t t = 0; t < m_num_nodes; t++) {
+            row_sum += dest_offsets[t + 1];
+            if (row_sum > UINT32_MAX) {
+                throw std::runtime_error(format_string("Too many ECMP candidates for node %" PRId64 " to fit in the next-hop table", a));
+            }
+            dest_offsets[t + 1] = (uint32_t) row_sum;
+        }
+        m_row_offsets[a + 1] = m_row_offsets[a] + row_sum;
+    }
+
+    // Second pass: fill in the candidates
+    if (m_is_compact) {
+        m_next_hops_16 = std::vector<uint16_t>(m_row_offsets[m_num_nodes]);
+    } else {
+        m_next_hops_32 = std::vector<uint32_t>(m_row_offsets[m_num_nodes]);
+    }
+    CountOrFill(adj_offsets, adj_neighbors, num_threads, true);
+    SetDataPointers();
+
+}
+
+/**
+ * Header of the binary next-hop table file. It is followed by the row offsets (uint64, n + 1),
+ * the destination offsets (uint32, n * (n + 1)) and the next hops (uint16 if compact, else uint32).
+ */
+typedef struct ecmp_next_hop_table_file_header {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t is_compact;
+    int64_t num_nodes;
+    uint64_t num_next_hops;
+} ecmp_next_hop_table_file_header_t;
+
+static const char ECMP_NEXT_HOP_TABLE_FILE_MAGIC[8] = {'E', 'C', 'M', 'P', 'N', 'H', 'T', '1'};
+static const uint32_t ECMP_NEXT_HOP_TABLE_FILE_BYTE_ORDER = 0x01020304;
+
+EcmpNextHopTable::EcmpNextHopTable(const std::string& filename) {
+    m_mapped = nullptr;
+    m_mapped_size_byte = 0;
+
+    // Map the file
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error(format_string("Next-hop table file %s could not be opened.", filename.c_str()));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(ecmp_next_hop_table_file_header_t)) {
+        close(fd);
+        throw std::runtime_error(format_string("Next-hop table file %s is too small.", filename.c_str()));
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error(format_string("Next-hop table file %s could not be memory-mapped.", filename.c_str()));
+    }
+    m_mapped = mapped;
+    m_mapped_size_byte = info.st_size;
+
+    // Validate the header and the size
+    const ecmp_next_hop_table_file_header_t* header = (const ecmp_next_hop_table_file_header_t*) mapped;
+    if (std::memcmp(header->magic, ECMP_NEXT_HOP_TABLE_FILE_MAGIC, 8) != 0 || header->byte_order != ECMP_NEXT_HOP_TABLE_FILE_BYTE_ORDER) {
+        munmap(m_mapped, m_mapped_size_byte);
+        throw std::runtime_error(format_string("Next-hop table file %s has an invalid header.", filename.c_str()));
+    }
+    m_num_nodes = header->num_nodes;
+    m_is_compact = header->is_compact != 0;
+
+    // The counts of the header are checked against the file size before any array size is
+    // calculated from them, such that a corrupt header cannot overflow the size arithmetic
+    size_t remaining_byte = m_mapped_size_byte - sizeof(ecmp_next_hop_table_file_header_t);
+    size_t next_hop_size_byte = m_is_compact ? sizeof(uint16_t) : sizeof(uint32_t);
+    bool valid_size = m_num_nodes >= 0 && (uint64_t) m_num_nodes < remaining_byte / sizeof(uint64_t); // (n + 1) row offsets
+    if (valid_size) {
+        remaining_byte -= (m_num_nodes + 1) * sizeof(uint64_t);
+        valid_size = (uint64_t) m_num_nodes <= remaining_byte / sizeof(uint32_t) / (m_num_nodes + 1); // n * (n + 1) destination offsets
+    }
+    if (valid_size) {
+        remaining_byte -= m_num_nodes * (m_num_nodes + 1) * sizeof(uint32_t);
+        valid_size = remaining_byte % next_hop_size_byte == 0 && header->num_next_hops == remaining_byte / next_hop_size_byte;
+    }
+    if (!valid_size) {
+        munmap(m_mapped, m_mapped_size_byte);
+        throw std::runtime_error(format_string("Next-hop table file %s does not have the size indicated by its header.", filename.c_str()));
+    }
+
+    // The arrays are within the mapping
+    const char* data = (const char*) mapped + sizeof(ecmp_next_hop_table_file_header_t);
+    m_row_offsets_data = (const uint64_t*) data;
+    data += (m_num_nodes + 1) * sizeof(uint64_t);
+    m_dest_offsets_data = (const uint32_t*) data;
+    data += m_num_nodes * (m_num_nodes + 1) * sizeof(uint32_t);
+    m_next_hops_16_data = m_is_compact ? (const uint16_t*) data : nullptr;
+    m_next_hops_32_data = m_is_compact ? nullptr : (const uint32_t*) data;
+    if (m_row_offsets_data[m_num_nodes] != header->num_next_hops) {
+        munmap(m_mapped, m_mapped_size_byte);
+        throw std::runtime_error(format_string("Next-hop table file %s is inconsistent.", filename.c_str()));
+    }
+
+}
+
+EcmpNextHopTable::~EcmpNextHopTable() {
+    if (m_mapped != nullptr) {
+        munmap(m_mapped, m_mapped_size_byte);
+        m_mapped = nullptr;
+    }
+}
+
+void EcmpNextHopTable::SetDataPointers() {
+    m_row_offsets_data = m_row_offsets.data();
+    m_dest_offsets_data = m_dest_offsets.data();
+    m_next_hops_16_data = m_next_hops_16.data();
+    m_next_hops_32_data = m_next_hops_32.data();
+}
+
+void EcmpNextHopTable::WriteToFile(const std::string& filename) {
+    ecmp_next_hop_table_file_header_t header;
+    std::memcpy(header.magic, ECMP_NEXT_HOP_TABLE_FILE_MAGIC, 8);
+    header.byte_order = ECMP_NEXT_HOP_TABLE_FILE_BYTE_ORDER;
+    header.is_compact = m_is_compact ? 1 : 0;
+    header.num_nodes = m_num_nodes;
+    header.num_next_hops = GetNumNextHops();
+
+    // Written to a temporary file unique to this process first
+    std::string temp_filename = format_string("%s.%d.tmp", filename.c_str(), (int) getpid());
+    std::ofstream ofs(temp_filename, std::ofstream::binary);
+    if (!ofs) {
+        throw std::runtime_error(format_string("Next-hop table file %s could not be written.", temp_filename.c_str()));
+    }
+    ofs.write((const char*) &header, sizeof(header));
+    ofs.write((const char*) m_row_offsets_data, (m_num_nodes + 1) * sizeof(uint64_t));
+    ofs.write((const char*) m_dest_offsets_data, m_num_nodes * (m_num_nodes + 1) * sizeof(uint32_t));
+    if (m_is_compact) {
+        ofs.write((const char*) m_next_hops_16_data, header.num_next_hops * sizeof(uint16_t));
+    } else {
+        ofs.write((const char*) m_next_hops_32_data, header.num_next_hops * sizeof(uint32_t));
+    }
+    ofs.close();
+    if (!ofs || std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+        remove_file_if_exists(temp_filename);
+        throw std::runtime_error(format_string("Next-hop table file %s could not be written.", filename.c_str()));
+    }
+}
+
+/**
+ * Breadth-first search from each destination t, which yields the shortest path distance of every node to t.
+ * For each edge a -> b, if shortest_path_distance(b, t) == shortest_path_distance(a, t) - 1,
+ * then a -> b must be part of a shortest path from a towards t.
+ *
+ * Each destination only writes into its own (current, t) entries, as such
+ * the destinations can be distributed over the threads without any locking.
+ *
+ * @param adj_offsets       Start of the neighbors of each node in adj_neighbors
+ * @param adj_neighbors     Neighbors of all nodes
+ * @param num_threads       Number of threads
+ * @param fill              False: only count the candidates into m_dest_offsets (shifted by one),
+ *                          true: write the candidates into the next hop array
+ */
+void EcmpNextHopTable::CountOrFill(const std::vector<int64_t>& adj_offsets, const std::vector<uint32_t>& adj_neighbors, int64_t num_threads, bool fill) {
+    int64_t n = m_num_nodes;
+    std::atomic<int64_t> next_destination(0);
+    auto worker = [&]() {
+        std::vector<int32_t> dist(n);
+        std::vector<uint32_t> queue(n);
+        int64_t t;
+        while ((t = next_destination.fetch_add(1)) < n) {
+
+            // Breadth-first search from the destination
+            std::fill(dist.begin(), dist.end(), -1);
+            dist[t] = 0;
+            int64_t queue_head = 0;
+            int64_t queue_tail = 0;
+            queue[queue_tail++] = t;
+            while (queue_head < queue_tail) {
+                uint32_t current = queue[queue_head++];
+                for (int64_t k = adj_offsets[current]; k < adj_offsets[current + 1]; k++) {
+                    uint32_t neighbor = adj_neighbors[k];
+                    if (dist[neighbor] == -1) {
+                        dist[neighbor] = dist[current] + 1;
+                        queue[queue_tail++] = neighbor;
+                    }
+                }
+            }
+
+            // Every neighbor which is one step closer to the destination is a candidate
+            for (int64_t a = 0; a < n; a++) {
+                if (dist[a] > 0) {
+                    if (fill) {
+                        size_t idx = m_row_offsets[a] + m_dest_offsets[a * (n + 1) + t];
+                        for (int64_t k = adj_offsets[a]; k < adj_offsets[a + 1]; k++) {
+                            if (dist[adj_neighbors[k]] == dist[a] - 1) {
+                                if (m_is_compact) {
+                                    m_next_hops_16[idx++] = (uint16_t) adj_neighbors[k];
+                                } else {
+                                    m_next_hops_32[idx++] = adj_neighbors[k];
+                                }
+                            }
+                        }
+                    } else {
+                        uint32_t count = 0;
+                        for (int64_t k = adj_offsets[a]; k < adj_offsets[a + 1]; k++) {
+                            if (dist[adj_neighbors[k]] == dist[a] - 1) {
+                                count++;
+                            }
+                        }
+                        m_dest_offsets[a * (n + 1) + t + 1] = count;
+                    }
+                }
+            }
+
+        }
+    };
+
+    // Run the workers (the calling thread is one of them)
+    std::vector<std::thread> threads;
+    for (int64_t i = 1; i < std::min(num_threads, std::max(n, (int64_t) 1)); i++) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+int64_t EcmpNextHopTable::GetNumNodes() {
+    return m_num_nodes;
+}
+
+uint32_t EcmpNextHopTable::GetNumCandidates(int32_t current_node_id, int32_t target_node_id) {
+    const uint32_t* dest_offsets = &m_dest_offsets_data[(size_t) current_node_id * (m_num_nodes + 1) + target_node_id];
+    return dest_offsets[1] - dest_offsets[0];
+}
+
+std::vector<uint32_t> EcmpNextHopTable::GetCandidates(int32_t current_node_id, int32_t target_node_id) {
+    std::vector<uint32_t> candidates;
+    size_t start = m_row_offsets_data[current_node_id] + m_dest_offsets_data[(size_t) current_node_id * (m_num_nodes + 1) + target_node_id];
+    for (size_t i = start; i < start + GetNumCandidates(current_node_id, target_node_id); i++) {
+        candidates.push_back(m_is_compact ? m_next_hops_16_data[i] : m_next_hops_32_data[i]);
+    }
+    return candidates;
+}
+
+bool EcmpNextHopTable::IsCompact() {
+    return m_is_compact;
+}
+
+bool EcmpNextHopTable::IsMemoryMapped() {
+    return m_mapped != nullptr;
+}
+
+int64_t EcmpNextHopTable::GetNumNextHops() {
+    return m_row_offsets_data[m_num_nodes];
+}
+
+int64_t EcmpNextHopTable::GetMemoryUsageByte() {
+    return (m_num_nodes + 1) * sizeof(uint64_t)
+           + m_num_nodes * (m_num_nodes + 1) * sizeof(uint32_t)
+           + GetNumNextHops() * (m_is_compact ? sizeof(uint16_t) : sizeof(uint32_t));
+}
+
+std::string EcmpNextHopTable::GetMemoryReport() {
+    return format_string(
+            "%" PRId64 " next hops stored as %s, %.2f MB in total%s (row offsets: %.2f MB, destination offsets: %.2f MB, next hops: %.2f MB)",
+            GetNumNextHops(),
+            m_is_compact ? "uint16" : "uint32",
+            GetMemoryUsageByte() / 1000000.0,
+            IsMemoryMapped() ? ", memory-mapped" : "",
+            (m_num_nodes + 1) * sizeof(uint64_t) / 1000000.0,
+            m_num_nodes * (m_num_nodes + 1) * sizeof(uint32_t) / 1000000.0,
+            GetNumNextHops() * (m_is_compact ? sizeof(uint16_t) : sizeof(uint32_t)) / 1000000.0
+    );
+}
+
+}
@@ -0,0 +1,112 @@
+#ifndef ECMP_NEXT_HOP_TABLE_H
+#define ECMP_NEXT_HOP_TABLE_H
+
+#include <vector>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+
+namespace ns3 {
+
+/**
+ * Immutable ECMP next-hop table for all nodes, shared by all ECMP arbiters.
+ *
+ * It is stored in compressed-sparse-row form:
+ *
+ * - m_row_offsets[current] is where the next hops of node current start in the next hop array
+ * - m_dest_offsets[current * (n + 1) + target] is where the next hops towards target start within that row
+ * - The next hop array holds the node identifiers, as uint16 if there are at most 65536 nodes, else as uint32
+ *
+ * As such, the candidate next hops of current towards target are the
+ * (m_dest_offsets[current * (n + 1) + target + 1] - m_dest_offsets[current * (n + 1) + target])
+ * next hops starting at m_row_offsets[current] + m_dest_offsets[current * (n + 1) + target].
+ *
+ * The table can be written to a binary file, which is a header followed by the three arrays
+ * exactly as they are in memory. Loading such a file maps it into memory rather than reading it,
+ * as such it takes milliseconds regardless of the table size.
+ */
+class EcmpNextHopTable : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Calculate the ECMP next hops from the adjacency lists using a breadth-first search per destination.
+     *
+     * @param adjacency_list    Adjacency list of every node (neighbors in ascending order)
+     * @param num_threads       Number of threads used to calculate it (at least 1)
+     */
+    EcmpNextHopTable(const std::vector<std::set<int64_t>>& adjacency_list, int64_t num_threads);
+
+    /**
+     * Load (memory-map) the ECMP next hops from a file written by WriteToFile().
+     *
+     * @param filename          Binary next-hop table file
+     */
+    EcmpNextHopTable(const std::string& filename);
+    ~EcmpNextHopTable();
+
+    /**
+     * Write the table to a binary file (it is first written to a temporary file which is then renamed,
+     * such that concurrent readers never see a partially written file).
+     *
+     * @param filename          Binary next-hop table file
+     */
+    void WriteToFile(const std::string& filename);
+
+    /**
+     * Select a candidate next hop from current towards target.
+     *
+     * @param current_node_id   Node at which the decision is made
+     * @param target_node_id    Node where the packet has to go to
+     * @param hash              Hash value to select among the candidates (modulo number of candidates)
+     *
+     * @return Selected next hop node identifier (-1 if there is no candidate)
+     */
+    inline int32_t SelectNextHop(int32_t current_node_id, int32_t target_node_id, uint32_t hash) const {
+        const uint32_t* dest_offsets = &m_dest_offsets_data[(size_t) current_node_id * (m_num_nodes + 1) + target_node_id];
+        uint32_t num_candidates = dest_offsets[1] - dest_offsets[0];
+        if (num_candidates == 0) {
+            return -1;
+        }
+        size_t idx = m_row_offsets_data[current_node_id] + dest_offsets[0] + hash % num_candidates;
+        return m_is_compact ? m_next_hops_16_data[idx] : m_next_hops_32_data[idx];
+    }
+
+    // Accessors
+    int64_t GetNumNodes();
+    uint32_t GetNumCandidates(int32_t current_node_id, int32_t target_node_id);
+    std::vector<uint32_t> GetCandidates(int32_t current_node_id, int32_t target_node_id);
+    bool IsCompact();
+    bool IsMemoryMapped();
+    int64_t GetNumNextHops();
+    int64_t GetMemoryUsageByte();
+    std::string GetMemoryReport();
+
+private:
+    void CountOrFill(const std::vector<int64_t>& adj_offsets, const std::vector<uint32_t>& adj_neighbors, int64_t num_threads, bool fill);
+    void SetDataPointers();
+
+    int64_t m_num_nodes;
+    bool m_is_compact;
+    std::vector<uint64_t> m_row_offsets;
+    std::vector<uint32_t> m_dest_offsets;
+    std::vector<uint16_t> m_next_hops_16;
+    std::vector<uint32_t> m_next_hops_32;
+
+    // Arrays used for the lookups: either of the vectors above, or within the memory-mapped file
+    const uint64_t* m_row_offsets_data;
+    const uint32_t* m_dest_offsets_data;
+    const uint16_t* m_next_hops_16_data;
+    const uint32_t* m_next_hops_32_data;
+    void* m_mapped;
+    size_t m_mapped_size_byte;
+
+};
+
+}
+
+#endif //ECMP_NEXT_HOP_TABLE_H
@@ -0,0 +1,120 @@
+#include "event-trace-scheduler.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (EventTraceScheduler);
+TypeId EventTraceScheduler::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::EventTraceScheduler")
+            .SetParent<Scheduler> ()
+            .SetGroupName("BasicSim")
+            .AddConstructor<EventTraceScheduler> ()
+            .AddAttribute ("Scheduler",
+                           "Scheduler which holds the events",
+                           PointerValue (),
+                           MakePointerAccessor (&EventTraceScheduler::m_scheduler),
+                           MakePointerChecker<Scheduler> ())
+            .AddAttribute ("TraceLogSink",
+                           "Log sink the event trace is written to",
+                           PointerValue (),
+                           MakePointerAccessor (&EventTraceScheduler::m_trace_log_sink),
+                           MakePointerChecker<BufferedLogSink> ())
+    ;
+    return tid;
+}
+
+EventTraceScheduler::EventTraceScheduler() {
+}
+
+EventTraceScheduler::~EventTraceScheduler() {
+}
+
+void EventTraceScheduler::Insert (const Event &ev) {
+    Record(ev, EVENT_TRACE_INSERT);
+    m_scheduler->Insert(ev);
+}
+
+bool EventTraceScheduler::IsEmpty (void) const {
+    return m_scheduler->IsEmpty();
+}
+
+Scheduler::Event EventTraceScheduler::PeekNext (void) const {
+    return m_scheduler->PeekNext();
+}
+
+Scheduler::Event EventTraceScheduler::RemoveNext (void) {
+    Event ev = m_scheduler->RemoveNext();
+    Record(ev, EVENT_TRACE_REMOVE_NEXT);
+    return ev;
+}
+
+void EventTraceScheduler::Remove (const Event &ev) {
+    Record(ev, EVENT_TRACE_REMOVE);
+    m_scheduler->Remove(ev);
+}
+
+std::vector<event_trace_record_t> read_event_trace(const std::string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error(format_string("Event trace file %s could not be opened.", filename.c_str()));
+    }
+    fseek(file, 0, SEEK_END);
+    int64_t size_byte = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size_byte < 0 || size_byte % sizeof(event_trace_record_t) != 0) {
+        fclose(file);
+        throw std::runtime_error(format_string("Event trace file %s is not a whole number of records.", filename.c_str()));
+    }
+    std::vector<event_trace_record_t> trace(size_byte / sizeof(event_trace_record_t));
+    size_t num_read = fread(trace.data(), sizeof(event_trace_record_t), trace.size(), file);
+    fclose(file);
+    if (num_read != trace.size()) {
+        throw std::runtime_error(format_string("Event trace file %s could not be read entirely.", filename.c_str()));
+    }
+    for (const event_trace_record_t& record : trace) {
+        if (record.operation > (uint32_t) EVENT_TRACE_REMOVE) {
+            throw std::runtime_error(format_string("Event trace file %s has an invalid operation: %u", filename.c_str(), record.operation));
+        }
+    }
+    return trace;
+}
+
+/**
+ * Event without anything to do, the schedulers only hold on to the pointer.
+ */
+class ReplayEventImpl : public EventImpl
+{
+protected:
+    virtual void Notify (void) {
+    }
+};
+
+int64_t replay_event_trace(const std::vector<event_trace_record_t>& trace, Ptr<Scheduler> scheduler) {
+    Ptr<ReplayEventImpl> impl = Create<ReplayEventImpl>();
+    Scheduler::Event ev;
+    ev.impl = PeekPointer(impl);
+    ev.key.m_context = 0;
+    int64_t checksum = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        const event_trace_record_t& record = trace[i];
+        ev.key.m_ts = record.ts;
+        ev.key.m_uid = record.uid;
+        if (record.operation == EVENT_TRACE_INSERT) {
+            scheduler->Insert(ev);
+        } else if (record.operation == EVENT_TRACE_REMOVE_NEXT) {
+            Scheduler::Event next = scheduler->RemoveNext();
+            if (next.key.m_uid != record.uid || next.key.m_ts != record.ts) {
+                throw std::runtime_error(format_string(
+                        "Event trace replay diverged at record %zu: expected event (ts: %" PRIu64 ", uid: %u) but got (ts: %" PRIu64 ", uid: %u)",
+                        i, record.ts, record.uid, next.key.m_ts, next.key.m_uid
+                ));
+            }
+            checksum += next.key.m_uid;
+        } else {
+            scheduler->Remove(ev);
+        }
+    }
+    return checksum;
+}
+
+}
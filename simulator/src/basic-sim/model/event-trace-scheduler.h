@@ -0,0 +1,90 @@
+#ifndef EVENT_TRACE_SCHEDULER_H
+#define EVENT_TRACE_SCHEDULER_H
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/buffered-log-sink.h"
+
+namespace ns3 {
+
+/**
+ * Operation on the event scheduler of the simulator.
+ */
+enum EventTraceOperation {
+    EVENT_TRACE_INSERT = 0,
+    EVENT_TRACE_REMOVE_NEXT = 1,
+    EVENT_TRACE_REMOVE = 2
+};
+
+/**
+ * Record of an event trace file, which is a sequence of these records (16 byte each)
+ * in the byte order of the machine which wrote it.
+ */
+typedef struct event_trace_record {
+    uint64_t ts;            // Event timestamp (simulator time unit)
+    uint32_t uid;           // Event unique identifier
+    uint32_t operation;     // EventTraceOperation
+} event_trace_record_t;
+
+/**
+ * Event scheduler which passes on every operation to another scheduler, and records
+ * the operation (and the event it concerns) into a log sink. The resulting event trace
+ * can be replayed against any scheduler using replay_event_trace().
+ *
+ * Attributes (both are required):
+ * - Scheduler: scheduler which actually holds the events
+ * - TraceLogSink: log sink the event trace is written to
+ */
+class EventTraceScheduler : public Scheduler
+{
+public:
+    static TypeId GetTypeId (void);
+
+    EventTraceScheduler();
+    virtual ~EventTraceScheduler();
+
+    // Scheduler interface
+    virtual void Insert (const Event &ev);
+    virtual bool IsEmpty (void) const;
+    virtual Event PeekNext (void) const;
+    virtual Event RemoveNext (void);
+    virtual void Remove (const Event &ev);
+
+private:
+    inline void Record(const Event &ev, EventTraceOperation operation) {
+        event_trace_record_t record = {ev.key.m_ts, ev.key.m_uid, (uint32_t) operation};
+        m_trace_log_sink->Write(&record, sizeof(event_trace_record_t));
+    }
+
+    Ptr<Scheduler> m_scheduler;
+    Ptr<BufferedLogSink> m_trace_log_sink;
+
+};
+
+/**
+ * Read an event trace file.
+ *
+ * @param filename  Event trace filename
+ *
+ * @return Event trace records
+ */
+std::vector<event_trace_record_t> read_event_trace(const std::string& filename);
+
+/**
+ * Replay an event trace against a scheduler: every operation is performed in the same order.
+ * The events which the scheduler removes next must be exactly the ones of the trace,
+ * as such it also verifies that the scheduler orders events as the one which was traced.
+ *
+ * @param trace         Event trace records
+ * @param scheduler     Empty scheduler
+ *
+ * @return Checksum (sum of the unique identifiers of the events removed next)
+ */
+int64_t replay_event_trace(const std::vector<event_trace_record_t>& trace, Ptr<Scheduler> scheduler);
+
+}
+
+#endif //EVENT_TRACE_SCHEDULER_H
@@ -0,0 +1,72 @@
+#include "ip-to-node-id-index.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (IpToNodeIdIndex);
+TypeId IpToNodeIdIndex::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::IpToNodeIdIndex")
+            .SetParent<Object> ()
+            .SetGroupName("BasicSim")
+    ;
+    return tid;
+}
+
+IpToNodeIdIndex::IpToNodeIdIndex(NodeContainer nodes) {
+
+    // Count the IP addresses (each interface has an IP address, so multiple IPs per node)
+    int64_t num_ips = 0;
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+        num_ips += nodes.Get(i)->GetObject<Ipv4>()->GetNInterfaces() - 1;
+    }
+
+    // Capacity is the smallest power of two of at least twice the number of IP addresses
+    uint64_t capacity = 2;
+    while (capacity < (uint64_t) num_ips * 2) {
+        capacity *= 2;
+    }
+    if (capacity > ((uint64_t) 1) << 32) {
+        throw std::runtime_error(format_string("Too many IP addresses (%" PRId64 ") to index", num_ips));
+    }
+    m_mask = (uint32_t) (capacity - 1);
+    m_keys = std::vector<uint32_t>(capacity, 0);
+    m_values = std::vector<uint32_t>(capacity, 0);
+    m_num_entries = 0;
+
+    // Store IP address to node id
+    for (uint32_t i = 0; i < nodes.GetN(); i++) {
+        for (uint32_t j = 1; j < nodes.Get(i)->GetObject<Ipv4>()->GetNInterfaces(); j++) {
+            Insert(nodes.Get(i)->GetObject<Ipv4>()->GetAddress(j, 0).GetLocal().Get(), i);
+        }
+    }
+
+}
+
+void IpToNodeIdIndex::Insert(uint32_t ip, uint32_t node_id) {
+    if (ip == 0) {
+        throw std::invalid_argument("IP address 0.0.0.0 cannot be mapped to a node id");
+    }
+    uint32_t slot = Hash(ip);
+    while (m_keys[slot] != 0) {
+        if (m_keys[slot] == ip) {
+            if (m_values[slot] != node_id) {
+                throw std::invalid_argument(format_string("IP address %u is assigned to both node %u and node %u", ip, m_values[slot], node_id));
+            }
+            return;
+        }
+        slot = (slot + 1) & m_mask;
+    }
+    m_keys[slot] = ip;
+    m_values[slot] = node_id;
+    m_num_entries++;
+}
+
+int64_t IpToNodeIdIndex::GetNumEntries() {
+    return m_num_entries;
+}
+
+int64_t IpToNodeIdIndex::GetCapacity() {
+    return m_keys.size();
+}
+
+}
@@ -0,0 +1,73 @@
+#ifndef IP_TO_NODE_ID_INDEX_H
+#define IP_TO_NODE_ID_INDEX_H
+
+#include <vector>
+#include <stdexcept>
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4.h"
+#include "ns3/exp-util.h"
+
+namespace ns3 {
+
+/**
+ * Immutable index from interface IP address to node identifier, built once
+ * and shared by all arbiters.
+ *
+ * It is an open-addressing hash table with linear probing. The capacity is a power
+ * of two which is at least twice the number of IP addresses, as such probe sequences
+ * remain short. IP address 0.0.0.0 marks an empty slot (it is never assigned to an interface).
+ */
+class IpToNodeIdIndex : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Index the IP addresses of all interfaces (except loop-back interface 0) of all nodes.
+     *
+     * @param nodes     All nodes
+     */
+    IpToNodeIdIndex(NodeContainer nodes);
+
+    /**
+     * Look up the node identifier of an IP address.
+     *
+     * @param ip    IP address
+     *
+     * @return Node identifier (-1 if the IP address is not of any node)
+     */
+    inline int64_t Lookup(uint32_t ip) const {
+        if (ip == 0) {
+            return -1;
+        }
+        uint32_t slot = Hash(ip);
+        while (m_keys[slot] != 0) {
+            if (m_keys[slot] == ip) {
+                return m_values[slot];
+            }
+            slot = (slot + 1) & m_mask;
+        }
+        return -1;
+    }
+
+    // Accessors
+    int64_t GetNumEntries();
+    int64_t GetCapacity();
+
+private:
+    inline uint32_t Hash(uint32_t ip) const {
+        return ((uint32_t) (ip * 2654435761u)) & m_mask; // Multiplicative (Knuth) hashing
+    }
+    void Insert(uint32_t ip, uint32_t node_id);
+
+    int64_t m_num_entries;
+    uint32_t m_mask;
+    std::vector<uint32_t> m_keys;
+    std::vector<uint32_t> m_values;
+
+};
+
+}
+
+#endif //IP_TO_NODE_ID_INDEX_H
@@ -101,6 +101,15 @@ namespace ns3 {
 
         }
 
+        // Re-use the routing entry if it has been created before
+        uint64_t key = (((uint64_t) if_idx) << 32) | dest.Get();
+        std::unordered_map<uint64_t, Ptr<Ipv4Route>>::iterator it = m_route_cache.find(key);
+        if (it != m_route_cache.end() && it->second->GetGateway().Get() == gateway_ip_address) {
+            m_route_cache_hits++;
+            return it->second;
+        }
+        m_route_cache_misses++;
+
         // Create routing entry
         Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
         rtentry->SetDestination(dest);
@@ -110,6 +119,7 @@ namespace ns3 {
         rtentry->SetGateway(Ipv4Address(gateway_ip_address)); // If the network device does not care about ARP resolution,
                                                               // this can be set to 0.0.0.0
         rtentry->SetOutputDevice(m_ipv4->GetNetDevice(if_idx));
+        m_route_cache[key] = rtentry;
         return rtentry;
 
     }
@@ -295,4 +305,19 @@ namespace ns3 {
         return m_arbiter;
     }
 
+    int64_t
+    Ipv4ArbiterRouting::GetRouteCacheSize () {
+        return m_route_cache.size();
+    }
+
+    int64_t
+    Ipv4ArbiterRouting::GetRouteCacheHits () {
+        return m_route_cache_hits;
+    }
+
+    int64_t
+    Ipv4ArbiterRouting::GetRouteCacheMisses () {
+        return m_route_cache_misses;
+    }
+
 } // namespace ns3
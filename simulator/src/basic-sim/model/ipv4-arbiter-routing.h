@@ -23,6 +23,7 @@
 
 #include <list>
 #include <utility>
+#include <unordered_map>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -100,6 +101,11 @@ public:
   void SetArbiter (Ptr<Arbiter> arbiter);
   Ptr<Arbiter> GetArbiter ();
 
+  // Route cache statistics
+  int64_t GetRouteCacheSize ();
+  int64_t GetRouteCacheHits ();
+  int64_t GetRouteCacheMisses ();
+
 private:
     Ptr<Ipv4> m_ipv4;
     Ptr<Ipv4Route> LookupArbiter (const Ipv4Address& dest, const Ipv4Header &header, Ptr<const Packet> p, Ptr<NetDevice> oif = 0);
@@ -109,6 +115,16 @@ private:
     Ipv4Address loopbackIp = Ipv4Address("127.0.0.1");
     uint32_t m_nodeId;
 
+    // Route entries are immutable once created, so they are shared by all packets
+    // which go out of the same interface towards the same destination
+    // Key: (out interface index << 32) | destination IP address
+    // It is not evicted: an entry is only replaced (not added) if the gateway changes,
+    // and the destinations are the interface addresses of the topology, as such it
+    // cannot grow beyond (number of interfaces of this node) x (number of addresses)
+    std::unordered_map<uint64_t, Ptr<Ipv4Route>> m_route_cache;
+    int64_t m_route_cache_hits = 0;
+    int64_t m_route_cache_misses = 0;
+
 };
 
 } // Namespace ns3
@@ -0,0 +1,210 @@
+#include "ladder-queue-scheduler.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (LadderQueueScheduler);
+TypeId LadderQueueScheduler::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::LadderQueueScheduler")
+            .SetParent<Scheduler> ()
+            .SetGroupName("BasicSim")
+            .AddConstructor<LadderQueueScheduler> ()
+    ;
+    return tid;
+}
+
+// Earliest event at the front of the bottom heap
+static bool bottom_heap_compare(const Scheduler::Event &a, const Scheduler::Event &b) {
+    return b < a;
+}
+
+LadderQueueScheduler::LadderQueueScheduler() {
+    m_top_start = 0;
+    m_top_min_ts = UINT64_MAX;
+    m_top_max_ts = 0;
+    m_rungs.resize(MAX_RUNGS);
+    m_num_rungs = 0;
+    m_num_rungs_spawned = 0;
+    m_max_num_rungs = 0;
+}
+
+LadderQueueScheduler::~LadderQueueScheduler() {
+}
+
+void LadderQueueScheduler::Insert (const Event &ev) {
+    uint64_t ts = ev.key.m_ts;
+
+    // Far future
+    if (ts >= m_top_start) {
+        m_top.push_back(ev);
+        m_top_min_ts = std::min(m_top_min_ts, ts);
+        m_top_max_ts = std::max(m_top_max_ts, ts);
+
+    } else {
+
+        // Into the bucket of the first rung which has not yet gone past it
+        size_t i = 0;
+        for (; i < m_num_rungs; i++) {
+            Rung& rung = m_rungs[i];
+            if (ts >= GetRungCurrentStart(rung)) {
+                rung.buckets[(ts - rung.start) / rung.width].push_back(ev);
+                break;
+            }
+        }
+
+        // Earlier than the entire ladder
+        if (i == m_num_rungs) {
+            InsertIntoBottom(ev);
+        }
+
+    }
+
+    // The bottom is only empty if the scheduler is empty
+    if (m_bottom.empty()) {
+        RefillBottom();
+    }
+}
+
+bool LadderQueueScheduler::IsEmpty (void) const {
+    return m_bottom.empty();
+}
+
+Scheduler::Event LadderQueueScheduler::PeekNext (void) const {
+    if (m_bottom.empty()) {
+        throw std::runtime_error("Cannot peek into an empty ladder queue scheduler");
+    }
+    return m_bottom.front();
+}
+
+Scheduler::Event LadderQueueScheduler::RemoveNext (void) {
+    if (m_bottom.empty()) {
+        throw std::runtime_error("Cannot remove from an empty ladder queue scheduler");
+    }
+    std::pop_heap(m_bottom.begin(), m_bottom.end(), bottom_heap_compare);
+    Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    if (m_bottom.empty()) {
+        RefillBottom();
+    }
+    return ev;
+}
+
+void LadderQueueScheduler::Remove (const Event &ev) {
+    uint64_t ts = ev.key.m_ts;
+
+    // Events only move to earlier tiers once their timestamp is before the start of that tier,
+    // as such the tier (and bucket) in which an event is can be determined from its timestamp
+    std::vector<Event>* events = &m_bottom;
+    if (ts >= m_top_start) {
+        events = &m_top;
+    } else {
+        for (size_t i = 0; i < m_num_rungs; i++) {
+            Rung& rung = m_rungs[i];
+            if (ts >= GetRungCurrentStart(rung)) {
+                events = &rung.buckets[(ts - rung.start) / rung.width];
+                break;
+            }
+        }
+    }
+
+    // Find it by its unique identifier
+    size_t idx = 0;
+    while (idx < events->size() && (*events)[idx].key.m_uid != ev.key.m_uid) {
+        idx++;
+    }
+    if (idx == events->size()) {
+        throw std::runtime_error(format_string("Event (uid: %u) to remove is not in the ladder queue scheduler", ev.key.m_uid));
+    }
+    (*events)[idx] = events->back();
+    events->pop_back();
+    if (events == &m_bottom) {
+        std::make_heap(m_bottom.begin(), m_bottom.end(), bottom_heap_compare);
+        if (m_bottom.empty()) {
+            RefillBottom();
+        }
+    }
+}
+
+void LadderQueueScheduler::InsertIntoBottom(const Event &ev) {
+    m_bottom.push_back(ev);
+    std::push_heap(m_bottom.begin(), m_bottom.end(), bottom_heap_compare);
+}
+
+void LadderQueueScheduler::SpawnRung(std::vector<Event>& events, uint64_t start, uint64_t width, size_t num_buckets) {
+    Rung& rung = m_rungs[m_num_rungs];
+    rung.start = start;
+    rung.width = width;
+    rung.current = 0;
+    rung.num_buckets = num_buckets;
+    if (rung.buckets.size() < num_buckets) {
+        rung.buckets.resize(num_buckets);
+    }
+    for (const Event& ev : events) {
+        rung.buckets[(ev.key.m_ts - start) / width].push_back(ev);
+    }
+    events.clear();
+    m_num_rungs++;
+    m_num_rungs_spawned++;
+    m_max_num_rungs = std::max(m_max_num_rungs, (int64_t) m_num_rungs);
+}
+
+void LadderQueueScheduler::RefillBottom() {
+    while (m_bottom.empty()) {
+
+        // Empty ladder: the top becomes the first rung, such that it spans [min, max] of the top
+        if (m_num_rungs == 0) {
+            if (m_top.empty()) {
+                return;
+            }
+            if (m_top.size() <= BUCKET_THRESHOLD || m_top_min_ts == m_top_max_ts) {
+                m_bottom.swap(m_top);
+                std::make_heap(m_bottom.begin(), m_bottom.end(), bottom_heap_compare);
+            } else {
+                uint64_t width = (m_top_max_ts - m_top_min_ts) / m_top.size() + 1;
+                SpawnRung(m_top, m_top_min_ts, width, (m_top_max_ts - m_top_min_ts) / width + 1);
+            }
+            m_top_start = m_top_max_ts + 1;
+            m_top_min_ts = UINT64_MAX;
+            m_top_max_ts = 0;
+            continue;
+        }
+
+        // Next non-empty bucket of the lowest rung, the rung is removed once all its buckets are done
+        Rung& rung = m_rungs[m_num_rungs - 1];
+        while (rung.current < rung.num_buckets && rung.buckets[rung.current].empty()) {
+            rung.current++;
+        }
+        if (rung.current == rung.num_buckets) {
+            m_num_rungs--;
+            continue;
+        }
+        std::vector<Event>& bucket = rung.buckets[rung.current];
+        uint64_t bucket_start = GetRungCurrentStart(rung);
+        rung.current++;
+
+        // Small buckets (or ones which cannot be split further) go into the bottom, else they become a new
+        // rung which spans exactly the bucket (it must end where the current bucket of its parent rung starts)
+        bool all_same_ts = true;
+        for (const Event& ev : bucket) {
+            all_same_ts = all_same_ts && ev.key.m_ts == bucket[0].key.m_ts;
+        }
+        if (bucket.size() <= BUCKET_THRESHOLD || all_same_ts || m_num_rungs == MAX_RUNGS) {
+            m_bottom.swap(bucket);
+            std::make_heap(m_bottom.begin(), m_bottom.end(), bottom_heap_compare);
+        } else {
+            uint64_t width = (rung.width + bucket.size() - 1) / bucket.size();
+            SpawnRung(bucket, bucket_start, width, (rung.width + width - 1) / width);
+        }
+
+    }
+}
+
+int64_t LadderQueueScheduler::GetNumRungsSpawned() {
+    return m_num_rungs_spawned;
+}
+
+int64_t LadderQueueScheduler::GetMaxNumRungs() {
+    return m_max_num_rungs;
+}
+
+}
@@ -0,0 +1,92 @@
+#ifndef LADDER_QUEUE_SCHEDULER_H
+#define LADDER_QUEUE_SCHEDULER_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+
+namespace ns3 {
+
+/**
+ * Event scheduler based on the ladder queue (Tang, Goh and Thng, 2005), which has O(1) amortized
+ * insertion and removal when most events are scheduled in the near future (e.g., link transmissions).
+ *
+ * It consists of three tiers:
+ *
+ * - Top: unsorted list of all events at or after m_top_start (the far future)
+ * - Ladder: rungs of buckets, each rung covering exactly one bucket of the rung above it
+ *   with smaller buckets; each bucket is an unsorted list
+ * - Bottom: the events which are dequeued next, kept as a binary heap
+ *
+ * When the bottom runs empty, the next non-empty bucket of the lowest rung is either
+ * moved into the bottom (if it has few events) or split into a new rung. When the ladder
+ * is empty, the top is turned into the first rung.
+ *
+ * Events are ordered exactly as in the other ns-3 schedulers: by timestamp and then by unique identifier.
+ */
+class LadderQueueScheduler : public Scheduler
+{
+public:
+    static TypeId GetTypeId (void);
+
+    LadderQueueScheduler();
+    virtual ~LadderQueueScheduler();
+
+    // Scheduler interface
+    virtual void Insert (const Event &ev);
+    virtual bool IsEmpty (void) const;
+    virtual Event PeekNext (void) const;
+    virtual Event RemoveNext (void);
+    virtual void Remove (const Event &ev);
+
+    // Statistics
+    int64_t GetNumRungsSpawned();
+    int64_t GetMaxNumRungs();
+
+private:
+
+    // Maximum number of events in a bucket which is moved into the bottom, more are split into a new rung
+    static const size_t BUCKET_THRESHOLD = 50;
+
+    // Maximum number of rungs, the last rung moves its buckets into the bottom regardless of their size
+    static const size_t MAX_RUNGS = 8;
+
+    struct Rung {
+        uint64_t start;         // Timestamp of the start of the first bucket
+        uint64_t width;         // Width of each bucket
+        size_t current;         // Current bucket, all buckets before it are empty
+        size_t num_buckets;     // Number of buckets in use
+        std::vector<std::vector<Event>> buckets;
+    };
+
+    inline uint64_t GetRungCurrentStart(const Rung& rung) const {
+        return rung.start + rung.current * rung.width;
+    }
+    void InsertIntoBottom(const Event &ev);
+    void SpawnRung(std::vector<Event>& events, uint64_t start, uint64_t width, size_t num_buckets);
+    void RefillBottom();
+
+    // Top
+    std::vector<Event> m_top;
+    uint64_t m_top_start;
+    uint64_t m_top_min_ts;
+    uint64_t m_top_max_ts;
+
+    // Ladder (the first m_num_rungs are in use, the others are kept for their allocated buckets)
+    std::vector<Rung> m_rungs;
+    size_t m_num_rungs;
+
+    // Bottom (binary heap with the earliest event at the front)
+    std::vector<Event> m_bottom;
+
+    // Statistics
+    int64_t m_num_rungs_spawned;
+    int64_t m_max_num_rungs;
+
+};
+
+}
+
+#endif //LADDER_QUEUE_SCHEDULER_H
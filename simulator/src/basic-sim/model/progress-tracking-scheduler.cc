@@ -0,0 +1,77 @@
+#include "progress-tracking-scheduler.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SimulationProgress);
+TypeId SimulationProgress::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::SimulationProgress")
+            .SetParent<Object> ()
+            .SetGroupName("BasicSim")
+    ;
+    return tid;
+}
+
+SimulationProgress::SimulationProgress() {
+    m_ts.store(0);
+    m_num_events.store(0);
+}
+
+uint64_t SimulationProgress::GetTs() {
+    return m_ts.load(std::memory_order_relaxed);
+}
+
+int64_t SimulationProgress::GetNumEvents() {
+    return m_num_events.load(std::memory_order_relaxed);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (ProgressTrackingScheduler);
+TypeId ProgressTrackingScheduler::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::ProgressTrackingScheduler")
+            .SetParent<Scheduler> ()
+            .SetGroupName("BasicSim")
+            .AddConstructor<ProgressTrackingScheduler> ()
+            .AddAttribute ("Scheduler",
+                           "Scheduler which holds the events",
+                           PointerValue (),
+                           MakePointerAccessor (&ProgressTrackingScheduler::m_scheduler),
+                           MakePointerChecker<Scheduler> ())
+            .AddAttribute ("Progress",
+                           "Simulation progress which is updated for each executed event",
+                           PointerValue (),
+                           MakePointerAccessor (&ProgressTrackingScheduler::m_progress),
+                           MakePointerChecker<SimulationProgress> ())
+    ;
+    return tid;
+}
+
+ProgressTrackingScheduler::ProgressTrackingScheduler() {
+}
+
+ProgressTrackingScheduler::~ProgressTrackingScheduler() {
+}
+
+void ProgressTrackingScheduler::Insert (const Event &ev) {
+    m_scheduler->Insert(ev);
+}
+
+bool ProgressTrackingScheduler::IsEmpty (void) const {
+    return m_scheduler->IsEmpty();
+}
+
+Scheduler::Event ProgressTrackingScheduler::PeekNext (void) const {
+    return m_scheduler->PeekNext();
+}
+
+Scheduler::Event ProgressTrackingScheduler::RemoveNext (void) {
+    Event ev = m_scheduler->RemoveNext();
+    m_progress->RecordEvent(ev.key.m_ts);
+    return ev;
+}
+
+void ProgressTrackingScheduler::Remove (const Event &ev) {
+    m_scheduler->Remove(ev);
+}
+
+}
@@ -0,0 +1,68 @@
+#ifndef PROGRESS_TRACKING_SCHEDULER_H
+#define PROGRESS_TRACKING_SCHEDULER_H
+
+#include <atomic>
+#include "ns3/core-module.h"
+
+namespace ns3 {
+
+/**
+ * Progress of a running simulation: the timestamp of the event which is executed
+ * and the number of events executed so far. It is only written by the simulation
+ * thread, and can be read from any other thread (e.g., to report progress).
+ */
+class SimulationProgress : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+    SimulationProgress();
+
+    // Called by the simulation thread for each event it executes
+    inline void RecordEvent(uint64_t ts) {
+        m_ts.store(ts, std::memory_order_relaxed);
+        m_num_events.store(m_num_events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Accessors (thread-safe)
+    uint64_t GetTs();
+    int64_t GetNumEvents();
+
+private:
+    std::atomic<uint64_t> m_ts;
+    std::atomic<int64_t> m_num_events;
+
+};
+
+/**
+ * Event scheduler which passes on every operation to another scheduler, and records
+ * each event which is removed next (i.e., executed) into the simulation progress.
+ * As such, progress can be followed without scheduling any events for it.
+ *
+ * Attributes (both are required):
+ * - Scheduler: scheduler which actually holds the events
+ * - Progress: simulation progress which is updated
+ */
+class ProgressTrackingScheduler : public Scheduler
+{
+public:
+    static TypeId GetTypeId (void);
+
+    ProgressTrackingScheduler();
+    virtual ~ProgressTrackingScheduler();
+
+    // Scheduler interface
+    virtual void Insert (const Event &ev);
+    virtual bool IsEmpty (void) const;
+    virtual Event PeekNext (void) const;
+    virtual Event RemoveNext (void);
+    virtual void Remove (const Event &ev);
+
+private:
+    Ptr<Scheduler> m_scheduler;
+    Ptr<SimulationProgress> m_progress;
+
+};
+
+}
+
+#endif //PROGRESS_TRACKING_SCHEDULER_H
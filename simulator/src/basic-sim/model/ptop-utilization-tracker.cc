@@ -22,6 +22,171 @@
 
 namespace ns3 {
 
+    static inline void append_varint(std::vector<uint8_t>& data, uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back((uint8_t) (value | 0x80));
+            value >>= 7;
+        }
+        data.push_back((uint8_t) value);
+    }
+
+    static inline uint64_t read_varint(const std::vector<uint8_t>& data, size_t& pos) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) {
+                throw std::runtime_error("Busy period log is truncated");
+            }
+            uint8_t byte = data[pos++];
+            value |= ((uint64_t) (byte & 0x7f)) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Busy period log has an invalid variable-length integer");
+    }
+
+    BusyPeriodLog::BusyPeriodLog() {
+        m_num_busy_periods = 0;
+        m_last_busy_end_ns = 0;
+        m_end_ns = 0;
+        m_finished = false;
+    }
+
+    BusyPeriodLog::BusyPeriodLog(std::vector<uint8_t> data, int64_t num_busy_periods, int64_t end_ns) {
+        m_data = std::move(data);
+        m_num_busy_periods = num_busy_periods;
+
+        // Decode it entirely once, such that it is certain to be valid
+        size_t pos = 0;
+        m_last_busy_end_ns = 0;
+        for (int64_t i = 0; i < m_num_busy_periods; i++) {
+            m_last_busy_end_ns += (int64_t) read_varint(m_data, pos);
+            m_last_busy_end_ns += (int64_t) read_varint(m_data, pos);
+        }
+        if (pos != m_data.size()) {
+            throw std::runtime_error("Busy period log has more data than busy periods");
+        }
+        m_finished = false;
+        Finish(end_ns);
+    }
+
+    void BusyPeriodLog::Append(int64_t start_ns, int64_t end_ns) {
+        if (m_finished) {
+            throw std::runtime_error("Cannot append to a finished busy period log");
+        }
+        if (start_ns < m_last_busy_end_ns || end_ns < start_ns) {
+            throw std::runtime_error(format_string(
+                    "Busy period [%" PRId64 ", %" PRId64 ") overlaps the previous one or is negative", start_ns, end_ns
+            ));
+        }
+        if (end_ns > start_ns) {
+            append_varint(m_data, start_ns - m_last_busy_end_ns);
+            append_varint(m_data, end_ns - start_ns);
+            m_num_busy_periods++;
+            m_last_busy_end_ns = end_ns;
+        }
+    }
+
+    void BusyPeriodLog::Finish(int64_t end_ns) {
+        if (end_ns < m_last_busy_end_ns) {
+            throw std::runtime_error("End of a busy period log cannot be before its last busy period");
+        }
+        m_end_ns = end_ns;
+        m_finished = true;
+    }
+
+    void BusyPeriodLog::ForEachInterval(int64_t interval_ns, const std::function<void(int64_t, int64_t, int64_t, int64_t)>& callback) const {
+        if (!m_finished) {
+            throw std::runtime_error("Busy period log must be finished before its utilization is derived");
+        }
+        if (interval_ns < 1) {
+            throw std::invalid_argument("Utilization interval must be at least 1 ns");
+        }
+
+        // Current interval [k * interval_ns, (k + 1) * interval_ns), and its busy time so far
+        int64_t k = 0;
+        int64_t busy_ns = 0;
+
+        size_t pos = 0;
+        int64_t prev_end_ns = 0;
+        for (int64_t i = 0; i < m_num_busy_periods; i++) {
+            int64_t start_ns = prev_end_ns + (int64_t) read_varint(m_data, pos);
+            int64_t end_ns = start_ns + (int64_t) read_varint(m_data, pos);
+            prev_end_ns = end_ns;
+
+            // The intervals before the one in which it starts are complete (the ones in between are idle)
+            int64_t k_start = start_ns / interval_ns;
+            if (k_start > k) {
+                callback(k * interval_ns, 1, interval_ns, busy_ns);
+                if (k_start > k + 1) {
+                    callback((k + 1) * interval_ns, k_start - k - 1, interval_ns, 0);
+                }
+                k = k_start;
+                busy_ns = 0;
+            }
+
+            // It can span multiple intervals (the ones in between are fully busy)
+            int64_t k_end = (end_ns - 1) / interval_ns;
+            if (k_end == k) {
+                busy_ns += end_ns - start_ns;
+            } else {
+                callback(k * interval_ns, 1, interval_ns, busy_ns + (k + 1) * interval_ns - start_ns);
+                if (k_end > k + 1) {
+                    callback((k + 1) * interval_ns, k_end - k - 1, interval_ns, interval_ns);
+                }
+                k = k_end;
+                busy_ns = end_ns - k * interval_ns;
+            }
+
+        }
+
+        // Remaining intervals until the end (the final one can be incomplete)
+        int64_t k_final = m_end_ns / interval_ns;
+        if (k_final > k) {
+            callback(k * interval_ns, 1, interval_ns, busy_ns);
+            if (k_final > k + 1) {
+                callback((k + 1) * interval_ns, k_final - k - 1, interval_ns, 0);
+            }
+            k = k_final;
+            busy_ns = 0;
+        }
+        if (m_end_ns > k * interval_ns) {
+            callback(k * interval_ns, 1, m_end_ns - k * interval_ns, busy_ns);
+        }
+
+    }
+
+    std::vector<std::tuple<int64_t, int64_t, int64_t>> BusyPeriodLog::GetCompressedUtilization(int64_t interval_ns) const {
+        std::vector<std::tuple<int64_t, int64_t, int64_t>> compressed_intervals;
+        double prev_interval_utilization = 0.0;
+        ForEachInterval(interval_ns, [&](int64_t start_ns, int64_t num_intervals, int64_t length_ns, int64_t busy_ns) {
+
+            // An interval is compressed into the previous one if its utilization is approximately
+            // equal to that of the interval right before it (the others of the same call are equal to it)
+            double utilization = ((double) busy_ns) / (double) length_ns;
+            if (compressed_intervals.empty() || std::abs(prev_interval_utilization - utilization) >= UTILIZATION_TRACKER_COMPRESSION_APPROXIMATELY_NOT_EQUAL) {
+                compressed_intervals.push_back(std::make_tuple(start_ns, start_ns, 0));
+            }
+            std::get<1>(compressed_intervals.back()) = start_ns + num_intervals * length_ns;
+            std::get<2>(compressed_intervals.back()) += num_intervals * busy_ns;
+            prev_interval_utilization = utilization;
+
+        });
+        return compressed_intervals;
+    }
+
+    const std::vector<uint8_t>& BusyPeriodLog::GetData() const {
+        return m_data;
+    }
+
+    int64_t BusyPeriodLog::GetNumBusyPeriods() const {
+        return m_num_busy_periods;
+    }
+
+    int64_t BusyPeriodLog::GetEndNs() const {
+        return m_end_ns;
+    }
+
     NS_OBJECT_ENSURE_REGISTERED (PtopUtilizationTracker);
     TypeId PtopUtilizationTracker::GetTypeId (void)
     {
@@ -32,88 +197,45 @@ namespace ns3 {
         return tid;
     }
 
-    PtopUtilizationTracker::PtopUtilizationTracker(Ptr<PointToPointNetDevice> netDevice, int64_t interval_ns) {
+    PtopUtilizationTracker::PtopUtilizationTracker(Ptr<PointToPointNetDevice> netDevice) {
 
         // Register this tracker into the tracing callbacks of the network device
         netDevice->TraceConnectWithoutContext("PhyTxBegin", MakeCallback(&PtopUtilizationTracker::NetDevicePhyTxBeginCallback, this));
         netDevice->TraceConnectWithoutContext("PhyTxEnd", MakeCallback(&PtopUtilizationTracker::NetDevicePhyTxEndCallback, this));
 
-        // Interval
-        m_interval_ns = interval_ns;
-
         // Starting state
-        m_prev_time_ns = 0;
-        m_current_interval_start = 0;
-        m_current_interval_end = m_interval_ns;
-        m_idle_time_counter_ns = 0;
-        m_busy_time_counter_ns = 0;
-        m_current_state_is_on = false;
+        m_open_busy_start_ns = 0;
+        m_open_busy_end_ns = 0;
+        m_tx_start_ns = 0;
+        m_is_transmitting = false;
 
     }
 
     void PtopUtilizationTracker::NetDevicePhyTxBeginCallback(Ptr<Packet const>) {
-        TrackUtilization(true);
+        m_tx_start_ns = Simulator::Now().GetNanoSeconds();
+        m_is_transmitting = true;
     }
 
     void PtopUtilizationTracker::NetDevicePhyTxEndCallback(Ptr<Packet const>) {
-        TrackUtilization(false);
-    }
-
-    void PtopUtilizationTracker::TrackUtilization(bool next_state_is_on) {
-
-        // Current time in nanoseconds
-        int64_t now_ns = Simulator::Now().GetNanoSeconds();
-        while (now_ns >= m_current_interval_end) {
-
-            // Add everything until the end of the interval
-            if (next_state_is_on) {
-                m_idle_time_counter_ns += m_current_interval_end - m_prev_time_ns;
-            } else {
-                m_busy_time_counter_ns += m_current_interval_end - m_prev_time_ns;
-            }
-
-            // Save into the intervals array
-            m_intervals.push_back(std::make_tuple(m_current_interval_start, m_current_interval_end, m_busy_time_counter_ns));
 
-            // This must match up
-            if (m_idle_time_counter_ns + m_busy_time_counter_ns != m_interval_ns) {
-                std::cout << m_idle_time_counter_ns << std::endl;
-                std::cout << m_busy_time_counter_ns << std::endl;
-                throw std::runtime_error("Must match up");
-            }
-
-            // Move to next interval
-            m_idle_time_counter_ns = 0;
-            m_busy_time_counter_ns = 0;
-            m_prev_time_ns = m_current_interval_end;
-            m_current_interval_start += m_interval_ns;
-            m_current_interval_end += m_interval_ns;
-
-        }
-
-        // If not at the end of a new interval, just keep track of it all
-        if (next_state_is_on) {
-            m_idle_time_counter_ns += now_ns - m_prev_time_ns;
-        } else {
-            m_busy_time_counter_ns += now_ns - m_prev_time_ns;
+        // A transmission which starts right where the previous one ended extends its busy period,
+        // else that busy period is complete and goes into the log
+        if (m_tx_start_ns != m_open_busy_end_ns) {
+            m_busy_period_log.Append(m_open_busy_start_ns, m_open_busy_end_ns);
+            m_open_busy_start_ns = m_tx_start_ns;
         }
-
-        // This has become the previous call
-        m_current_state_is_on = next_state_is_on;
-        m_prev_time_ns = now_ns;
+        m_open_busy_end_ns = Simulator::Now().GetNanoSeconds();
+        m_is_transmitting = false;
 
     }
 
-    const std::vector<std::tuple<int64_t, int64_t, int64_t>>& PtopUtilizationTracker::FinalizeUtilization() {
-        TrackUtilization(!m_current_state_is_on); // End the remaining completed interval(s)
-
-        // The final incomplete interval we also include
-        int64_t now_ns = Simulator::Now().GetNanoSeconds();
-        if (now_ns != m_current_interval_start) {
-            m_intervals.push_back(std::make_tuple(m_current_interval_start, now_ns, m_busy_time_counter_ns));
+    const BusyPeriodLog& PtopUtilizationTracker::FinalizeUtilization() {
+        if (m_is_transmitting) {
+            NetDevicePhyTxEndCallback(nullptr);
         }
-
-        return m_intervals;
+        m_busy_period_log.Append(m_open_busy_start_ns, m_open_busy_end_ns);
+        m_busy_period_log.Finish(Simulator::Now().GetNanoSeconds());
+        return m_busy_period_log;
     }
 
 }
@@ -34,38 +34,120 @@
 #include <unistd.h>
 #include <chrono>
 #include <stdexcept>
+#include <functional>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/exp-util.h"
 
+// Consecutive intervals of which the utilization differs less than this are compressed into one
+#define UTILIZATION_TRACKER_COMPRESSION_APPROXIMATELY_NOT_EQUAL 0.000001
 
 namespace ns3 {
 
+    /**
+     * Log of the busy periods of a link (which must be appended in order and may not overlap).
+     *
+     * Each busy period is stored as the pair (start - end of the previous busy period, duration),
+     * both as variable-length integers of 7 bits per byte, as such a busy period typically takes only 3-6 byte.
+     * The utilization per interval is only derived from it when asked for, for any interval length.
+     */
+    class BusyPeriodLog {
+
+    public:
+        BusyPeriodLog();
+
+        /**
+         * Restore a log from its data (as retrieved by GetData()).
+         *
+         * @param data                  Encoded busy periods
+         * @param num_busy_periods      Number of busy periods encoded in the data
+         * @param end_ns                End of the tracking (ns)
+         */
+        BusyPeriodLog(std::vector<uint8_t> data, int64_t num_busy_periods, int64_t end_ns);
+
+        /**
+         * Append a busy period (empty ones are ignored).
+         *
+         * @param start_ns  Start (ns), at or after the end of the previous busy period
+         * @param end_ns    End (ns)
+         */
+        void Append(int64_t start_ns, int64_t end_ns);
+
+        /**
+         * Set the end of the tracking, no further busy periods can be appended.
+         *
+         * @param end_ns    End of the tracking (ns), at or after the end of the last busy period
+         */
+        void Finish(int64_t end_ns);
+
+        /**
+         * Go over the utilization of every interval [k * interval_ns, (k + 1) * interval_ns) until the end
+         * of the tracking, of which the last one can be incomplete. Consecutive intervals without any
+         * change (e.g., idle or fully busy) are passed at once, as such this takes O(busy periods).
+         *
+         * @param interval_ns   Interval length (ns)
+         * @param callback      Called with (start of the first interval (ns), number of intervals,
+         *                      length of each interval (ns), busy time in each interval (ns))
+         */
+        void ForEachInterval(int64_t interval_ns, const std::function<void(int64_t, int64_t, int64_t, int64_t)>& callback) const;
+
+        /**
+         * Utilization with consecutive intervals of which the utilization differs less than
+         * UTILIZATION_TRACKER_COMPRESSION_APPROXIMATELY_NOT_EQUAL compressed into one.
+         *
+         * @param interval_ns   Interval length (ns)
+         *
+         * @return Compressed intervals (start (ns), end (ns), busy time (ns))
+         */
+        std::vector<std::tuple<int64_t, int64_t, int64_t>> GetCompressedUtilization(int64_t interval_ns) const;
+
+        // Accessors
+        const std::vector<uint8_t>& GetData() const;
+        int64_t GetNumBusyPeriods() const;
+        int64_t GetEndNs() const;
+
+    private:
+        std::vector<uint8_t> m_data;
+        int64_t m_num_busy_periods;
+        int64_t m_last_busy_end_ns;
+        int64_t m_end_ns;
+        bool m_finished;
+
+    };
+
+    /**
+     * Tracks the busy periods of a point-to-point network device, from which the utilization
+     * per interval is derived after the simulation. Back-to-back transmissions are merged into one busy period.
+     */
     class PtopUtilizationTracker : public Object {
 
     private:
 
-        // Parameters
-        int64_t m_interval_ns;
+        // Log of all busy periods which have ended
+        BusyPeriodLog m_busy_period_log;
 
-        // State
-        int64_t m_prev_time_ns;
-        int64_t m_current_interval_start;
-        int64_t m_current_interval_end;
-        int64_t m_idle_time_counter_ns;
-        int64_t m_busy_time_counter_ns;
-        bool m_current_state_is_on;
-        std::vector<std::tuple<int64_t, int64_t, int64_t>> m_intervals;
+        // Busy period which is still being extended, and the transmission which is ongoing
+        int64_t m_open_busy_start_ns;
+        int64_t m_open_busy_end_ns;
+        int64_t m_tx_start_ns;
+        bool m_is_transmitting;
 
     public:
         static TypeId GetTypeId (void);
-        PtopUtilizationTracker(Ptr<PointToPointNetDevice> netDevice, int64_t interval_ns);
+        PtopUtilizationTracker(Ptr<PointToPointNetDevice> netDevice);
         void NetDevicePhyTxBeginCallback(Ptr<Packet const>);
         void NetDevicePhyTxEndCallback(Ptr<Packet const>);
-        void TrackUtilization(bool next_state_is_on);
-        const std::vector<std::tuple<int64_t, int64_t, int64_t>>& FinalizeUtilization();
+
+        /**
+         * End the tracking now, an ongoing transmission counts as busy until now.
+         *
+         * @return Busy period log
+         */
+        const BusyPeriodLog& FinalizeUtilization();
+
     };
 
 }
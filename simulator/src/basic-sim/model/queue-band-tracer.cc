@@ -0,0 +1,105 @@
+#include "queue-band-tracer.h"
+
+namespace ns3 {
+
+QueueTraceMode parse_queue_trace_mode(const std::string& name) {
+    if (name == "change") {
+        return QUEUE_TRACE_CHANGE;
+    } else if (name == "interval") {
+        return QUEUE_TRACE_INTERVAL;
+    } else if (name == "max_min") {
+        return QUEUE_TRACE_MAX_MIN;
+    } else {
+        throw std::invalid_argument(format_string("Unknown queue trace mode: %s (valid: change, interval, max_min)", name.c_str()));
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED (QueueBandTracer);
+TypeId QueueBandTracer::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::QueueBandTracer")
+            .SetParent<Object> ()
+            .SetGroupName("BasicSim")
+    ;
+    return tid;
+}
+
+QueueBandTracer::QueueBandTracer(Ptr<BufferedLogSink> sink, QueueTraceMode mode, int64_t interval_ns) {
+    if (mode != QUEUE_TRACE_CHANGE && interval_ns < 1) {
+        throw std::invalid_argument("Queue trace interval must be at least 1 ns");
+    }
+    m_sink = sink;
+    m_mode = mode;
+    m_interval_ns = interval_ns;
+    m_has_pending_interval = false;
+    m_interval_start_ns = 0;
+    m_interval_value = 0;
+    m_interval_min = 0;
+    m_interval_max = 0;
+    if (m_mode != QUEUE_TRACE_CHANGE) {
+        m_sink->SetPreCloseCallback(MakeCallback(&QueueBandTracer::WritePendingInterval, this));
+    }
+}
+
+QueueBandTracer::~QueueBandTracer() {
+    if (m_mode != QUEUE_TRACE_CHANGE && !m_sink->IsClosed()) {
+        m_sink->SetPreCloseCallback(MakeNullCallback<void>());
+        try {
+            WritePendingInterval();
+        } catch (std::exception& e) {
+            std::cerr << "Could not write pending interval to " << m_sink->GetFilename() << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+void QueueBandTracer::BytesInQueueChange(uint32_t old_value, uint32_t new_value) {
+    RecordChange(Simulator::Now().GetNanoSeconds(), old_value, new_value);
+}
+
+void QueueBandTracer::RecordChange(int64_t now_ns, uint32_t old_value, uint32_t new_value) {
+    char line[96];
+    int size;
+    switch (m_mode) {
+
+        case QUEUE_TRACE_CHANGE:
+            size = snprintf(line, sizeof(line), "TcBytesInQueue %u to %u %" PRId64 "\n", old_value, new_value, now_ns);
+            m_sink->Write(line, size);
+            break;
+
+        case QUEUE_TRACE_INTERVAL:
+        case QUEUE_TRACE_MAX_MIN: {
+            int64_t interval_start_ns = now_ns - now_ns % m_interval_ns;
+            if (m_has_pending_interval && interval_start_ns != m_interval_start_ns) {
+                WritePendingInterval();
+            }
+            if (!m_has_pending_interval) {
+                m_has_pending_interval = true;
+                m_interval_start_ns = interval_start_ns;
+                m_interval_min = old_value;
+                m_interval_max = old_value;
+            }
+            m_interval_value = new_value;
+            m_interval_min = std::min(m_interval_min, new_value);
+            m_interval_max = std::max(m_interval_max, new_value);
+            break;
+        }
+
+    }
+}
+
+void QueueBandTracer::WritePendingInterval() {
+    if (!m_has_pending_interval) {
+        return;
+    }
+    char line[96];
+    int size;
+    if (m_mode == QUEUE_TRACE_INTERVAL) {
+        size = snprintf(line, sizeof(line), "TcBytesInQueue %" PRId64 " %u\n", m_interval_start_ns, m_interval_value);
+    } else {
+        size = snprintf(line, sizeof(line), "TcBytesInQueue %" PRId64 " %u %u\n", m_interval_start_ns, m_interval_min, m_interval_max);
+    }
+    m_sink->Write(line, size);
+    m_has_pending_interval = false;
+}
+
+}
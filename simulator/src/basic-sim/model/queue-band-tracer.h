@@ -0,0 +1,101 @@
+#ifndef QUEUE_BAND_TRACER_H
+#define QUEUE_BAND_TRACER_H
+
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cinttypes>
+#include "ns3/core-module.h"
+#include "ns3/exp-util.h"
+#include "ns3/buffered-log-sink.h"
+
+namespace ns3 {
+
+/**
+ * How the queue occupancy is written to the trace.
+ *
+ * QUEUE_TRACE_CHANGE       Every change: "TcBytesInQueue [old] to [new] [time_ns]"
+ * QUEUE_TRACE_INTERVAL     For every interval with a change, the value at its end: "TcBytesInQueue [interval_start_ns] [value]"
+ * QUEUE_TRACE_MAX_MIN      For every interval with a change, the minimum and maximum value
+ *                          (incl. the value at its start): "TcBytesInQueue [interval_start_ns] [min] [max]"
+ *
+ * Intervals without any change are not written, the value then remained the same.
+ */
+enum QueueTraceMode {
+    QUEUE_TRACE_CHANGE,
+    QUEUE_TRACE_INTERVAL,
+    QUEUE_TRACE_MAX_MIN
+};
+
+/**
+ * Parse the queue trace mode from its name ("change", "interval" or "max_min").
+ *
+ * @param name  Name of the mode
+ *
+ * @return Queue trace mode
+ */
+QueueTraceMode parse_queue_trace_mode(const std::string& name);
+
+/**
+ * Traces the bytes in a single internal queue (band) of a queueing discipline
+ * into its own buffered log sink.
+ */
+class QueueBandTracer : public Object
+{
+public:
+    static TypeId GetTypeId (void);
+
+    /**
+     * Create a tracer.
+     *
+     * @param sink          Log sink to write to (it must not be shared)
+     * @param mode          Trace mode
+     * @param interval_ns   Interval (ns), only used if the mode is not QUEUE_TRACE_CHANGE
+     */
+    QueueBandTracer(Ptr<BufferedLogSink> sink, QueueTraceMode mode, int64_t interval_ns);
+
+    /**
+     * Destroy the tracer: the interval which is still being aggregated is written
+     * and the sink no longer calls back into it when it is closed.
+     */
+    ~QueueBandTracer();
+
+    /**
+     * Trace sink of the "BytesInQueue" trace source.
+     *
+     * @param old_value     Previous bytes in queue
+     * @param new_value     New bytes in queue
+     */
+    void BytesInQueueChange(uint32_t old_value, uint32_t new_value);
+
+    /**
+     * Record a change of bytes in queue at a given time (in non-decreasing time order).
+     *
+     * @param now_ns        Time of the change (ns)
+     * @param old_value     Previous bytes in queue
+     * @param new_value     New bytes in queue
+     */
+    void RecordChange(int64_t now_ns, uint32_t old_value, uint32_t new_value);
+
+    /**
+     * Write the interval which is still being aggregated (called when the sink is closed).
+     */
+    void WritePendingInterval();
+
+private:
+    Ptr<BufferedLogSink> m_sink;
+    QueueTraceMode m_mode;
+    int64_t m_interval_ns;
+
+    // Interval aggregation
+    bool m_has_pending_interval;
+    int64_t m_interval_start_ns;
+    uint32_t m_interval_value;
+    uint32_t m_interval_min;
+    uint32_t m_interval_max;
+
+};
+
+}
+
+#endif //QUEUE_BAND_TRACER_H
@@ -1,5 +1,5 @@
 #include "topology-ptop.h"
-#define DEBUG_INTERNAL_QUEUE
+
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED(TopologyPtop);
@@ -37,34 +37,46 @@ void TopologyPtop::ReadRelevantConfig() {
   m_disable_qdisc_non_endpoint_switches =
       parse_boolean(m_basicSimulation->GetConfigParamOrFail(
           "disable_qdisc_non_endpoint_switches"));
+
+  // Tracing of the bytes in the internal queues (bands) of the endpoint qdiscs
+  m_queue_trace_enabled = parse_boolean(
+      m_basicSimulation->GetConfigParamOrDefault("queue_trace_enabled", "false"));
+  m_queue_trace_mode = parse_queue_trace_mode(
+      m_basicSimulation->GetConfigParamOrDefault("queue_trace_mode", "change"));
+  m_queue_trace_interval_ns = parse_positive_int64(
+      m_basicSimulation->GetConfigParamOrDefault("queue_trace_interval_ns", "1000000"));
+  if (m_queue_trace_enabled && m_disable_qdisc_endpoint_tors_xor_servers) {
+    throw std::invalid_argument(
+        "Queue tracing requires the endpoint queueing discipline (disable_qdisc_endpoint_tors_xor_servers=false)");
+  }
 }
 
-void TopologyPtop::ReadTopology() {
+// This is static
+topology_ptop_graph_t TopologyPtop::ReadTopologyGraph(const std::string& filename) {
   // Read the topology configuration
-  std::map<std::string, std::string> config =
-      read_config(m_basicSimulation->GetRunDir() + "/" +
-                  m_basicSimulation->GetConfigParamOrFail("filename_topology"));
+  std::map<std::string, std::string> config = read_config(filename);
+  topology_ptop_graph_t graph;
 
   // Basic
-  m_num_nodes = parse_positive_int64(get_param_or_fail("num_nodes", config));
-  m_num_undirected_edges =
+  graph.num_nodes = parse_positive_int64(get_param_or_fail("num_nodes", config));
+  graph.num_undirected_edges =
       parse_positive_int64(get_param_or_fail("num_undirected_edges", config));
 
   // Node types
   std::string tmp;
   tmp = get_param_or_fail("switches", config);
-  m_switches = parse_set_positive_int64(tmp);
-  all_items_are_less_than(m_switches, m_num_nodes);
+  graph.switches = parse_set_positive_int64(tmp);
+  all_items_are_less_than(graph.switches, graph.num_nodes);
   tmp = get_param_or_fail("switches_which_are_tors", config);
-  m_switches_which_are_tors = parse_set_positive_int64(tmp);
-  all_items_are_less_than(m_switches_which_are_tors, m_num_nodes);
+  graph.switches_which_are_tors = parse_set_positive_int64(tmp);
+  all_items_are_less_than(graph.switches_which_are_tors, graph.num_nodes);
   tmp = get_param_or_fail("servers", config);
-  m_servers = parse_set_positive_int64(tmp);
-  all_items_are_less_than(m_servers, m_num_nodes);
+  graph.servers = parse_set_positive_int64(tmp);
+  all_items_are_less_than(graph.servers, graph.num_nodes);
 
   // Adjacency list
-  for (int i = 0; i < m_num_nodes; i++) {
-    m_adjacency_list.push_back(std::set<int64_t>());
+  for (int i = 0; i < graph.num_nodes; i++) {
+    graph.adjacency_list.push_back(std::set<int64_t>());
   }
 
   // Edges
@@ -78,59 +90,56 @@ void TopologyPtop::ReadTopology() {
       throw std::invalid_argument(
           format_string("Cannot have edge to itself on node %" PRIu64 "", a));
     }
-    if (a >= m_num_nodes) {
+    if (a >= graph.num_nodes) {
       throw std::invalid_argument(format_string(
           "Left node identifier in edge does not exist: %" PRIu64 "", a));
     }
-    if (b >= m_num_nodes) {
+    if (b >= graph.num_nodes) {
       throw std::invalid_argument(format_string(
           "Right node identifier in edge does not exist: %" PRIu64 "", b));
     }
-    m_undirected_edges.push_back(std::make_pair(a < b ? a : b, a < b ? b : a));
-    m_undirected_edges_set.insert(std::make_pair(a < b ? a : b, a < b ? b : a));
-    m_adjacency_list[a].insert(b);
-    m_adjacency_list[b].insert(a);
+    graph.undirected_edges.push_back(std::make_pair(a < b ? a : b, a < b ? b : a));
+    graph.undirected_edges_set.insert(std::make_pair(a < b ? a : b, a < b ? b : a));
+    graph.adjacency_list[a].insert(b);
+    graph.adjacency_list[b].insert(a);
   }
 
   // Sort them for convenience
-  std::sort(m_undirected_edges.begin(), m_undirected_edges.end());
+  std::sort(graph.undirected_edges.begin(), graph.undirected_edges.end());
 
-  for(auto e: m_undirected_edges){
-    std::cout <<"undirected edges sorted:"<<e.first<<" "<<e.second<<std::endl;
-  }
   // Edge checks
 
-  if (m_undirected_edges.size() != (size_t)m_num_undirected_edges) {
+  if (graph.undirected_edges.size() != (size_t)graph.num_undirected_edges) {
     throw std::invalid_argument(
         "Indicated number of undirected edges does not match edge set");
   }
 
-  if (m_undirected_edges.size() != m_undirected_edges_set.size()) {
+  if (graph.undirected_edges.size() != graph.undirected_edges_set.size()) {
     throw std::invalid_argument("Duplicates in edge set");
   }
 
   // Node type hierarchy checks
 
-  if (!direct_set_intersection(m_servers, m_switches).empty()) {
+  if (!direct_set_intersection(graph.servers, graph.switches).empty()) {
     throw std::invalid_argument(
         "Server and switch identifiers are not distinct");
   }
 
-  if (direct_set_union(m_servers, m_switches).size() != (size_t)m_num_nodes) {
+  if (direct_set_union(graph.servers, graph.switches).size() != (size_t)graph.num_nodes) {
     throw std::invalid_argument(
         "The servers and switches do not encompass all nodes");
   }
 
-  if (direct_set_intersection(m_switches, m_switches_which_are_tors).size() !=
-      m_switches_which_are_tors.size()) {
+  if (direct_set_intersection(graph.switches, graph.switches_which_are_tors).size() !=
+      graph.switches_which_are_tors.size()) {
     throw std::invalid_argument("Servers are marked as ToRs");
   }
 
   // Servers must be connected to ToRs only
-  for (int64_t node_id : m_servers) {
-    for (int64_t neighbor_id : m_adjacency_list[node_id]) {
-      if (m_switches_which_are_tors.find(neighbor_id) ==
-          m_switches_which_are_tors.end()) {
+  for (int64_t node_id : graph.servers) {
+    for (int64_t neighbor_id : graph.adjacency_list[node_id]) {
+      if (graph.switches_which_are_tors.find(neighbor_id) ==
+          graph.switches_which_are_tors.end()) {
         throw std::invalid_argument(
             format_string("Server node %" PRId64 " has an edge to node %" PRId64
                           " which is not a ToR.",
@@ -139,6 +148,27 @@ void TopologyPtop::ReadTopology() {
     }
   }
 
+  return graph;
+}
+
+void TopologyPtop::ReadTopology() {
+  // Read and check the graph
+  topology_ptop_graph_t graph = ReadTopologyGraph(
+      m_basicSimulation->GetRunDir() + "/" +
+      m_basicSimulation->GetConfigParamOrFail("filename_topology"));
+  m_num_nodes = graph.num_nodes;
+  m_num_undirected_edges = graph.num_undirected_edges;
+  m_switches = std::move(graph.switches);
+  m_switches_which_are_tors = std::move(graph.switches_which_are_tors);
+  m_servers = std::move(graph.servers);
+  m_undirected_edges = std::move(graph.undirected_edges);
+  m_undirected_edges_set = std::move(graph.undirected_edges_set);
+  m_adjacency_list = std::move(graph.adjacency_list);
+
+  for(auto e: m_undirected_edges){
+    std::cout <<"undirected edges sorted:"<<e.first<<" "<<e.second<<std::endl;
+  }
+
   // Check
   if (m_servers.size() > 0) {
     m_has_zero_servers = false;
@@ -245,6 +275,11 @@ void TopologyPtop::SetupLinks() {
         << "    >> Flow-endpoints....... none (PfifoFastQueueDisc with 1000 "
            "max. queue size)"
         << std::endl;
+    if (m_queue_trace_enabled) {
+      std::cout << "    >> Tracing the bytes in each of its three bands (mode: "
+                << m_basicSimulation->GetConfigParamOrDefault("queue_trace_mode", "change")
+                << ")" << std::endl;
+    }
 
   }
 
@@ -325,6 +360,12 @@ void TopologyPtop::SetupLinks() {
     m_interface_idxs_for_edges.push_back(std::make_pair(a, b));
   }
 
+  // Index of IP address to node id, shared by all arbiters
+  m_ip_to_node_id_index = CreateObject<IpToNodeIdIndex>(m_nodes);
+  std::cout << "  > IP to node id index: " << m_ip_to_node_id_index->GetNumEntries()
+            << " IP addresses in " << m_ip_to_node_id_index->GetCapacity()
+            << " slots" << std::endl;
+
   std::cout << std::endl;
   m_basicSimulation->RegisterTimestamp(
       "Create links and edge-to-interface-index mapping");
@@ -388,27 +429,36 @@ TopologyPtop::GetInterfaceIdxsForEdges() {
   return m_interface_idxs_for_edges;
 }
 
+Ptr<IpToNodeIdIndex> TopologyPtop::GetIpToNodeIdIndex() {
+  return m_ip_to_node_id_index;
+}
+
 double TopologyPtop::GetNumberOfActiveBursts(){
   return m_num_active_bursts;
 }
 
 void TopologyPtop::RecordInternalQueues(QueueDiscContainer qdiscs, int64_t node){
-  #ifdef DEBUG_INTERNAL_QUEUE 
-  Ptr<QueueDisc> q = qdiscs.Get (0);  
-      
-  q->GetTypeId();
-  std::vector<Ptr<QueueDisc::InternalQueue>> internal_queues;
+  if (!m_queue_trace_enabled) {
+    return;
+  }
+
+  // The three bands are added explicitly such that each can be traced
+  Ptr<QueueDisc> q = qdiscs.Get(0);
+  q->SetAttributeFailSafe("MaxSize", StringValue("1000p"));
   for (uint16_t i = 0; i < 3; i++) {
-    Ptr<DropTailQueue<QueueDiscItem> > queue =
-    CreateObject<DropTailQueue<QueueDiscItem> >();
-    bool ok = q->SetAttributeFailSafe("MaxSize", StringValue("1000p"));
-    std::cout<<"Added an internal queue, ok: "<<ok<<std::endl;
+    Ptr<DropTailQueue<QueueDiscItem>> queue =
+        CreateObject<DropTailQueue<QueueDiscItem>>();
     q->AddInternalQueue(queue);
-    Callback<void, uint32_t, uint32_t> cb(Ptr<MyCallback>(new MyCallback(m_basicSimulation->GetLogsDir() , node, i)));
-    queue->TraceConnectWithoutContext ("BytesInQueue", cb);
-
+    Ptr<BufferedLogSink> sink = m_basicSimulation->CreateLogSink(
+        format_string("Node_%" PRId64 "_queue_band_%u.txt", node, i),
+        65536, false);
+    Ptr<QueueBandTracer> tracer = CreateObject<QueueBandTracer>(
+        sink, m_queue_trace_mode, m_queue_trace_interval_ns);
+    queue->TraceConnectWithoutContext(
+        "BytesInQueue",
+        MakeCallback(&QueueBandTracer::BytesInQueueChange, tracer));
+    m_queue_band_tracers.push_back(tracer);
   }
-  #endif
 }
 
 }  // namespace ns3
@@ -18,38 +18,26 @@
 #include "ns3/traffic-control-helper.h"
 #include "ns3/callback.h"
 #include "ns3/packet.h"
+#include "ns3/ip-to-node-id-index.h"
+#include "ns3/queue-band-tracer.h"
 // #include "ns3/utilization-tracker.h"
 
 
 namespace ns3 {
-void TcBytessInQueueTrace (uint32_t oldValue, uint32_t newValue);
 
-class MyCallback: public CallbackImpl<void, uint32_t, uint32_t,empty,empty,empty,empty,empty,empty,empty>
-{
-  public:
-      MyCallback(std::string baselogdir, int64_t node, uint16_t band){
-        m_base_logdir = baselogdir;
-        queue_node = node;
-        queue_band = band; };
-      
-      void operator() (uint32_t old_value, uint32_t new_value) {
-        std::ofstream ofs;
-        ofs.open(m_base_logdir + "/" + format_string("Node_%d_queue_band_%u.txt", queue_node, queue_band),
-        std::ofstream::out | std::ofstream::app);
-        ofs << "TcBytesInQueue " << old_value << " to " << new_value 
-                << " "<< Simulator::Now().GetNanoSeconds()<<std::endl;
-        
-        ofs.close(); 
-    
-      }      
-        bool IsEqual (Ptr<const CallbackImplBase> other) const {
-            return false;
-        }
-
-  private:
-      std::string m_base_logdir;
-      int64_t queue_node;
-      uint16_t queue_band; 
+/**
+ * Graph of a point-to-point topology file, read and checked without creating any nodes
+ * (e.g., to calculate the routing state of a topology once for many runs).
+ */
+struct topology_ptop_graph_t {
+    int64_t num_nodes;
+    int64_t num_undirected_edges;
+    std::set<int64_t> switches;
+    std::set<int64_t> switches_which_are_tors;
+    std::set<int64_t> servers;
+    std::vector<std::pair<int64_t, int64_t>> undirected_edges; // Sorted
+    std::set<std::pair<int64_t, int64_t>> undirected_edges_set;
+    std::vector<std::set<int64_t>> adjacency_list;
 };
 
 class TopologyPtop : public Topology
@@ -59,6 +47,7 @@ public:
     // Constructors
     static TypeId GetTypeId (void);
     TopologyPtop(Ptr<BasicSimulation> basicSimulation, const Ipv4RoutingHelper& ipv4RoutingHelper);
+    static topology_ptop_graph_t ReadTopologyGraph(const std::string& filename);
 
     // Accessors
     const NodeContainer& GetNodes();
@@ -75,6 +64,7 @@ public:
     const std::set<int64_t>& GetAdjacencyList(int64_t node_id);
     int64_t GetWorstCaseRttEstimateNs();
     const std::vector<std::pair<uint32_t, uint32_t>>& GetInterfaceIdxsForEdges();
+    Ptr<IpToNodeIdIndex> GetIpToNodeIdIndex();
     void RecordInternalQueues(QueueDiscContainer qdiscs_ptr, int64_t node);
     double GetNumberOfActiveBursts();
 
@@ -97,6 +87,9 @@ private:
     bool m_disable_qdisc_endpoint_tors_xor_servers;
     bool m_disable_qdisc_non_endpoint_switches;
     double m_num_active_bursts;
+    bool m_queue_trace_enabled;
+    QueueTraceMode m_queue_trace_mode;
+    int64_t m_queue_trace_interval_ns;
     // Graph properties
     int64_t m_num_nodes;
     int64_t m_num_undirected_edges;
@@ -111,6 +104,8 @@ private:
     // From generating ns3 objects
     NodeContainer m_nodes;
     std::vector<std::pair<uint32_t, uint32_t>> m_interface_idxs_for_edges;
+    Ptr<IpToNodeIdIndex> m_ip_to_node_id_index;
+    std::vector<Ptr<QueueBandTracer>> m_queue_band_tracers;
 };
 
 }
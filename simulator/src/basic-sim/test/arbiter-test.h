@@ -47,6 +47,7 @@ void cleanup_arbiter_test() {
     remove_file_if_exists(arbiter_test_dir + "/topology.properties.temp");
     remove_file_if_exists(arbiter_test_dir + "/logs_ns3/finished.txt");
     remove_file_if_exists(arbiter_test_dir + "/logs_ns3/timing_results.txt");
+    remove_file_if_exists(arbiter_test_dir + "/logs_ns3/route_cache.csv");
     remove_dir_if_exists(arbiter_test_dir + "/logs_ns3");
     remove_dir_if_exists(arbiter_test_dir);
 }
@@ -84,6 +85,16 @@ public:
         ASSERT_EXCEPTION(arbiter->ResolveNodeIdFromIp(Ipv4Address("10.0.0.0").Get()));
         ASSERT_EXCEPTION(arbiter->ResolveNodeIdFromIp(Ipv4Address("10.0.1.3").Get()));
         ASSERT_EXCEPTION(arbiter->ResolveNodeIdFromIp(Ipv4Address("10.0.4.1").Get()));
+        ASSERT_EXCEPTION(arbiter->ResolveNodeIdFromIp(Ipv4Address("0.0.0.0").Get()));
+
+        // Shared index built by the topology
+        Ptr<IpToNodeIdIndex> index = topology->GetIpToNodeIdIndex();
+        ASSERT_EQUAL(index->GetNumEntries(), 8);
+        ASSERT_EQUAL(index->GetCapacity(), 16);
+        ASSERT_EQUAL(index->Lookup(Ipv4Address("10.0.1.2").Get()), 3);
+        ASSERT_EQUAL(index->Lookup(Ipv4Address("10.0.3.1").Get()), 2);
+        ASSERT_EQUAL(index->Lookup(Ipv4Address("10.0.3.3").Get()), -1);
+        ASSERT_EQUAL(index->Lookup(Ipv4Address("127.0.0.1").Get()), -1);
 
         basicSimulation->Finalize();
         cleanup_arbiter_test();
@@ -190,6 +201,26 @@ public:
             // std::cout << "Hash[" << i << "] = " << hash_results[i] << std::endl;
         }
 
+        // The same holds for the CRC32-C hash function
+        Ptr<ArbiterEcmp> routingArbiterEcmpCrc32c = CreateObject<ArbiterEcmp>(
+                nodes.Get(0), nodes, topology, ArbiterEcmpHelper::CalculateGlobalState(topology, 1), parse_ecmp_hash_function("crc32c"), false
+        );
+        std::vector<uint32_t> crc32c_hash_results;
+        for (ecmp_fields_t e : cases) {
+            Ptr<Packet> p = Create<Packet>(5);
+            create_headered_packet(p, e);
+            Ipv4Header ipHeader;
+            p->RemoveHeader(ipHeader);
+            crc32c_hash_results.push_back(routingArbiterEcmpCrc32c->ComputeFiveTupleHash(ipHeader, p, e.node_id, false));
+        }
+        for (int i = 0; i < num_cases; i++) {
+            for (int j = i + 1; j < num_cases; j++) {
+                ASSERT_NOT_EQUAL(crc32c_hash_results[i], crc32c_hash_results[j]);
+            }
+        }
+        ASSERT_EQUAL(parse_ecmp_hash_function("murmur3"), ECMP_HASH_MURMUR3);
+        ASSERT_EXCEPTION(parse_ecmp_hash_function("md5"));
+
         ///////
         // Test same hash
 
@@ -444,39 +475,242 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
-// Currently disabled because it takes too long for a quick test
-class ArbiterEcmpTooBigFailTestCase : public TestCase
+class ArbiterEcmpGlobalStateThreadsTestCase : public TestCase
 {
 public:
-    ArbiterEcmpTooBigFailTestCase () : TestCase ("routing-arbiter-ecmp too-big-fail") {};
+    ArbiterEcmpGlobalStateThreadsTestCase () : TestCase ("routing-arbiter-ecmp global-state-threads") {};
     void DoRun () {
         prepare_arbiter_test_config();
 
+        // Leaf-spine with 4 leafs and 2 spines, and a leaf which is only connected to one spine
         std::ofstream topology_file;
-        topology_file.open (arbiter_test_dir + "topology.properties.temp");
-        topology_file << "num_nodes=40001" << std::endl;
-        topology_file << "num_undirected_edges=0" << std::endl;
-        topology_file << "switches=set(";
-        for (int i = 0; i < 40001; i++) {
-            if (i == 0) {
-                topology_file << i;
-            } else {
-                topology_file << "," << i;
+        topology_file.open (arbiter_test_dir + "/topology.properties.temp");
+        topology_file << "num_nodes=7" << std::endl;
+        topology_file << "num_undirected_edges=9" << std::endl;
+        topology_file << "switches=set(0,1,2,3,4,5,6)" << std::endl;
+        topology_file << "switches_which_are_tors=set(0,1,2,3,4)" << std::endl;
+        topology_file << "servers=set()" << std::endl;
+        topology_file << "undirected_edges=set(0-5,0-6,1-5,1-6,2-5,2-6,3-5,3-6,4-6)" << std::endl;
+        topology_file.close();
+
+        // Create topology
+        Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(arbiter_test_dir);
+        Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+
+        // The result must not depend on the number of threads
+        Ptr<EcmpNextHopTable> state_one = ArbiterEcmpHelper::CalculateGlobalState(topology, 1);
+        for (int64_t num_threads = 2; num_threads <= 8; num_threads++) {
+            Ptr<EcmpNextHopTable> state_multi = ArbiterEcmpHelper::CalculateGlobalState(topology, num_threads);
+            for (int i = 0; i < 7; i++) {
+                for (int j = 0; j < 7; j++) {
+                    ASSERT_TRUE(state_one->GetCandidates(i, j) == state_multi->GetCandidates(i, j));
+                }
+            }
+        }
+        ASSERT_EXCEPTION(ArbiterEcmpHelper::CalculateGlobalState(topology, 0));
+
+        // Leaf to leaf over both spines
+        ASSERT_TRUE(state_one->GetCandidates(0, 1) == std::vector<uint32_t>({5, 6}));
+        ASSERT_TRUE(state_one->GetCandidates(3, 2) == std::vector<uint32_t>({5, 6}));
+
+        // Leaf 4 is only reachable via spine 6
+        ASSERT_TRUE(state_one->GetCandidates(0, 4) == std::vector<uint32_t>({6}));
+        ASSERT_TRUE(state_one->GetCandidates(5, 4) == std::vector<uint32_t>({0, 1, 2, 3}));
+        ASSERT_TRUE(state_one->GetCandidates(4, 0) == std::vector<uint32_t>({6}));
+
+        // Spine to spine
+        ASSERT_TRUE(state_one->GetCandidates(5, 6) == std::vector<uint32_t>({0, 1, 2, 3}));
+        ASSERT_TRUE(state_one->GetCandidates(6, 5) == std::vector<uint32_t>({0, 1, 2, 3}));
+
+        // Direct neighbors and to itself
+        ASSERT_TRUE(state_one->GetCandidates(0, 5) == std::vector<uint32_t>({5}));
+        ASSERT_TRUE(state_one->GetCandidates(6, 4) == std::vector<uint32_t>({4}));
+        for (int i = 0; i < 7; i++) {
+            ASSERT_EQUAL(state_one->GetNumCandidates(i, i), 0);
+            ASSERT_EQUAL(state_one->SelectNextHop(i, i, 12345), -1);
+        }
+
+        // Selection is by hash modulo the number of candidates
+        ASSERT_EQUAL(state_one->SelectNextHop(5, 4, 0), 0);
+        ASSERT_EQUAL(state_one->SelectNextHop(5, 4, 1), 1);
+        ASSERT_EQUAL(state_one->SelectNextHop(5, 4, 7), 3);
+        ASSERT_EQUAL(state_one->SelectNextHop(0, 1, 9), 6);
+
+        // Memory: 8 uint64 row offsets, 7 * 8 uint32 destination offsets and an uint16 per next hop
+        ASSERT_TRUE(state_one->IsCompact());
+        int64_t num_next_hops = 0;
+        for (int i = 0; i < 7; i++) {
+            for (int j = 0; j < 7; j++) {
+                num_next_hops += state_one->GetNumCandidates(i, j);
             }
         }
-        topology_file << ")" << std::endl;
-        topology_file << "switches_which_are_tors=set()" << std::endl;
+        ASSERT_EQUAL(state_one->GetNumNextHops(), num_next_hops);
+        ASSERT_EQUAL(state_one->GetMemoryUsageByte(), 8 * 8 + 4 * 7 * 8 + 2 * num_next_hops);
+
+        // Clean-up
+        basicSimulation->Finalize();
+        cleanup_arbiter_test();
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class ArbiterEcmpFlowHashTagTestCase : public TestCase
+{
+public:
+    ArbiterEcmpFlowHashTagTestCase () : TestCase ("routing-arbiter-ecmp flow-hash-tag") {};
+
+    void CountViaNodeOne(Ptr<ArbiterEcmp> arbiter, Ptr<TopologyPtop> topology, bool check_tag, int64_t& num_via_one) {
+        num_via_one = 0;
+        for (int i = 0; i < 2000; i++) {
+            Ptr<Packet> p = Create<Packet>(100);
+            create_headered_packet(p, {0, Ipv4Address("10.0.0.1").Get(), Ipv4Address("10.0.2.2").Get(), true, false, (uint16_t) (1024 + i), 80});
+            Ipv4Header ipHeader;
+            p->RemoveHeader(ipHeader);
+            int32_t next_hop = arbiter->TopologyPtopDecide(0, 2, topology->GetAdjacencyList(0), p, ipHeader, false);
+            ASSERT_TRUE(next_hop == 1 || next_hop == 3);
+            if (check_tag) {
+
+                // The tag is stamped with the 5-tuple hash without node id
+                EcmpFlowHashTag tag;
+                ASSERT_TRUE(p->PeekPacketTag(tag));
+                ASSERT_EQUAL(tag.GetFlowHash(), arbiter->ComputeFiveTupleHash(ipHeader, p, 0, false));
+
+                // The next decision on the same packet re-uses the tag
+                ASSERT_EQUAL(arbiter->TopologyPtopDecide(0, 2, topology->GetAdjacencyList(0), p, ipHeader, false), next_hop);
+                ASSERT_EQUAL(arbiter->GetOrStampFlowHash(ipHeader, p), tag.GetFlowHash());
+
+            }
+            num_via_one += next_hop == 1 ? 1 : 0;
+        }
+    }
+
+    void DoRun () {
+        prepare_arbiter_test();
+
+        // Create topology
+        Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(arbiter_test_dir);
+        Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
+        NodeContainer nodes = topology->GetNodes();
+        Ptr<EcmpNextHopTable> next_hop_table = ArbiterEcmpHelper::CalculateGlobalState(topology, 1);
+
+        // In the ring 0-1-2-3-0, node 0 can reach node 2 via either 1 or 3
+        Ptr<ArbiterEcmp> arbiterTag = CreateObject<ArbiterEcmp>(nodes.Get(0), nodes, topology, next_hop_table, ECMP_HASH_MURMUR3, true);
+        Ptr<ArbiterEcmp> arbiterNoTag = CreateObject<ArbiterEcmp>(nodes.Get(0), nodes, topology, next_hop_table, ECMP_HASH_MURMUR3, false);
+
+        // Both should spread the flows evenly
+        int64_t num_via_one_tag;
+        int64_t num_via_one_no_tag;
+        CountViaNodeOne(arbiterTag, topology, true, num_via_one_tag);
+        CountViaNodeOne(arbiterNoTag, topology, false, num_via_one_no_tag);
+        ASSERT_TRUE(num_via_one_tag >= 900 && num_via_one_tag <= 1100);
+        ASSERT_TRUE(num_via_one_no_tag >= 900 && num_via_one_no_tag <= 1100);
+
+        // Every hop mixes in its node id
+        ASSERT_NOT_EQUAL(ArbiterEcmp::MixFlowHashWithNodeId(12345, 0), ArbiterEcmp::MixFlowHashWithNodeId(12345, 1));
+        ASSERT_NOT_EQUAL(ArbiterEcmp::MixFlowHashWithNodeId(12345, 0), ArbiterEcmp::MixFlowHashWithNodeId(12346, 0));
+
+        // Socket requests for the source IP do not get a tag
+        Ptr<Packet> p = Create<Packet>(0);
+        Ipv4Header ipHeader;
+        ipHeader.SetSource(Ipv4Address("102.102.102.102"));
+        ipHeader.SetDestination(Ipv4Address("10.0.2.2"));
+        ipHeader.SetProtocol(6);
+        arbiterTag->TopologyPtopDecide(0, 2, topology->GetAdjacencyList(0), p, ipHeader, true);
+        EcmpFlowHashTag tag;
+        ASSERT_FALSE(p->PeekPacketTag(tag));
+
+        // Clean-up
+        basicSimulation->Finalize();
+        cleanup_arbiter_test();
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class ArbiterEcmpRoutingCacheTestCase : public TestCase
+{
+public:
+    ArbiterEcmpRoutingCacheTestCase () : TestCase ("routing-arbiter-ecmp routing-cache") {};
+    void DoRun () {
+        prepare_arbiter_test_config();
+
+        // Leaf-spine with 4 leafs and 2 spines, and a leaf which is only connected to one spine
+        std::ofstream topology_file;
+        topology_file.open (arbiter_test_dir + "/topology.properties.temp");
+        topology_file << "num_nodes=7" << std::endl;
+        topology_file << "num_undirected_edges=9" << std::endl;
+        topology_file << "switches=set(0,1,2,3,4,5,6)" << std::endl;
+        topology_file << "switches_which_are_tors=set(0,1,2,3,4)" << std::endl;
         topology_file << "servers=set()" << std::endl;
-        topology_file << "undirected_edges=set()" << std::endl;
+        topology_file << "undirected_edges=set(0-5,0-6,1-5,1-6,2-5,2-6,3-5,3-6,4-6)" << std::endl;
         topology_file.close();
 
         // Create topology
         Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(arbiter_test_dir);
         Ptr<TopologyPtop> topology = CreateObject<TopologyPtop>(basicSimulation, Ipv4ArbiterRoutingHelper());
-        ASSERT_EXCEPTION(ArbiterEcmpHelper::InstallArbiters(basicSimulation, topology)); // > 40000 nodes is not allowed
+        std::string topology_filename = arbiter_test_dir + "/topology.properties.temp";
+        std::string cache_dir = arbiter_test_dir + "/ecmp_routing_cache";
+        std::string cache_filename = cache_dir + "/" + ArbiterEcmpHelper::GetRoutingCacheFilename(topology_filename);
+
+        // The cache file name only depends on the topology file content
+        ASSERT_TRUE(starts_with(ArbiterEcmpHelper::GetRoutingCacheFilename(topology_filename), "ecmp_next_hop_table_"));
+        ASSERT_EQUAL(ArbiterEcmpHelper::GetRoutingCacheFilename(topology_filename), ArbiterEcmpHelper::GetRoutingCacheFilename(topology_filename));
+        ASSERT_EXCEPTION(ArbiterEcmpHelper::GetRoutingCacheFilename(arbiter_test_dir + "/does-not-exist.properties"));
+
+        // First time it is calculated and stored, second time it is loaded
+        Ptr<EcmpNextHopTable> state_calculated = ArbiterEcmpHelper::CalculateOrLoadGlobalState(topology, 2, topology_filename, cache_dir);
+        ASSERT_FALSE(state_calculated->IsMemoryMapped());
+        ASSERT_TRUE(file_exists(cache_filename));
+        Ptr<EcmpNextHopTable> state_loaded = ArbiterEcmpHelper::CalculateOrLoadGlobalState(topology, 2, topology_filename, cache_dir);
+        ASSERT_TRUE(state_loaded->IsMemoryMapped());
+
+        // Loaded must be identical to the calculated
+        ASSERT_EQUAL(state_loaded->GetNumNodes(), 7);
+        ASSERT_EQUAL(state_loaded->IsCompact(), state_calculated->IsCompact());
+        ASSERT_EQUAL(state_loaded->GetNumNextHops(), state_calculated->GetNumNextHops());
+        ASSERT_EQUAL(state_loaded->GetMemoryUsageByte(), state_calculated->GetMemoryUsageByte());
+        for (int i = 0; i < 7; i++) {
+            for (int j = 0; j < 7; j++) {
+                ASSERT_TRUE(state_loaded->GetCandidates(i, j) == state_calculated->GetCandidates(i, j));
+                for (uint32_t h = 0; h < 10; h++) {
+                    ASSERT_EQUAL(state_loaded->SelectNextHop(i, j, h), state_calculated->SelectNextHop(i, j, h));
+                }
+            }
+        }
+
+        // A corrupt cache file is not loaded but instead re-calculated and overwritten
+        // (the mapping is released first, as it is of the file which is truncated)
+        state_loaded = nullptr;
+        std::ofstream corrupt_file(cache_filename, std::ofstream::binary | std::ofstream::trunc);
+        corrupt_file << "ECMPNHT1 but truncated";
+        corrupt_file.close();
+        ASSERT_EXCEPTION(CreateObject<EcmpNextHopTable>(cache_filename));
+
+        // So is one whose header claims a number of nodes which would overflow the size calculation
+        std::ofstream huge_file(cache_filename, std::ofstream::binary | std::ofstream::trunc);
+        uint32_t byte_order = 0x01020304;
+        uint32_t is_compact = 0;
+        int64_t num_nodes = ((int64_t) 1) << 62;
+        uint64_t num_next_hops = 0;
+        huge_file.write("ECMPNHT1", 8);
+        huge_file.write((const char*) &byte_order, sizeof(byte_order));
+        huge_file.write((const char*) &is_compact, sizeof(is_compact));
+        huge_file.write((const char*) &num_nodes, sizeof(num_nodes));
+        huge_file.write((const char*) &num_next_hops, sizeof(num_next_hops));
+        huge_file.write("\0\0\0\0\0\0\0\0", 8);
+        huge_file.close();
+        ASSERT_EXCEPTION(CreateObject<EcmpNextHopTable>(cache_filename));
+        Ptr<EcmpNextHopTable> state_recalculated = ArbiterEcmpHelper::CalculateOrLoadGlobalState(topology, 2, topology_filename, cache_dir);
+        ASSERT_FALSE(state_recalculated->IsMemoryMapped());
+        ASSERT_TRUE(CreateObject<EcmpNextHopTable>(cache_filename)->GetCandidates(5, 4) == std::vector<uint32_t>({0, 1, 2, 3}));
 
         // Clean-up
         basicSimulation->Finalize();
+        remove_file_if_exists(cache_filename);
+        remove_dir_if_exists(cache_dir);
         cleanup_arbiter_test();
 
     }
@@ -5,6 +5,10 @@
 #include "exp-util-test.h"
 #include "topology-ptop-test.h"
 #include "arbiter-test.h"
+#include "buffered-log-sink-test.h"
+#include "queue-band-tracer-test.h"
+#include "simulator-scheduler-test.h"
+#include "ptop-utilization-tracker-test.h"
 
 using namespace ns3;
 
@@ -23,12 +27,21 @@ public:
         AddTestCase(new TopologyLeafSpineTestCase, TestCase::QUICK);
         AddTestCase(new TopologyRingTestCase, TestCase::QUICK);
         AddTestCase(new TopologyInvalidTestCase, TestCase::QUICK);
+        AddTestCase(new TopologyGraphTestCase, TestCase::QUICK);
         AddTestCase(new ArbiterIpResolutionTestCase, TestCase::QUICK);
         AddTestCase(new ArbiterEcmpHashTestCase, TestCase::QUICK);
         AddTestCase(new ArbiterEcmpStringReprTestCase, TestCase::QUICK);
         AddTestCase(new ArbiterBadImplTestCase, TestCase::QUICK);
-        // Disabled because it takes too long for a quick test:
-        // AddTestCase(new ArbiterEcmpTooBigFailTestCase, TestCase::QUICK);
+        AddTestCase(new ArbiterEcmpGlobalStateThreadsTestCase, TestCase::QUICK);
+        AddTestCase(new ArbiterEcmpFlowHashTagTestCase, TestCase::QUICK);
+        AddTestCase(new ArbiterEcmpRoutingCacheTestCase, TestCase::QUICK);
+        AddTestCase(new BufferedLogSinkTestCase, TestCase::QUICK);
+        AddTestCase(new QueueBandTracerTestCase, TestCase::QUICK);
+        AddTestCase(new SimulatorSchedulerLadderQueueTestCase, TestCase::QUICK);
+        AddTestCase(new SimulatorSchedulerEventTraceTestCase, TestCase::QUICK);
+        AddTestCase(new SimulatorSchedulerProgressTestCase, TestCase::QUICK);
+        AddTestCase(new PtopUtilizationTrackerBusyPeriodLogTestCase, TestCase::QUICK);
+        AddTestCase(new PtopUtilizationTrackerWriteThreadsTestCase, TestCase::QUICK);
     }
 };
 static BasicSimTestSuite basicSimTestSuite;
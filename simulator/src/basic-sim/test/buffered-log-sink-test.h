@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/buffered-log-sink.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class BufferedLogSinkTestCase : public TestCase {
+public:
+    BufferedLogSinkTestCase() : TestCase("buffered-log-sink basic") {};
+
+    void DoRun() {
+        for (bool keep_open : {true, false}) {
+
+            // Previous content is removed
+            std::ofstream the_file;
+            the_file.open ("temp.log");
+            the_file << "Previous" << std::endl;
+            the_file.close();
+
+            // Nothing is written to file until the buffer is full
+            Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>("temp.log", 16, keep_open);
+            ASSERT_EQUAL(read_file_direct("temp.log").size(), 0);
+            sink->WriteCsvLine(1, 2, 3);
+            sink->WriteCsvLine(4, 55, 666);
+            ASSERT_EQUAL(sink->GetNumBytesWritten(), 15);
+            sink->Flush();
+            std::vector<std::string> lines = read_file_direct("temp.log");
+            ASSERT_EQUAL(lines.size(), 2);
+            ASSERT_EQUAL(lines[0], "1,2,3");
+            ASSERT_EQUAL(lines[1], "4,55,666");
+
+            // Writes larger than the buffer go directly
+            sink->WriteCsvLine(7, 8, 9);
+            sink->Write("abcdefghijklmnopqrstuvwxyz\n", 27);
+            lines = read_file_direct("temp.log");
+            ASSERT_EQUAL(lines.size(), 4);
+            ASSERT_EQUAL(lines[2], "7,8,9");
+            ASSERT_EQUAL(lines[3], "abcdefghijklmnopqrstuvwxyz");
+
+            // Close flushes, and no more writes are permitted
+            sink->WriteCsvLine(-1, 0, 1);
+            sink->Close();
+            ASSERT_TRUE(sink->IsClosed());
+            ASSERT_EQUAL(sink->GetNumBytesWritten(), 15 + 6 + 27 + 7);
+            lines = read_file_direct("temp.log");
+            ASSERT_EQUAL(lines.size(), 5);
+            ASSERT_EQUAL(lines[4], "-1,0,1");
+            ASSERT_EXCEPTION(sink->WriteCsvLine(1, 2, 3));
+            remove_file_if_exists("temp.log");
+
+        }
+
+        // If the last flush fails, closing throws but the sink is closed,
+        // and disposing of it only reports it
+        for (bool explicit_close : {true, false}) {
+            mkdir_if_not_exists("temp-log-sink-dir");
+            Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>("temp-log-sink-dir/temp.log", 16, false);
+            sink->WriteCsvLine(1, 2, 3);
+            remove_file_if_exists("temp-log-sink-dir/temp.log");
+            remove_dir_if_exists("temp-log-sink-dir");
+            if (explicit_close) {
+                ASSERT_EXCEPTION(sink->Close());
+                ASSERT_TRUE(sink->IsClosed());
+                sink->Close();
+            }
+            sink->Dispose();
+            ASSERT_TRUE(sink->IsClosed());
+        }
+
+        // Invalid buffer size or file
+        ASSERT_EXCEPTION(CreateObject<BufferedLogSink>("temp.log", 0, true));
+        ASSERT_EXCEPTION(CreateObject<BufferedLogSink>("non-existing-dir/temp.log", 16, true));
+        remove_file_if_exists("temp.log");
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
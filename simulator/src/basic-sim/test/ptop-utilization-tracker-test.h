@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <random>
+#include "ns3/basic-simulation.h"
+#include "ns3/ptop-utilization-tracker.h"
+#include "ns3/ptop-utilization-tracker-helper.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class PtopUtilizationTrackerBusyPeriodLogTestCase : public TestCase {
+public:
+    PtopUtilizationTrackerBusyPeriodLogTestCase() : TestCase("ptop-utilization-tracker busy-period-log") {};
+
+    void DoRun() {
+
+        // Busy periods [50, 80), [90, 250) and [600, 620) until 700
+        BusyPeriodLog log;
+        log.Append(50, 80);
+        log.Append(90, 250);
+        log.Append(250, 250); // Empty ones are not logged
+        log.Append(600, 620);
+        ASSERT_EXCEPTION(log.ForEachInterval(100, [](int64_t, int64_t, int64_t, int64_t) {}));
+        ASSERT_EXCEPTION(log.Append(610, 700));
+        ASSERT_EXCEPTION(log.Append(700, 690));
+        log.Finish(700);
+        ASSERT_EXCEPTION(log.Append(700, 800));
+        ASSERT_EQUAL(log.GetNumBusyPeriods(), 3);
+        ASSERT_EQUAL(log.GetData().size(), 8); // (50, 30), (10, 160), (350, 20)
+        ASSERT_EQUAL(log.GetEndNs(), 700);
+        ASSERT_EXCEPTION(log.ForEachInterval(0, [](int64_t, int64_t, int64_t, int64_t) {}));
+
+        // Intervals of 100 ns, of which the idle ones are passed at once
+        std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> runs;
+        log.ForEachInterval(100, [&](int64_t start_ns, int64_t num_intervals, int64_t length_ns, int64_t busy_ns) {
+            runs.push_back(std::make_tuple(start_ns, num_intervals, length_ns, busy_ns));
+        });
+        ASSERT_EQUAL(runs.size(), 5);
+        ASSERT_TRUE(runs[0] == std::make_tuple((int64_t) 0, (int64_t) 1, (int64_t) 100, (int64_t) 40));
+        ASSERT_TRUE(runs[1] == std::make_tuple((int64_t) 100, (int64_t) 1, (int64_t) 100, (int64_t) 100));
+        ASSERT_TRUE(runs[2] == std::make_tuple((int64_t) 200, (int64_t) 1, (int64_t) 100, (int64_t) 50));
+        ASSERT_TRUE(runs[3] == std::make_tuple((int64_t) 300, (int64_t) 3, (int64_t) 100, (int64_t) 0));
+        ASSERT_TRUE(runs[4] == std::make_tuple((int64_t) 600, (int64_t) 1, (int64_t) 100, (int64_t) 20));
+
+        // Compressed
+        std::vector<std::tuple<int64_t, int64_t, int64_t>> compressed = log.GetCompressedUtilization(100);
+        ASSERT_EQUAL(compressed.size(), 5);
+        ASSERT_TRUE(compressed[3] == std::make_tuple((int64_t) 300, (int64_t) 600, (int64_t) 0));
+        ASSERT_TRUE(compressed[4] == std::make_tuple((int64_t) 600, (int64_t) 700, (int64_t) 20));
+
+        // Any other interval can be derived from the same log, including one longer than the tracking
+        compressed = log.GetCompressedUtilization(1000);
+        ASSERT_EQUAL(compressed.size(), 1);
+        ASSERT_TRUE(compressed[0] == std::make_tuple((int64_t) 0, (int64_t) 700, (int64_t) 210));
+        compressed = log.GetCompressedUtilization(1);
+        int64_t busy_sum_ns = 0;
+        for (std::tuple<int64_t, int64_t, int64_t>& interval : compressed) {
+            busy_sum_ns += std::get<2>(interval);
+        }
+        ASSERT_EQUAL(compressed.size(), 7);
+        ASSERT_EQUAL(busy_sum_ns, 210);
+
+        // The final interval can be incomplete
+        BusyPeriodLog log_restored(log.GetData(), log.GetNumBusyPeriods(), 650);
+        compressed = log_restored.GetCompressedUtilization(100);
+        ASSERT_EQUAL(compressed.size(), 5);
+        ASSERT_TRUE(compressed[4] == std::make_tuple((int64_t) 600, (int64_t) 650, (int64_t) 20));
+
+        // Invalid restores
+        ASSERT_EXCEPTION(BusyPeriodLog(log.GetData(), 2, 700));
+        ASSERT_EXCEPTION(BusyPeriodLog(log.GetData(), 4, 700));
+        ASSERT_EXCEPTION(BusyPeriodLog(log.GetData(), 3, 619));
+        ASSERT_EXCEPTION(BusyPeriodLog(std::vector<uint8_t>({0x80}), 1, 700));
+
+        // Nothing busy (the incomplete final interval has the same utilization)
+        BusyPeriodLog log_idle;
+        log_idle.Finish(250);
+        compressed = log_idle.GetCompressedUtilization(100);
+        ASSERT_EQUAL(compressed.size(), 1);
+        ASSERT_TRUE(compressed[0] == std::make_tuple((int64_t) 0, (int64_t) 250, (int64_t) 0));
+
+        // Busy period file and the utilization files written from it
+        mkdir_if_not_exists("temp-utilization");
+        std::vector<std::pair<int64_t, int64_t>> directed_edges = {std::make_pair(0, 1), std::make_pair(1, 0)};
+        std::vector<BusyPeriodLog> busy_period_logs = {log, log_idle};
+        PtopUtilizationTrackerHelper::WriteBusyPeriodLogs("temp-utilization/utilization_busy_periods.bin", directed_edges, busy_period_logs);
+        std::vector<std::pair<int64_t, int64_t>> directed_edges_read;
+        std::vector<BusyPeriodLog> busy_period_logs_read;
+        PtopUtilizationTrackerHelper::ReadBusyPeriodLogs("temp-utilization/utilization_busy_periods.bin", directed_edges_read, busy_period_logs_read);
+        ASSERT_TRUE(directed_edges_read == directed_edges);
+        ASSERT_EQUAL(busy_period_logs_read.size(), 2);
+        ASSERT_TRUE(busy_period_logs_read[0].GetData() == log.GetData());
+        ASSERT_EQUAL(busy_period_logs_read[1].GetEndNs(), 250);
+        ASSERT_EQUAL(PtopUtilizationTrackerHelper::WriteUtilizationFiles("temp-utilization", directed_edges_read, busy_period_logs_read, 100, true, 1), 6);
+        std::vector<std::string> lines = read_file_direct("temp-utilization/utilization.csv");
+        ASSERT_EQUAL(lines.size(), 7 + 3);
+        ASSERT_EQUAL(lines[0], "0,1,0,100,40");
+        ASSERT_EQUAL(lines[4], "0,1,400,500,0");
+        ASSERT_EQUAL(lines[9], "1,0,200,250,0");
+        lines = read_file_direct("temp-utilization/utilization_compressed.csv");
+        ASSERT_EQUAL(lines.size(), 6);
+        ASSERT_EQUAL(lines[3], "0,1,300,600,0");
+        lines = read_file_direct("temp-utilization/utilization_summary.txt");
+        ASSERT_EQUAL(lines.size(), 3);
+        ASSERT_EQUAL(lines[1], "0        1        30.00%");
+        ASSERT_EQUAL(lines[2], "1        0        0.00%");
+
+        // A truncated busy period file cannot be read
+        FILE* file = fopen("temp-utilization/utilization_busy_periods.bin", "r+");
+        ASSERT_EQUAL(ftruncate(fileno(file), 40), 0);
+        fclose(file);
+        ASSERT_EXCEPTION(PtopUtilizationTrackerHelper::ReadBusyPeriodLogs("temp-utilization/utilization_busy_periods.bin", directed_edges_read, busy_period_logs_read));
+
+        // Clean-up
+        remove_file_if_exists("temp-utilization/utilization_busy_periods.bin");
+        remove_file_if_exists("temp-utilization/utilization.csv");
+        remove_file_if_exists("temp-utilization/utilization_compressed.csv");
+        remove_file_if_exists("temp-utilization/utilization_compressed.txt");
+        remove_file_if_exists("temp-utilization/utilization_summary.txt");
+        remove_dir_if_exists("temp-utilization");
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class PtopUtilizationTrackerWriteThreadsTestCase : public TestCase {
+public:
+    PtopUtilizationTrackerWriteThreadsTestCase() : TestCase("ptop-utilization-tracker write-threads") {};
+
+    void DoRun() {
+
+        // Random busy periods on many directed edges (more than fit in one shard)
+        std::mt19937_64 rng(123456789);
+        std::vector<std::pair<int64_t, int64_t>> directed_edges;
+        std::vector<BusyPeriodLog> busy_period_logs;
+        for (int64_t i = 0; i < 100; i++) {
+            directed_edges.push_back(std::make_pair(i, (i + 1) % 100));
+            BusyPeriodLog log;
+            int64_t now_ns = 0;
+            int64_t num_busy_periods = rng() % 50;
+            for (int64_t j = 0; j < num_busy_periods; j++) {
+                int64_t start_ns = now_ns + rng() % 5000;
+                now_ns = start_ns + rng() % 3000;
+                log.Append(start_ns, now_ns);
+            }
+            log.Finish(now_ns + rng() % 1000);
+            busy_period_logs.push_back(log);
+        }
+
+        // The files must be exactly the same regardless of the number of threads
+        mkdir_if_not_exists("temp-utilization");
+        std::vector<std::string> filenames = {
+                "temp-utilization/utilization.csv",
+                "temp-utilization/utilization_compressed.csv",
+                "temp-utilization/utilization_compressed.txt",
+                "temp-utilization/utilization_summary.txt"
+        };
+        int64_t num_compressed_intervals = PtopUtilizationTrackerHelper::WriteUtilizationFiles("temp-utilization", directed_edges, busy_period_logs, 700, true, 1);
+        std::vector<std::vector<std::string>> expected;
+        for (const std::string& filename : filenames) {
+            expected.push_back(read_file_direct(filename));
+        }
+        ASSERT_EQUAL(expected[3].size(), 101);
+        for (int64_t num_threads : {2, 3, 8, 64}) {
+            ASSERT_EQUAL(PtopUtilizationTrackerHelper::WriteUtilizationFiles("temp-utilization", directed_edges, busy_period_logs, 700, true, num_threads), num_compressed_intervals);
+            for (size_t i = 0; i < filenames.size(); i++) {
+                ASSERT_TRUE(read_file_direct(filenames[i]) == expected[i]);
+            }
+        }
+        ASSERT_EXCEPTION(PtopUtilizationTrackerHelper::WriteUtilizationFiles("temp-utilization", directed_edges, busy_period_logs, 700, true, 0));
+
+        // A failure in any of the threads is passed on
+        ASSERT_EXCEPTION(PtopUtilizationTrackerHelper::WriteUtilizationFiles("temp-utilization", directed_edges, busy_period_logs, 0, true, 4));
+
+        // Clean-up
+        for (const std::string& filename : filenames) {
+            remove_file_if_exists(filename);
+        }
+        remove_dir_if_exists("temp-utilization");
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
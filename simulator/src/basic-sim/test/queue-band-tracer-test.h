@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/queue-band-tracer.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class QueueBandTracerTestCase : public TestCase {
+public:
+    QueueBandTracerTestCase() : TestCase("queue-band-tracer modes") {};
+
+    void RecordAndClose(QueueTraceMode mode, std::vector<std::string>& lines) {
+        Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>("temp.log", 1024, false);
+        Ptr<QueueBandTracer> tracer = CreateObject<QueueBandTracer>(sink, mode, 100);
+        tracer->RecordChange(10, 0, 1500);
+        tracer->RecordChange(20, 1500, 3000);
+        tracer->RecordChange(99, 3000, 1500);
+        tracer->RecordChange(350, 1500, 0);
+        tracer->RecordChange(370, 0, 1500);
+        sink->Close();
+        lines = read_file_direct("temp.log");
+        remove_file_if_exists("temp.log");
+    }
+
+    void DoRun() {
+        std::vector<std::string> lines;
+
+        // Every change
+        RecordAndClose(QUEUE_TRACE_CHANGE, lines);
+        ASSERT_EQUAL(lines.size(), 5);
+        ASSERT_EQUAL(lines[0], "TcBytesInQueue 0 to 1500 10");
+        ASSERT_EQUAL(lines[2], "TcBytesInQueue 3000 to 1500 99");
+        ASSERT_EQUAL(lines[4], "TcBytesInQueue 0 to 1500 370");
+
+        // Value at the end of each interval with a change (the last interval is written on close)
+        RecordAndClose(QUEUE_TRACE_INTERVAL, lines);
+        ASSERT_EQUAL(lines.size(), 2);
+        ASSERT_EQUAL(lines[0], "TcBytesInQueue 0 1500");
+        ASSERT_EQUAL(lines[1], "TcBytesInQueue 300 1500");
+
+        // Minimum and maximum of each interval with a change, including the value at its start
+        RecordAndClose(QUEUE_TRACE_MAX_MIN, lines);
+        ASSERT_EQUAL(lines.size(), 2);
+        ASSERT_EQUAL(lines[0], "TcBytesInQueue 0 0 3000");
+        ASSERT_EQUAL(lines[1], "TcBytesInQueue 300 0 1500");
+
+        // A tracer destroyed before its sink is closed writes its pending interval and detaches from the sink
+        Ptr<BufferedLogSink> detached_sink = CreateObject<BufferedLogSink>("temp.log", 1024, false);
+        Ptr<QueueBandTracer> detached_tracer = CreateObject<QueueBandTracer>(detached_sink, QUEUE_TRACE_INTERVAL, 100);
+        detached_tracer->RecordChange(10, 0, 1500);
+        detached_tracer = 0;
+        detached_sink->Close();
+        lines = read_file_direct("temp.log");
+        remove_file_if_exists("temp.log");
+        ASSERT_EQUAL(lines.size(), 1);
+        ASSERT_EQUAL(lines[0], "TcBytesInQueue 0 1500");
+
+        // Invalid mode or interval
+        ASSERT_EQUAL(parse_queue_trace_mode("max_min"), QUEUE_TRACE_MAX_MIN);
+        ASSERT_EXCEPTION(parse_queue_trace_mode("maximum"));
+        Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>("temp.log", 1024, false);
+        ASSERT_EXCEPTION(CreateObject<QueueBandTracer>(sink, QUEUE_TRACE_INTERVAL, 0));
+        sink->Close();
+        remove_file_if_exists("temp.log");
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <random>
+#include "ns3/basic-simulation.h"
+#include "ns3/ladder-queue-scheduler.h"
+#include "ns3/event-trace-scheduler.h"
+#include "ns3/progress-tracking-scheduler.h"
+#include "ns3/test.h"
+#include "test-helpers.h"
+
+using namespace ns3;
+
+const std::string simulator_scheduler_test_dir = ".tmp-simulator-scheduler-test";
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class SimulatorSchedulerTestEventImpl : public EventImpl
+{
+protected:
+    virtual void Notify (void) {
+    }
+};
+
+/**
+ * Perform random operations on a scheduler (mostly near-future events, some ties and far-future events),
+ * and return the sequence of unique identifiers which were removed next.
+ */
+std::vector<uint32_t> perform_random_scheduler_operations(Ptr<Scheduler> scheduler, EventImpl* impl, int64_t num_operations) {
+    std::mt19937_64 rng(123456789);
+    std::vector<Scheduler::Event> pending;
+    std::vector<uint32_t> removed_next;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+    for (int64_t i = 0; i < num_operations; i++) {
+        int64_t r = rng() % 100;
+        if (r < 52 || pending.empty()) {
+            uint64_t delta;
+            int64_t kind = rng() % 10;
+            if (kind < 6) {
+                delta = rng() % 1000;
+            } else if (kind < 8) {
+                delta = 0;
+            } else {
+                delta = rng() % 10000000;
+            }
+            Scheduler::Event ev;
+            ev.impl = impl;
+            ev.key.m_ts = now + delta;
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            scheduler->Insert(ev);
+            pending.push_back(ev);
+        } else if (r < 97) {
+            Scheduler::Event ev = scheduler->RemoveNext();
+            now = ev.key.m_ts;
+            removed_next.push_back(ev.key.m_uid);
+            for (size_t j = 0; j < pending.size(); j++) {
+                if (pending[j].key.m_uid == ev.key.m_uid) {
+                    pending[j] = pending.back();
+                    pending.pop_back();
+                    break;
+                }
+            }
+        } else {
+            size_t j = rng() % pending.size();
+            scheduler->Remove(pending[j]);
+            pending[j] = pending.back();
+            pending.pop_back();
+        }
+    }
+    while (!scheduler->IsEmpty()) {
+        removed_next.push_back(scheduler->RemoveNext().key.m_uid);
+    }
+    return removed_next;
+}
+
+class SimulatorSchedulerLadderQueueTestCase : public TestCase {
+public:
+    SimulatorSchedulerLadderQueueTestCase() : TestCase("simulator-scheduler ladder-queue") {};
+
+    void DoRun() {
+        Ptr<SimulatorSchedulerTestEventImpl> impl = Create<SimulatorSchedulerTestEventImpl>();
+
+        // Scheduler names
+        ASSERT_EQUAL(parse_simulator_scheduler("map"), "ns3::MapScheduler");
+        ASSERT_EQUAL(parse_simulator_scheduler("heap"), "ns3::HeapScheduler");
+        ASSERT_EQUAL(parse_simulator_scheduler("calendar"), "ns3::CalendarScheduler");
+        ASSERT_EQUAL(parse_simulator_scheduler("ladder"), "ns3::LadderQueueScheduler");
+        ASSERT_EXCEPTION(parse_simulator_scheduler("splay"));
+
+        // Few events, which all go via the bottom
+        Ptr<LadderQueueScheduler> ladder = CreateObject<LadderQueueScheduler>();
+        ASSERT_TRUE(ladder->IsEmpty());
+        ASSERT_EXCEPTION(ladder->RemoveNext());
+        Scheduler::Event ev;
+        ev.impl = PeekPointer(impl);
+        ev.key.m_context = 0;
+        std::vector<std::pair<uint64_t, uint32_t>> events = {{100, 0}, {50, 1}, {100, 2}, {75, 3}, {50, 4}};
+        for (std::pair<uint64_t, uint32_t> e : events) {
+            ev.key.m_ts = e.first;
+            ev.key.m_uid = e.second;
+            ladder->Insert(ev);
+        }
+        ev.key.m_ts = 75;
+        ev.key.m_uid = 3;
+        ladder->Remove(ev);
+        ASSERT_EXCEPTION(ladder->Remove(ev));
+        for (uint32_t uid : {1, 4, 0, 2}) {
+            ASSERT_FALSE(ladder->IsEmpty());
+            ASSERT_EQUAL(ladder->PeekNext().key.m_uid, uid);
+            ASSERT_EQUAL(ladder->RemoveNext().key.m_uid, uid);
+        }
+        ASSERT_TRUE(ladder->IsEmpty());
+        ASSERT_EQUAL(ladder->GetNumRungsSpawned(), 0);
+
+        // Many events: exactly the same order as the map scheduler
+        ladder = CreateObject<LadderQueueScheduler>();
+        std::vector<uint32_t> order_ladder = perform_random_scheduler_operations(ladder, PeekPointer(impl), 100000);
+        std::vector<uint32_t> order_map = perform_random_scheduler_operations(CreateObject<MapScheduler>(), PeekPointer(impl), 100000);
+        ASSERT_EQUAL(order_ladder.size(), order_map.size());
+        ASSERT_TRUE(order_ladder == order_map);
+        ASSERT_TRUE(ladder->GetNumRungsSpawned() > 0);
+        ASSERT_TRUE(ladder->GetMaxNumRungs() >= 1);
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class SimulatorSchedulerEventTraceTestCase : public TestCase {
+public:
+    SimulatorSchedulerEventTraceTestCase() : TestCase("simulator-scheduler event-trace") {};
+
+    void DoRun() {
+        Ptr<SimulatorSchedulerTestEventImpl> impl = Create<SimulatorSchedulerTestEventImpl>();
+
+        // Trace the operations on a map scheduler
+        mkdir_if_not_exists(simulator_scheduler_test_dir);
+        std::string trace_filename = simulator_scheduler_test_dir + "/temp.trace";
+        Ptr<BufferedLogSink> sink = CreateObject<BufferedLogSink>(trace_filename, 1024, true);
+        Ptr<EventTraceScheduler> tracer = CreateObject<EventTraceScheduler>();
+        tracer->SetAttribute("Scheduler", PointerValue(CreateObject<MapScheduler>()));
+        tracer->SetAttribute("TraceLogSink", PointerValue(sink));
+        std::vector<uint32_t> order_traced = perform_random_scheduler_operations(tracer, PeekPointer(impl), 10000);
+        sink->Close();
+
+        // Every operation is in the trace
+        std::vector<event_trace_record_t> trace = read_event_trace(trace_filename);
+        int64_t num_inserts = 0;
+        int64_t num_remove_next = 0;
+        int64_t checksum = 0;
+        for (event_trace_record_t& record : trace) {
+            if (record.operation == EVENT_TRACE_INSERT) {
+                num_inserts++;
+            } else if (record.operation == EVENT_TRACE_REMOVE_NEXT) {
+                num_remove_next++;
+                checksum += record.uid;
+            }
+        }
+        ASSERT_EQUAL(num_remove_next, (int64_t) order_traced.size());
+        ASSERT_TRUE(num_inserts > num_remove_next);
+        ASSERT_EQUAL((int64_t) (trace.size() * sizeof(event_trace_record_t)), sink->GetNumBytesWritten());
+
+        // Each scheduler replays it identically
+        for (std::string name : {"map", "heap", "calendar", "ladder"}) {
+            ObjectFactory factory;
+            factory.SetTypeId(parse_simulator_scheduler(name));
+            ASSERT_EQUAL(replay_event_trace(trace, factory.Create<Scheduler>()), checksum);
+        }
+
+        // A scheduler which orders differently diverges
+        std::vector<event_trace_record_t> swapped = {{10, 0, EVENT_TRACE_INSERT}, {20, 1, EVENT_TRACE_INSERT}, {20, 1, EVENT_TRACE_REMOVE_NEXT}};
+        ASSERT_EXCEPTION(replay_event_trace(swapped, CreateObject<LadderQueueScheduler>()));
+
+        // Invalid trace files
+        std::ofstream file(trace_filename);
+        file << "abc";
+        file.close();
+        ASSERT_EXCEPTION(read_event_trace(trace_filename));
+        remove_file_if_exists(trace_filename);
+        ASSERT_EXCEPTION(read_event_trace(trace_filename));
+        remove_dir_if_exists(simulator_scheduler_test_dir);
+
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+
+class SimulatorSchedulerProgressTestCase : public TestCase {
+public:
+    SimulatorSchedulerProgressTestCase() : TestCase("simulator-scheduler progress") {};
+
+    void DoRun() {
+        Ptr<SimulatorSchedulerTestEventImpl> impl = Create<SimulatorSchedulerTestEventImpl>();
+
+        // Only the events removed next count as executed
+        Ptr<SimulationProgress> progress = CreateObject<SimulationProgress>();
+        Ptr<ProgressTrackingScheduler> tracker = CreateObject<ProgressTrackingScheduler>();
+        tracker->SetAttribute("Scheduler", PointerValue(CreateObject<LadderQueueScheduler>()));
+        tracker->SetAttribute("Progress", PointerValue(progress));
+        ASSERT_EQUAL(progress->GetNumEvents(), 0);
+        ASSERT_EQUAL(progress->GetTs(), 0);
+        Scheduler::Event ev;
+        ev.impl = PeekPointer(impl);
+        ev.key.m_context = 0;
+        for (uint32_t uid = 0; uid < 10; uid++) {
+            ev.key.m_ts = 1000 - uid * 10;
+            ev.key.m_uid = uid;
+            tracker->Insert(ev);
+        }
+        tracker->Remove(ev);
+        ASSERT_EQUAL(progress->GetNumEvents(), 0);
+        ASSERT_EQUAL(tracker->PeekNext().key.m_ts, 920);
+        ASSERT_EQUAL(progress->GetNumEvents(), 0);
+        ASSERT_EQUAL(tracker->RemoveNext().key.m_uid, 8);
+        ASSERT_EQUAL(progress->GetNumEvents(), 1);
+        ASSERT_EQUAL(progress->GetTs(), 920);
+        while (!tracker->IsEmpty()) {
+            tracker->RemoveNext();
+        }
+        ASSERT_EQUAL(progress->GetNumEvents(), 9);
+        ASSERT_EQUAL(progress->GetTs(), 1000);
+
+        // The scheduler of the simulator keeps track of the progress of the simulation
+        Ptr<SimulationProgress> sim_progress = CreateObject<SimulationProgress>();
+        ObjectFactory factory;
+        factory.SetTypeId("ns3::ProgressTrackingScheduler");
+        factory.Set("Scheduler", PointerValue(CreateObject<MapScheduler>()));
+        factory.Set("Progress", PointerValue(sim_progress));
+        Simulator::SetScheduler(factory);
+        for (int64_t t : {10, 20, 30}) {
+            Simulator::Schedule(NanoSeconds(t), &SimulatorSchedulerProgressTestCase::RecordNumEvents, this, sim_progress);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+        ASSERT_EQUAL(m_num_events_seen.size(), 3);
+        ASSERT_EQUAL(m_num_events_seen[0], 1);
+        ASSERT_EQUAL(m_num_events_seen[1], 2);
+        ASSERT_EQUAL(m_num_events_seen[2], 3);
+        ASSERT_EQUAL(sim_progress->GetTs(), (uint64_t) NanoSeconds(30).GetTimeStep());
+
+    }
+
+private:
+    void RecordNumEvents(Ptr<SimulationProgress> progress) {
+        m_num_events_seen.push_back(progress->GetNumEvents());
+    }
+    std::vector<int64_t> m_num_events_seen;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@ void cleanup_topology_ptop_test() {
     remove_file_if_exists(topology_ptop_test_dir + "/topology.properties.temp");
     remove_file_if_exists(topology_ptop_test_dir + "/logs_ns3/finished.txt");
     remove_file_if_exists(topology_ptop_test_dir + "/logs_ns3/timing_results.txt");
+    remove_file_if_exists(topology_ptop_test_dir + "/logs_ns3/route_cache.csv");
     remove_dir_if_exists(topology_ptop_test_dir + "/logs_ns3");
     remove_dir_if_exists(topology_ptop_test_dir);
 }
@@ -520,4 +521,52 @@ public:
     }
 };
 
+class TopologyGraphTestCase : public TestCase
+{
+public:
+    TopologyGraphTestCase () : TestCase ("topology graph") {};
+    void DoRun () {
+        mkdir_if_not_exists(topology_ptop_test_dir);
+        std::ofstream topology_file;
+
+        // Read and checked without a simulation or any nodes
+        topology_file.open (topology_ptop_test_dir + "/topology.properties.temp");
+        topology_file << "num_nodes=4" << std::endl;
+        topology_file << "num_undirected_edges=3" << std::endl;
+        topology_file << "switches=set(1,2)" << std::endl;
+        topology_file << "switches_which_are_tors=set(1,2)" << std::endl;
+        topology_file << "servers=set(0,3)" << std::endl;
+        topology_file << "undirected_edges=set(2-3,1-0,1-2)" << std::endl;
+        topology_file.close();
+        topology_ptop_graph_t graph = TopologyPtop::ReadTopologyGraph(topology_ptop_test_dir + "/topology.properties.temp");
+        ASSERT_EQUAL(graph.num_nodes, 4);
+        ASSERT_EQUAL(graph.num_undirected_edges, 3);
+        ASSERT_EQUAL(graph.servers.size(), 2);
+        ASSERT_EQUAL(graph.undirected_edges.size(), 3);
+        ASSERT_EQUAL(graph.undirected_edges[0].first, 0);
+        ASSERT_EQUAL(graph.undirected_edges[0].second, 1);
+        ASSERT_EQUAL(graph.undirected_edges[2].first, 2);
+        ASSERT_EQUAL(graph.undirected_edges[2].second, 3);
+        ASSERT_EQUAL(graph.adjacency_list.size(), 4);
+        ASSERT_EQUAL(graph.adjacency_list[1].size(), 2);
+        ASSERT_TRUE(graph.adjacency_list[1].find(0) != graph.adjacency_list[1].end());
+        ASSERT_TRUE(graph.adjacency_list[1].find(2) != graph.adjacency_list[1].end());
+        ASSERT_EQUAL(graph.adjacency_list[3].size(), 1);
+
+        // With the same checks as the topology itself (here: a server connected to a non-ToR)
+        topology_file.open (topology_ptop_test_dir + "/topology.properties.temp");
+        topology_file << "num_nodes=3" << std::endl;
+        topology_file << "num_undirected_edges=2" << std::endl;
+        topology_file << "switches=set(1,2)" << std::endl;
+        topology_file << "switches_which_are_tors=set(2)" << std::endl;
+        topology_file << "servers=set(0)" << std::endl;
+        topology_file << "undirected_edges=set(0-1,1-2)" << std::endl;
+        topology_file.close();
+        ASSERT_EXCEPTION(TopologyPtop::ReadTopologyGraph(topology_ptop_test_dir + "/topology.properties.temp"));
+
+        remove_file_if_exists(topology_ptop_test_dir + "/topology.properties.temp");
+        remove_dir_if_exists(topology_ptop_test_dir);
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////